@@ -0,0 +1,490 @@
+/**
+*   @file:    gain_sweep.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Monte Karlo pretraga pojacanja regulatora, tabela profila i
+*             parametara robota na host build-u ploce kretanja. Svaki uzorak
+*             je jedan mec iz skripte (-c) u motion_host -p -m, kao poseban
+*             proces jer firmware drzi stanje u globalnim promenljivama.
+*
+*             Argumenti "ime=od:do" se biraju uniformno, "ime=vrednost" je
+*             fiksno. Kp, Ki, Kd, Kpc, Kic, Kdc, acc, dec i vmax idu u -g,
+*             ostala imena u -P (parametri robot_plant.c: mass, friction,
+*             vbat, ...). Uzorci se izvlace unapred iz -s, pa rezultat ne
+*             zavisi od broja niti ni od redosleda izvrsavanja.
+*
+*             Niti (-j, podrazumevano broj jezgara) dobijaju uzastopne
+*             opsege uzoraka; nit koja zavrsi svoje uzima polovinu najveceg
+*             preostalog opsega druge niti, pa spori mecevi (npr. robot koji
+*             se ne smiri) ne ostavljaju jezgra bez posla.
+*
+*             Ispisuje Pareto front za najduze vreme smirivanja, najveci
+*             preskok i RMS gresku pracenja (uzorci u kojima se svaki pokret
+*             smirio) i frontove za svaki par. -o upisuje sve uzorke po
+*             kolonama: tekst zaglavlje ("GSWEEP 1", "rows N", "cols K",
+*             imena kolona, "data"), pa K nizova od N float32 (little endian).
+*
+*             gcc -std=c99 -O2 -pthread -o gain_sweep gain_sweep.c
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_PARAMS    32
+#define MAX_WORKERS   256
+#define MAX_ARGS      (16 + 2 * MAX_PARAMS)
+
+/* Kolone iz reda "metrics ..." koji ispisuje motion_host -m. */
+static const char *metric_names[] = {
+  "moves", "unsettled", "settle_ms", "settle_max_ms", "overshoot_mm", "track_rms_mm", "track_max_mm", "final_mm"
+};
+#define METRIC_NUM    (int)(sizeof(metric_names) / sizeof(metric_names[0]))
+#define M_UNSETTLED   1
+#define M_SETTLE_MAX  3
+#define M_OVERSHOOT   4
+#define M_TRACK_RMS   5
+
+/* Ciljevi Pareto fronta (manje je bolje). */
+static const int objectives[3] = { M_SETTLE_MAX, M_OVERSHOOT, M_TRACK_RMS };
+
+static const char *gain_names[] = { "Kp", "Ki", "Kd", "Kpc", "Kic", "Kdc", "acc", "dec", "vmax" };
+
+typedef struct {
+  char name[32];
+  double lo, hi;
+  int gain;                         // -g umesto -P.
+} Param;
+
+typedef struct {
+  double value[MAX_PARAMS];
+  double metric[METRIC_NUM];
+  int status;                       // 0 ok, 1 motion_host nije uspeo, 2 nema reda metrics.
+  double wall;
+  int pareto;
+} Job;
+
+/* Opseg uzoraka jedne niti [head, tail). */
+typedef struct {
+  pthread_mutex_t lock;
+  int head, tail;
+} Range;
+
+static Param params[MAX_PARAMS];
+static int param_num;
+static Job *jobs;
+static int job_num = 64;
+static Range ranges[MAX_WORKERS];
+static int workers;
+
+static const char *motion_host;
+static const char *script;
+static double seconds = 90.0;
+
+static pthread_mutex_t progress_lock = PTHREAD_MUTEX_INITIALIZER;
+static int done, failed;
+
+/*----------------------------------------------------------------------------*/
+static uint64_t rng_state;
+
+/* xorshift64*: isti niz na svakoj platformi za isti -s. */
+static double Uniform(void)
+{
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return (double)((rng_state * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+
+static double Wall(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*----------------------------------------------------------------------------*/
+static int ParseParam(const char *arg)
+{
+  const char *eq = strchr(arg, '=');
+  Param *p = &params[param_num];
+  char *end;
+  unsigned int i;
+
+  if (eq == NULL || eq == arg || (size_t)(eq - arg) >= sizeof(p->name) || param_num == MAX_PARAMS) return -1;
+  memcpy(p->name, arg, (size_t)(eq - arg));
+  p->name[eq - arg] = 0;
+  p->lo = strtod(eq + 1, &end);
+  if (end == eq + 1) return -1;
+  if (*end == ':') {
+    const char *hi = end + 1;
+
+    p->hi = strtod(hi, &end);
+    if (end == hi) return -1;
+  }
+  else p->hi = p->lo;
+  if (*end != 0) return -1;
+  p->gain = 0;
+  for (i = 0; i < sizeof(gain_names) / sizeof(gain_names[0]); i++)
+    if (strcmp(p->name, gain_names[i]) == 0) p->gain = 1;
+  param_num++;
+  return 0;
+}
+
+static void ParseMetrics(const char *out, Job *job)
+{
+  const char *line = strstr(out, "metrics ");
+  int k;
+
+  while (line && line != out && line[-1] != '\n') line = strstr(line + 1, "metrics ");
+  if (line == NULL) {
+    job->status = 2;
+    return;
+  }
+  for (k = 0; k < METRIC_NUM; k++) {
+    char key[40];
+    const char *p;
+
+    snprintf(key, sizeof(key), " %s=", metric_names[k]);
+    p = strstr(line, key);
+    job->metric[k] = p ? atof(p + strlen(key)) : NAN;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/* Jedan mec: fork/exec motion_host i citanje izlaza preko pipe-a. */
+static void RunJob(int index)
+{
+  Job *job = &jobs[index];
+  char values[MAX_PARAMS][64], seconds_arg[32];
+  char *argv[MAX_ARGS];
+  char *out = NULL;
+  size_t len = 0, cap = 0;
+  int fd[2], argc = 0, k, status;
+  pid_t pid;
+
+  job->wall = Wall();
+  snprintf(seconds_arg, sizeof(seconds_arg), "%g", seconds);
+  argv[argc++] = (char *)motion_host;
+  argv[argc++] = "-t";
+  argv[argc++] = seconds_arg;
+  argv[argc++] = "-c";
+  argv[argc++] = (char *)script;
+  argv[argc++] = "-p";
+  argv[argc++] = "-m";
+  for (k = 0; k < param_num; k++) {
+    snprintf(values[k], sizeof(values[k]), "%.31s=%.9g", params[k].name, job->value[k]);
+    argv[argc++] = params[k].gain ? "-g" : "-P";
+    argv[argc++] = values[k];
+  }
+  argv[argc] = NULL;
+
+  if (pipe(fd) < 0) {
+    job->status = 1;
+    return;
+  }
+  pid = fork();
+  if (pid == 0) {
+    dup2(fd[1], STDOUT_FILENO);
+    close(fd[0]);
+    close(fd[1]);
+    execv(motion_host, argv);
+    fprintf(stderr, "gain_sweep: %s: %s\n", motion_host, strerror(errno));
+    _exit(127);
+  }
+  close(fd[1]);
+  if (pid < 0) {
+    close(fd[0]);
+    job->status = 1;
+    return;
+  }
+  for (;;) {
+    ssize_t n;
+
+    if (len + 4096 > cap) {
+      char *q = realloc(out, cap = cap ? 2 * cap : 16384);
+      if (q == NULL) break;
+      out = q;
+    }
+    n = read(fd[0], out + len, cap - len - 1);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    len += (size_t)n;
+  }
+  close(fd[0]);
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+  }
+  job->wall = Wall() - job->wall;
+  if (out == NULL || !WIFEXITED(status) || WEXITSTATUS(status) != 0) job->status = 1;
+  else {
+    out[len] = 0;
+    ParseMetrics(out, job);
+  }
+  free(out);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Sledeci uzorak iz sopstvenog opsega ili -1. */
+static int TakeOwn(Range *r)
+{
+  int index = -1;
+
+  pthread_mutex_lock(&r->lock);
+  if (r->head < r->tail) index = r->head++;
+  pthread_mutex_unlock(&r->lock);
+  return index;
+}
+
+/* Polovina najveceg preostalog opsega druge niti postaje sopstveni opseg. */
+static int Steal(int self)
+{
+  int w, victim = -1, best = 0;
+
+  for (w = 0; w < workers; w++) {
+    int left;
+
+    if (w == self) continue;
+    pthread_mutex_lock(&ranges[w].lock);
+    left = ranges[w].tail - ranges[w].head;
+    pthread_mutex_unlock(&ranges[w].lock);
+    if (left > best) {
+      best = left;
+      victim = w;
+    }
+  }
+  if (victim < 0) return 0;
+  pthread_mutex_lock(&ranges[victim].lock);
+  best = ranges[victim].tail - ranges[victim].head;
+  if (best > 0) {
+    int take = (best + 1) / 2;
+
+    /* Zadnja polovina: vlasnik nastavlja redom sa pocetka. */
+    pthread_mutex_lock(&ranges[self].lock);
+    ranges[self].head = ranges[victim].tail - take;
+    ranges[self].tail = ranges[victim].tail;
+    pthread_mutex_unlock(&ranges[self].lock);
+    ranges[victim].tail -= take;
+  }
+  pthread_mutex_unlock(&ranges[victim].lock);
+  return 1;
+}
+
+static void *Worker(void *arg)
+{
+  int self = (int)(intptr_t)arg;
+
+  for (;;) {
+    int index = TakeOwn(&ranges[self]);
+
+    if (index < 0) {
+      if (!Steal(self)) break;
+      continue;
+    }
+    RunJob(index);
+    pthread_mutex_lock(&progress_lock);
+    done++;
+    if (jobs[index].status) failed++;
+    if (done % 16 == 0 || done == job_num) fprintf(stderr, "\r%d / %d (neuspelih %d)", done, job_num, failed);
+    pthread_mutex_unlock(&progress_lock);
+  }
+  return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Uzorak u kome se svaki pokret smirio ucestvuje u frontu. */
+static int Valid(const Job *j)
+{
+  return j->status == 0 && j->metric[M_UNSETTLED] == 0 && !isnan(j->metric[M_SETTLE_MAX]);
+}
+
+static int Dominates(const Job *a, const Job *b, const int *obj, int n)
+{
+  int k, better = 0;
+
+  for (k = 0; k < n; k++) {
+    if (a->metric[obj[k]] > b->metric[obj[k]]) return 0;
+    if (a->metric[obj[k]] < b->metric[obj[k]]) better = 1;
+  }
+  return better;
+}
+
+/* Pareto front po ciljevima obj, indeksi sortirani po prvom cilju. */
+static int Front(const int *obj, int n, int *front)
+{
+  int i, j, num = 0;
+
+  for (i = 0; i < job_num; i++) {
+    if (!Valid(&jobs[i])) continue;
+    for (j = 0; j < job_num; j++)
+      if (j != i && Valid(&jobs[j]) && Dominates(&jobs[j], &jobs[i], obj, n)) break;
+    if (j == job_num) front[num++] = i;
+  }
+  for (i = 1; i < num; i++) {
+    int x = front[i];
+
+    for (j = i; j > 0 && jobs[front[j - 1]].metric[obj[0]] > jobs[x].metric[obj[0]]; j--) front[j] = front[j - 1];
+    front[j] = x;
+  }
+  return num;
+}
+
+static void PrintFront(void)
+{
+  static const int pairs[3][2] = {
+    { M_SETTLE_MAX, M_OVERSHOOT }, { M_SETTLE_MAX, M_TRACK_RMS }, { M_OVERSHOOT, M_TRACK_RMS }
+  };
+  int *front = malloc(job_num * sizeof(int));
+  int num, i, k, valid = 0;
+
+  if (front == NULL) return;
+  for (i = 0; i < job_num; i++) valid += Valid(&jobs[i]);
+  num = Front(objectives, 3, front);
+  printf("\nPareto front (%d od %d uzoraka bez nesmirenih pokreta):\n%6s %10s %9s %9s", num, valid, "uzorak",
+         "settle_ms", "preskok", "rms_mm");
+  for (k = 0; k < param_num; k++) printf(" %9s", params[k].name);
+  printf("\n");
+  for (i = 0; i < num; i++) {
+    const Job *j = &jobs[front[i]];
+
+    jobs[front[i]].pareto = 1;
+    printf("%6d %10.1f %9.2f %9.2f", front[i], j->metric[M_SETTLE_MAX], j->metric[M_OVERSHOOT],
+           j->metric[M_TRACK_RMS]);
+    for (k = 0; k < param_num; k++) printf(" %9.4g", j->value[k]);
+    printf("\n");
+  }
+  for (k = 0; k < 3; k++) {
+    num = Front(pairs[k], 2, front);
+    printf("\n%s / %s:", metric_names[pairs[k][0]], metric_names[pairs[k][1]]);
+    for (i = 0; i < num; i++)
+      printf(" %d (%.1f, %.2f)", front[i], jobs[front[i]].metric[pairs[k][0]], jobs[front[i]].metric[pairs[k][1]]);
+    printf("\n");
+  }
+  free(front);
+}
+
+/*----------------------------------------------------------------------------*/
+static int WriteColumns(const char *path)
+{
+  FILE *f = fopen(path, "wb");
+  float *col;
+  int i, k, cols = 4 + param_num + METRIC_NUM;
+
+  if (f == NULL) return -1;
+  col = malloc(job_num * sizeof(float));
+  if (col == NULL) {
+    fclose(f);
+    return -1;
+  }
+  fprintf(f, "GSWEEP 1\nrows %d\ncols %d\nsample status", job_num, cols);
+  for (k = 0; k < param_num; k++) fprintf(f, " %s", params[k].name);
+  for (k = 0; k < METRIC_NUM; k++) fprintf(f, " %s", metric_names[k]);
+  fprintf(f, " pareto wall_s\ndata\n");
+  for (k = 0; k < cols; k++) {
+    for (i = 0; i < job_num; i++) {
+      const Job *j = &jobs[i];
+
+      if (k == 0) col[i] = (float)i;
+      else if (k == 1) col[i] = (float)j->status;
+      else if (k < 2 + param_num) col[i] = (float)j->value[k - 2];
+      else if (k < 2 + param_num + METRIC_NUM) col[i] = (float)(j->status ? NAN : j->metric[k - 2 - param_num]);
+      else if (k == cols - 2) col[i] = (float)j->pareto;
+      else col[i] = (float)j->wall;
+    }
+    fwrite(col, sizeof(float), job_num, f);
+  }
+  free(col);
+  return fclose(f);
+}
+
+/*----------------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  const char *output = NULL;
+  char *default_host = NULL;
+  pthread_t threads[MAX_WORKERS];
+  double wall, busy = 0;
+  unsigned long long seed = 1;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt, i, k;
+
+  workers = cpus > 0 ? (int)cpus : 1;
+  while ((opt = getopt(argc, argv, "c:x:j:n:s:t:o:")) != -1) {
+    switch (opt) {
+      case 'c': script = optarg; break;
+      case 'x': motion_host = optarg; break;
+      case 'j': workers = atoi(optarg); break;
+      case 'n': job_num = atoi(optarg); break;
+      case 's': seed = strtoull(optarg, NULL, 0); break;
+      case 't': seconds = atof(optarg); break;
+      case 'o': output = optarg; break;
+      default:
+        goto usage;
+    }
+  }
+  for (i = optind; i < argc; i++) {
+    if (ParseParam(argv[i]) < 0) {
+      fprintf(stderr, "gain_sweep: los parametar %s (ime=od:do ili ime=vrednost)\n", argv[i]);
+      return 1;
+    }
+  }
+  if (script == NULL || job_num <= 0 || workers <= 0) goto usage;
+  if (workers > MAX_WORKERS) workers = MAX_WORKERS;
+  if (workers > job_num) workers = job_num;
+  if (motion_host == NULL) {
+    /* Podrazumevano motion_host iz istog direktorijuma. */
+    const char *slash = strrchr(argv[0], '/');
+    size_t dir = slash ? (size_t)(slash - argv[0] + 1) : 0;
+
+    default_host = malloc(dir + sizeof("motion_host"));
+    if (default_host == NULL) return 1;
+    memcpy(default_host, argv[0], dir);
+    strcpy(default_host + dir, "motion_host");
+    motion_host = default_host;
+  }
+
+  jobs = calloc(job_num, sizeof(Job));
+  if (jobs == NULL) return 1;
+  rng_state = seed ? seed : 1;
+  for (i = 0; i < job_num; i++)
+    for (k = 0; k < param_num; k++)
+      jobs[i].value[k] = params[k].lo + (params[k].hi - params[k].lo) * Uniform();
+  for (i = 0; i < workers; i++) {
+    pthread_mutex_init(&ranges[i].lock, NULL);
+    ranges[i].head = (int)((long long)job_num * i / workers);
+    ranges[i].tail = (int)((long long)job_num * (i + 1) / workers);
+  }
+
+  wall = Wall();
+  for (i = 0; i < workers; i++) pthread_create(&threads[i], NULL, Worker, (void *)(intptr_t)i);
+  for (i = 0; i < workers; i++) pthread_join(threads[i], NULL);
+  wall = Wall() - wall;
+  for (i = 0; i < job_num; i++) busy += jobs[i].wall;
+
+  fprintf(stderr, "\n");
+  printf("%d uzoraka po %.0f s virtuelno, %d niti, %.2f s (%.1f meceva u sekundi, zauzetost %.0f%%), neuspelih %d\n",
+         job_num, seconds, workers, wall, job_num / wall, 100.0 * busy / (wall * workers), failed);
+  PrintFront();
+  if (output && WriteColumns(output) != 0) {
+    perror(output);
+    return 1;
+  }
+  free(jobs);
+  free(default_host);
+  return 0;
+
+usage:
+  fprintf(stderr, "usage: %s -c skripta [-x motion_host] [-j niti] [-n uzoraka] [-s seme] [-t sekundi] "
+          "[-o rezultati.gsw] ime=od:do ...\n", argv[0]);
+  return 1;
+}
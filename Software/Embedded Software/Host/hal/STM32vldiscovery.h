@@ -0,0 +1,34 @@
+/**
+*   @file:    STM32vldiscovery.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Zamena za Libraries/DISCOVERY/STM32vldiscovery.h u host build-u.
+*             Pravo zaglavlje ukljucuje "STM32f10x.h" (radi samo na Windows-u
+*             gde ime fajla nije osetljivo na velika slova), a ploca kretanja
+*             iz njega koristi samo tipove LED-a i tastera.
+*/
+
+#ifndef __STM32F100_Dicovery_H
+#define __STM32F100_Dicovery_H
+
+#include "stm32f10x.h"
+
+typedef enum
+{
+  LED3 = 0,
+  LED4 = 1
+} Led_TypeDef;
+
+typedef enum
+{
+  BUTTON_USER = 0
+} Button_TypeDef;
+
+typedef enum
+{
+  BUTTON_MODE_GPIO = 0,
+  BUTTON_MODE_EXTI = 1
+} ButtonMode_TypeDef;
+
+#endif
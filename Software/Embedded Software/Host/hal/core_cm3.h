@@ -0,0 +1,148 @@
+/**
+*   @file:    core_cm3.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Zamena za CMSIS core_cm3.h (v1.30) u host build-u ploce
+*             kretanja. Strukture NVIC, SCB, SysTick i CoreDebug su iste kao
+*             u CMSIS-u, ali pokazuju na promenljive u hal_core.c, a
+*             intrinsic funkcije (__disable_irq, __LDREXW, ...) i NVIC/SysTick
+*             funkcije su obicne funkcije iz hal_core.c. Pravi stm32f10x.h
+*             ukljucuje ovaj fajl jer je hal/ prvi u putanji za include.
+*/
+
+#ifndef __CM3_CORE_H__
+#define __CM3_CORE_H__
+
+#include <stdint.h>
+
+#define __CM3_CMSIS_VERSION_MAIN  (0x01)
+#define __CM3_CMSIS_VERSION_SUB   (0x30)
+#define __CM3_CMSIS_VERSION       ((__CM3_CMSIS_VERSION_MAIN << 16) | __CM3_CMSIS_VERSION_SUB)
+#define __CORTEX_M                (0x03)
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+#define __ASM     __asm__
+#define __INLINE  inline
+
+typedef struct
+{
+  __IO uint32_t ISER[8];
+       uint32_t RESERVED0[24];
+  __IO uint32_t ICER[8];
+       uint32_t RSERVED1[24];
+  __IO uint32_t ISPR[8];
+       uint32_t RESERVED2[24];
+  __IO uint32_t ICPR[8];
+       uint32_t RESERVED3[24];
+  __IO uint32_t IABR[8];
+       uint32_t RESERVED4[56];
+  __IO uint8_t  IP[240];
+       uint32_t RESERVED5[644];
+  __O  uint32_t STIR;
+}  NVIC_Type;
+
+typedef struct
+{
+  __I  uint32_t CPUID;
+  __IO uint32_t ICSR;
+  __IO uint32_t VTOR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CCR;
+  __IO uint8_t  SHP[12];
+  __IO uint32_t SHCSR;
+  __IO uint32_t CFSR;
+  __IO uint32_t HFSR;
+  __IO uint32_t DFSR;
+  __IO uint32_t MMFAR;
+  __IO uint32_t BFAR;
+  __IO uint32_t AFSR;
+  __I  uint32_t PFR[2];
+  __I  uint32_t DFR;
+  __I  uint32_t ADR;
+  __I  uint32_t MMFR[4];
+  __I  uint32_t ISAR[5];
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTSET_Pos             26
+#define SCB_ICSR_PENDSTSET_Msk             (1ul << SCB_ICSR_PENDSTSET_Pos)
+#define SCB_AIRCR_VECTKEY_Pos              16
+#define SCB_AIRCR_VECTKEY_Msk              (0xFFFFul << SCB_AIRCR_VECTKEY_Pos)
+#define SCB_AIRCR_PRIGROUP_Pos              8
+#define SCB_AIRCR_PRIGROUP_Msk             (7ul << SCB_AIRCR_PRIGROUP_Pos)
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_COUNTFLAG_Pos         16
+#define SysTick_CTRL_COUNTFLAG_Msk         (1ul << SysTick_CTRL_COUNTFLAG_Pos)
+#define SysTick_CTRL_CLKSOURCE_Pos          2
+#define SysTick_CTRL_CLKSOURCE_Msk         (1ul << SysTick_CTRL_CLKSOURCE_Pos)
+#define SysTick_CTRL_TICKINT_Pos            1
+#define SysTick_CTRL_TICKINT_Msk           (1ul << SysTick_CTRL_TICKINT_Pos)
+#define SysTick_CTRL_ENABLE_Pos             0
+#define SysTick_CTRL_ENABLE_Msk            (1ul << SysTick_CTRL_ENABLE_Pos)
+#define SysTick_LOAD_RELOAD_Pos             0
+#define SysTick_LOAD_RELOAD_Msk            (0xFFFFFFul << SysTick_LOAD_RELOAD_Pos)
+
+typedef struct
+{
+  __IO uint32_t DHCSR;
+  __O  uint32_t DCRSR;
+  __IO uint32_t DCRDR;
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+/* Registri jezgra su promenljive u hal_core.c. */
+extern NVIC_Type hal_nvic;
+extern SCB_Type hal_scb;
+extern SysTick_Type hal_systick;
+extern CoreDebug_Type hal_core_debug;
+
+#define SCB        (&hal_scb)
+#define SysTick    (&hal_systick)
+#define NVIC       (&hal_nvic)
+#define CoreDebug  (&hal_core_debug)
+
+/* Intrinsic funkcije. PRIMASK je zastavica u hal_core.c, a ekskluzivni
+   pristup uvek uspeva jer firmware na host-u ne moze biti prekinut izmedju
+   __LDREXW i __STREXW. */
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+uint32_t __LDREXW(uint32_t *addr);
+uint32_t __STREXW(uint32_t value, uint32_t *addr);
+void __CLREX(void);
+void __NOP(void);
+void __WFI(void);
+void __WFE(void);
+void __DSB(void);
+void __ISB(void);
+void __DMB(void);
+
+/* NVIC i SysTick. IRQn_Type je iz stm32f10x.h koji ukljucuje ovaj fajl
+   posle definicije tipa. */
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
+uint32_t NVIC_GetPriorityGrouping(void);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetActive(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+uint32_t SysTick_Config(uint32_t ticks);
+void NVIC_SystemReset(void);
+
+#endif
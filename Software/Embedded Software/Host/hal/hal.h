@@ -0,0 +1,100 @@
+/**
+*   @file:    hal.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Host strana HAL zamene za plocu kretanja. Firmware se prevodi
+*             nepromenjen protiv hal/stm32f10x.h i hal/core_cm3.h, a ovaj
+*             fajl je interfejs za host program (motion_host.c) i modele
+*             uredjaja oko procesora.
+*
+*             Vreme je virtuelno, u ciklusima procesora od 24 MHz. Firmware
+*             se izvrsava u nultom vremenu: glavna petlja poziva HalIdle()
+*             (MAIN_IDLE iz main_template.c) koji pomera vreme do sledeceg
+*             dogadjaja (SysTick, tajmer, kraj bajta na USART-u, kraj DMA
+*             prenosa, uredjaj) i poziva prekidne rutine po prioritetu iz
+*             NVIC-a, sa istim pravilima prekidanja kao na Cortex-M3.
+*             Petlja koja ceka zastavicu (USART_GetFlagStatus) takodje pomera
+*             vreme. Ceo model je deterministican.
+*/
+
+#ifndef __HAL_H__
+#define __HAL_H__
+
+#include <stdint.h>
+
+#define HAL_CPU_HZ           24000000
+#define HAL_TIME_NEVER       UINT64_MAX
+#define HAL_MS(ms)           ((uint64_t)(ms) * (HAL_CPU_HZ / 1000))
+#define HAL_US(us)           ((uint64_t)(us) * (HAL_CPU_HZ / 1000000))
+/* Ciklusi u ns i nazad (1 ciklus = 125/3 ns). */
+#define HAL_TO_NS(t)         ((uint64_t)(t) * 125 / 3)
+#define HAL_FROM_NS(ns)      (((uint64_t)(ns) * 3 + 124) / 125)
+
+/* Indeksi portova i broj instanci periferija. */
+#define HAL_PORT_A           0
+#define HAL_PORT_B           1
+#define HAL_PORT_C           2
+#define HAL_PORT_D           3
+#define HAL_PORT_E           4
+#define HAL_PORT_NUM         5
+#define HAL_TIM_NUM          18     // TIM1..TIM17, indeks je broj tajmera.
+#define HAL_USART_NUM        4      // USART1..USART3.
+#define HAL_DMA_CHANNEL_NUM  8      // DMA1 kanali 1..7.
+#define HAL_IRQ_NUM          60     // IRQn 0..59, SysTick se vodi posebno.
+
+/* Uredjaj van procesora (motor, senzor, magistrala). next() vraca trenutak
+   sledeceg dogadjaja ili HAL_TIME_NEVER, a run() se poziva kada vreme
+   stigne do tog trenutka i sme da menja ulazne pinove i prima bajtove. */
+typedef struct HalDevice {
+  uint64_t (*next)(void *ctx);
+  void (*run)(void *ctx, uint64_t now);
+  void *ctx;
+  struct HalDevice *link;
+} HalDevice;
+
+/* Poziva se kada firmware promeni izlazne pinove porta (changed je maska). */
+typedef void (*HalPinHook)(void *ctx, int port, uint16_t changed, uint16_t level);
+/* Bajt koji je USART poslao, t je trenutak pocetka bajta na liniji. */
+typedef void (*HalTxHook)(void *ctx, int usart, uint8_t byte, uint64_t t);
+/* Izlaz kanala tajmera u modu poredjenja (OC) je promenio stanje. */
+typedef void (*HalOcHook)(void *ctx, int tim, int channel, int level);
+/* Poziva se posle svakog dogadjaja i obrade prekida koji su ga pratili. */
+typedef void (*HalStepHook)(void *ctx, uint64_t now);
+
+/* Sve periferije na reset vrednosti, vreme 0, bez uredjaja i hook-ova. */
+void HalReset(void);
+/* Pokrece firmware_main i vraca se kada virtuelno vreme stigne do end.
+   Firmware se ne moze nastaviti posle povratka. */
+uint64_t HalRun(int (*firmware_main)(void), uint64_t end);
+/* Zavrsava HalRun() na trenutnom vremenu (npr. kada se veza zatvori). */
+void HalStop(void);
+/* Pomera vreme do sledeceg dogadjaja i obradjuje prekide (MAIN_IDLE). */
+void HalIdle(void);
+uint64_t HalNow(void);
+/* Brojac ciklusa za CYCLE_COUNTER_READ. */
+uint32_t HalCycles(void);
+
+void HalAddDevice(HalDevice *dev);
+void HalSetPinHook(HalPinHook hook, void *ctx);
+void HalSetTxHook(HalTxHook hook, void *ctx);
+void HalSetOcHook(HalOcHook hook, void *ctx);
+void HalSetStepHook(HalStepHook hook, void *ctx);
+
+/* Spoljasnji nivo ulaznog pina. Ivica pokrece EXTI liniju ako je povezana
+   na taj port (AFIO_EXTICR) i dozvoljena za tu ivicu. */
+void HalGpioInput(int port, int pin, int level);
+/* Stanje pina kako ga vidi spoljasnji svet (izlaz ili spoljasnji nivo). */
+int HalGpioLevel(int port, int pin);
+/* Primljeni bajt na USART-u, vraca 1 ako je prethodni bajt izgubljen (ORE). */
+int HalUsartReceive(int usart, uint8_t byte);
+/* Trajanje jednog bajta (10 bita) na USART-u u ciklusima, 0 ako nije podesen. */
+uint64_t HalUsartByteTime(int usart);
+/* Nivo na ulazu kanala tajmera (channel 1..4). U modu hvatanja (IC) ivica
+   zadata polaritetom iz CCER upisuje CNT u CCR i postavlja CCxIF. */
+void HalTimInput(int tim, int channel, int level);
+
+/* Broj ulazaka u prekidnu rutinu, irqn -1 je SysTick. */
+unsigned long HalIrqCount(int irqn);
+
+#endif
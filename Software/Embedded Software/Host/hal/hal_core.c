@@ -0,0 +1,454 @@
+/**
+*   @file:    hal_core.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Jezgro host HAL-a: virtuelno vreme, NVIC, SysTick, PRIMASK i
+*             pozivanje prekidnih rutina firmware-a. Videti hal.h.
+*
+*             Prekid se poziva kada je omogucen u NVIC-u, kada je njegova
+*             linija aktivna (zastavica periferije i dozvola prekida) ili je
+*             softverski postavljen, PRIMASK je 0 i grupni prioritet mu je
+*             veci od trenutnog. Medju spremnim prekidima ide onaj sa
+*             najmanjom vrednoscu prioriteta, pa manji IRQn. Linija je nivo:
+*             rutina koja ne obrise zastavicu se poziva ponovo, kao na ploci.
+*/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f10x.h"
+#include "hal.h"
+#include "hal_internal.h"
+
+#define EXEC_THREAD     0x100       // Prioritet glavne petlje, nizi od svih prekida.
+#define NO_IRQ          (-100)
+#define IRQ_REPEAT_MAX  1000000     // Ulazaka u prekide bez pomeranja vremena.
+
+/* Prekidne rutine koje firmware moze da definise. Nedefinisana ostaje NULL. */
+#define HAL_VECTORS(X)                                     \
+  X(EXTI0_IRQn, EXTI0_IRQHandler)                          \
+  X(EXTI1_IRQn, EXTI1_IRQHandler)                          \
+  X(EXTI2_IRQn, EXTI2_IRQHandler)                          \
+  X(EXTI3_IRQn, EXTI3_IRQHandler)                          \
+  X(EXTI4_IRQn, EXTI4_IRQHandler)                          \
+  X(DMA1_Channel1_IRQn, DMA1_Channel1_IRQHandler)          \
+  X(DMA1_Channel2_IRQn, DMA1_Channel2_IRQHandler)          \
+  X(DMA1_Channel3_IRQn, DMA1_Channel3_IRQHandler)          \
+  X(DMA1_Channel4_IRQn, DMA1_Channel4_IRQHandler)          \
+  X(DMA1_Channel5_IRQn, DMA1_Channel5_IRQHandler)          \
+  X(DMA1_Channel6_IRQn, DMA1_Channel6_IRQHandler)          \
+  X(DMA1_Channel7_IRQn, DMA1_Channel7_IRQHandler)          \
+  X(EXTI9_5_IRQn, EXTI9_5_IRQHandler)                      \
+  X(TIM1_BRK_TIM15_IRQn, TIM1_BRK_TIM15_IRQHandler)        \
+  X(TIM1_UP_TIM16_IRQn, TIM1_UP_TIM16_IRQHandler)          \
+  X(TIM1_TRG_COM_TIM17_IRQn, TIM1_TRG_COM_TIM17_IRQHandler)\
+  X(TIM1_CC_IRQn, TIM1_CC_IRQHandler)                      \
+  X(TIM2_IRQn, TIM2_IRQHandler)                            \
+  X(TIM3_IRQn, TIM3_IRQHandler)                            \
+  X(TIM4_IRQn, TIM4_IRQHandler)                            \
+  X(USART1_IRQn, USART1_IRQHandler)                        \
+  X(USART2_IRQn, USART2_IRQHandler)                        \
+  X(USART3_IRQn, USART3_IRQHandler)                        \
+  X(EXTI15_10_IRQn, EXTI15_10_IRQHandler)                  \
+  X(TIM6_DAC_IRQn, TIM6_DAC_IRQHandler)                    \
+  X(TIM7_IRQn, TIM7_IRQHandler)
+
+#define HAL_DECLARE(irqn, name) extern void name(void) __attribute__((weak));
+HAL_VECTORS(HAL_DECLARE)
+extern void SysTick_Handler(void) __attribute__((weak));
+
+NVIC_Type hal_nvic;
+SCB_Type hal_scb;
+SysTick_Type hal_systick;
+CoreDebug_Type hal_core_debug;
+uint32_t SystemCoreClock = HAL_CPU_HZ;
+
+static void (*vector[HAL_IRQ_NUM])(void);
+static uint64_t now, run_end;
+static jmp_buf run_exit;
+static uint32_t primask;
+static uint32_t exec_prio = EXEC_THREAD;
+static uint32_t *exclusive;
+static int systick_pending;
+static uint64_t systick_next = HAL_TIME_NEVER;
+static unsigned long irq_count[HAL_IRQ_NUM + 1];
+static uint64_t repeat_time;
+static unsigned long repeat_count;
+static HalDevice *devices;
+static HalStepHook step_hook;
+static void *step_ctx;
+
+/*----------------------------------------------------------------------------*/
+void SystemInit(void)
+{
+}
+/*----------------------------------------------------------------------------*/
+void SystemCoreClockUpdate(void)
+{
+  SystemCoreClock = HAL_CPU_HZ;
+}
+/*----------------------------------------------------------------------------*/
+void HalReset(void)
+{
+  /* DMA i debug_log.c cuvaju adrese u 32-bitnim registrima. */
+  if ((uintptr_t)(uint32_t)(uintptr_t)&hal_nvic != (uintptr_t)&hal_nvic) {
+    fprintf(stderr, "hal: adrese podataka nisu 32-bitne, linkovati sa -no-pie\n");
+    exit(1);
+  }
+  memset((void *)&hal_nvic, 0, sizeof(hal_nvic));
+  memset((void *)&hal_scb, 0, sizeof(hal_scb));
+  memset((void *)&hal_systick, 0, sizeof(hal_systick));
+  memset((void *)&hal_core_debug, 0, sizeof(hal_core_debug));
+  hal_scb.AIRCR = 0xFA050000;
+
+#define HAL_VECTOR(irqn, name) vector[irqn] = name;
+  HAL_VECTORS(HAL_VECTOR)
+
+  now = 0;
+  primask = 0;
+  exec_prio = EXEC_THREAD;
+  exclusive = NULL;
+  systick_pending = 0;
+  systick_next = HAL_TIME_NEVER;
+  memset(irq_count, 0, sizeof(irq_count));
+  repeat_time = 0;
+  repeat_count = 0;
+  devices = NULL;
+  step_hook = NULL;
+  SystemCoreClock = HAL_CPU_HZ;
+  HalFaultInit();
+  HalPeriphReset();
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t Priority(int irqn)
+{
+  return irqn < 0 ? hal_scb.SHP[((uint32_t)irqn & 0xF) - 4] : hal_nvic.IP[irqn];
+}
+/*----------------------------------------------------------------------------*/
+/* Grupni prioritet po PRIGROUP polju AIRCR registra. */
+static uint32_t GroupPriority(uint32_t prio)
+{
+  uint32_t group = (hal_scb.AIRCR & SCB_AIRCR_PRIGROUP_Msk) >> SCB_AIRCR_PRIGROUP_Pos;
+
+  return group >= 7 ? 0 : prio & (0xFFu << (group + 1)) & 0xFF;
+}
+/*----------------------------------------------------------------------------*/
+/* Prekidi na cekanju (ISPR ili aktivna linija periferije) iz maske irqs. */
+static uint64_t Pending(uint64_t irqs)
+{
+  uint64_t ispr = (uint64_t)hal_nvic.ISPR[1] << 32 | hal_nvic.ISPR[0];
+
+  irqs &= HAL_IRQ_BIT(HAL_IRQ_NUM) - 1;
+  return (ispr & irqs) | HalPeriphAssertedMask(irqs);
+}
+/*----------------------------------------------------------------------------*/
+static void Enter(int irqn, uint32_t prio)
+{
+  uint32_t saved = exec_prio;
+  void (*handler)(void);
+
+  if (now != repeat_time) {
+    repeat_time = now;
+    repeat_count = 0;
+  }
+  else if (++repeat_count > IRQ_REPEAT_MAX) {
+    fprintf(stderr, "hal: prekid %d se ponavlja bez pomeranja vremena "
+                    "(zastavica se ne brise?)\n", irqn);
+    exit(1);
+  }
+
+  if (irqn < 0) {
+    systick_pending = 0;
+    hal_scb.ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+    handler = SysTick_Handler;
+  }
+  else {
+    hal_nvic.ISPR[irqn >> 5] &= ~(1u << (irqn & 31));
+    handler = vector[irqn];
+  }
+  if (!handler) {
+    fprintf(stderr, "hal: nema prekidne rutine za IRQ %d\n", irqn);
+    exit(1);
+  }
+
+  irq_count[irqn + 1]++;
+  exclusive = NULL;
+  exec_prio = GroupPriority(prio);
+  if (irqn >= 0) hal_nvic.IABR[irqn >> 5] |= 1u << (irqn & 31);
+  handler();
+  if (irqn >= 0) hal_nvic.IABR[irqn >> 5] &= ~(1u << (irqn & 31));
+  exec_prio = saved;
+  exclusive = NULL;
+}
+/*----------------------------------------------------------------------------*/
+void HalDispatch(void)
+{
+  for (;;) {
+    int best = NO_IRQ;
+    uint32_t best_prio = EXEC_THREAD;
+    uint64_t pending;
+
+    if (primask) return;
+    if (systick_pending) {
+      best = SysTick_IRQn;
+      best_prio = Priority(SysTick_IRQn);
+    }
+    /* Pri istom prioritetu pobedjuje manji IRQn. */
+    pending = Pending((uint64_t)hal_nvic.ISER[1] << 32 | hal_nvic.ISER[0]);
+    while (pending) {
+      int irqn = __builtin_ctzll(pending);
+
+      pending &= pending - 1;
+      if (hal_nvic.IP[irqn] >= best_prio) continue;
+      best = irqn;
+      best_prio = hal_nvic.IP[irqn];
+    }
+    if (best == NO_IRQ || GroupPriority(best_prio) >= exec_prio) return;
+    Enter(best, best_prio);
+  }
+}
+/*----------------------------------------------------------------------------*/
+static void SysTickSync(void)
+{
+  if (!(hal_systick.CTRL & SysTick_CTRL_ENABLE_Msk)) systick_next = HAL_TIME_NEVER;
+  else if (systick_next == HAL_TIME_NEVER) systick_next = now + hal_systick.LOAD + 1;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Pomera vreme do sledeceg dogadjaja, poziva uredjaje i prekide.
+  *         Kada je sledeci dogadjaj na kraju simulacije ili posle njega,
+  *         vraca se u HalRun().
+  * @param  None
+  * @retval None
+  */
+static void Step(void)
+{
+  uint64_t t, d;
+  HalDevice *dev;
+
+  HalPeriphSync(now);
+  SysTickSync();
+  t = HalPeriphNext(now);
+  if (systick_next < t) t = systick_next;
+  for (dev = devices; dev; dev = dev->link) {
+    d = dev->next(dev->ctx);
+    if (d < t) t = d;
+  }
+  if (t < now) t = now;
+  if (t >= run_end) {
+    HalPeriphAdvance(run_end);
+    now = run_end;
+    longjmp(run_exit, 1);
+  }
+
+  now = t;
+  HalPeriphAdvance(t);
+  if (systick_next == t) {
+    systick_next = t + hal_systick.LOAD + 1;
+    if (hal_systick.CTRL & SysTick_CTRL_TICKINT_Msk) {
+      systick_pending = 1;
+      hal_scb.ICSR |= SCB_ICSR_PENDSTSET_Msk;
+    }
+  }
+  if (systick_next != HAL_TIME_NEVER) hal_systick.VAL = (uint32_t)(systick_next - now - 1);
+  for (dev = devices; dev; dev = dev->link) {
+    if (dev->next(dev->ctx) <= t) dev->run(dev->ctx, t);
+  }
+  HalDispatch();
+  if (step_hook) step_hook(step_ctx, now);
+}
+/*----------------------------------------------------------------------------*/
+uint64_t HalRun(int (*firmware_main)(void), uint64_t end)
+{
+  run_end = end;
+  if (setjmp(run_exit) == 0) {
+    firmware_main();
+    for (;;) Step();
+  }
+  return now;
+}
+/*----------------------------------------------------------------------------*/
+void HalStop(void)
+{
+  run_end = now;
+}
+/*----------------------------------------------------------------------------*/
+void HalIdle(void)
+{
+  Step();
+}
+/*----------------------------------------------------------------------------*/
+void HalWait(void)
+{
+  Step();
+}
+/*----------------------------------------------------------------------------*/
+uint64_t HalNow(void)
+{
+  return now;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t HalCycles(void)
+{
+  return (uint32_t)now;
+}
+/*----------------------------------------------------------------------------*/
+void HalAddDevice(HalDevice *dev)
+{
+  dev->link = devices;
+  devices = dev;
+}
+/*----------------------------------------------------------------------------*/
+void HalSetStepHook(HalStepHook hook, void *ctx)
+{
+  step_hook = hook;
+  step_ctx = ctx;
+}
+/*----------------------------------------------------------------------------*/
+unsigned long HalIrqCount(int irqn)
+{
+  return (irqn >= -1 && irqn < HAL_IRQ_NUM) ? irq_count[irqn + 1] : 0;
+}
+/*----------------------------------------------------------------------------*/
+void __enable_irq(void)
+{
+  primask = 0;
+  HalDispatch();
+}
+/*----------------------------------------------------------------------------*/
+void __disable_irq(void)
+{
+  primask = 1;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t __get_PRIMASK(void)
+{
+  return primask;
+}
+/*----------------------------------------------------------------------------*/
+void __set_PRIMASK(uint32_t priMask)
+{
+  primask = priMask & 1;
+  if (!primask) HalDispatch();
+}
+/*----------------------------------------------------------------------------*/
+/* Ulazak u prekid brise ekskluzivni monitor, kao na ploci. */
+uint32_t __LDREXW(uint32_t *addr)
+{
+  exclusive = addr;
+  return *addr;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t __STREXW(uint32_t value, uint32_t *addr)
+{
+  if (exclusive != addr) return 1;
+  *addr = value;
+  exclusive = NULL;
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+void __CLREX(void)
+{
+  exclusive = NULL;
+}
+/*----------------------------------------------------------------------------*/
+void __NOP(void)
+{
+}
+/*----------------------------------------------------------------------------*/
+void __WFI(void)
+{
+  Step();
+}
+/*----------------------------------------------------------------------------*/
+void __WFE(void)
+{
+  Step();
+}
+/*----------------------------------------------------------------------------*/
+void __DSB(void)
+{
+}
+/*----------------------------------------------------------------------------*/
+void __ISB(void)
+{
+}
+/*----------------------------------------------------------------------------*/
+void __DMB(void)
+{
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup)
+{
+  hal_scb.AIRCR = (hal_scb.AIRCR & ~(SCB_AIRCR_VECTKEY_Msk | SCB_AIRCR_PRIGROUP_Msk)) |
+                  (0x5FAu << SCB_AIRCR_VECTKEY_Pos) | ((PriorityGroup & 7) << SCB_AIRCR_PRIGROUP_Pos);
+}
+/*----------------------------------------------------------------------------*/
+uint32_t NVIC_GetPriorityGrouping(void)
+{
+  return (hal_scb.AIRCR & SCB_AIRCR_PRIGROUP_Msk) >> SCB_AIRCR_PRIGROUP_Pos;
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  hal_nvic.ISER[(uint32_t)IRQn >> 5] |= 1u << ((uint32_t)IRQn & 31);
+  HalDispatch();
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+  hal_nvic.ISER[(uint32_t)IRQn >> 5] &= ~(1u << ((uint32_t)IRQn & 31));
+}
+/*----------------------------------------------------------------------------*/
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+  return Pending(HAL_IRQ_BIT(IRQn)) != 0;
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+  hal_nvic.ISPR[(uint32_t)IRQn >> 5] |= 1u << ((uint32_t)IRQn & 31);
+  HalDispatch();
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+  hal_nvic.ISPR[(uint32_t)IRQn >> 5] &= ~(1u << ((uint32_t)IRQn & 31));
+}
+/*----------------------------------------------------------------------------*/
+uint32_t NVIC_GetActive(IRQn_Type IRQn)
+{
+  return (hal_nvic.IABR[(uint32_t)IRQn >> 5] >> ((uint32_t)IRQn & 31)) & 1;
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+  if (IRQn < 0) hal_scb.SHP[((uint32_t)IRQn & 0xF) - 4] = (priority << (8 - __NVIC_PRIO_BITS)) & 0xFF;
+  else hal_nvic.IP[IRQn] = (priority << (8 - __NVIC_PRIO_BITS)) & 0xFF;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+  return Priority(IRQn) >> (8 - __NVIC_PRIO_BITS);
+}
+/*----------------------------------------------------------------------------*/
+uint32_t SysTick_Config(uint32_t ticks)
+{
+  if (ticks - 1 > SysTick_LOAD_RELOAD_Msk) return 1;
+  hal_systick.LOAD = (ticks & SysTick_LOAD_RELOAD_Msk) - 1;
+  NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+  hal_systick.VAL = 0;
+  hal_systick.CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+  systick_next = now + hal_systick.LOAD + 1;
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SystemReset(void)
+{
+  fprintf(stderr, "hal: NVIC_SystemReset u %.6f s\n", (double)now / HAL_CPU_HZ);
+  exit(1);
+}
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,104 @@
+/**
+*   @file:    hal_fault.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Celobrojno deljenje nulom kao na Cortex-M3. Sa DIV_0_TRP = 0
+*             (reset vrednost SCB->CCR, firmware je ne menja) UDIV/SDIV sa
+*             deliocem 0 daju 0 i program ide dalje, a na x86 isto deljenje
+*             izaziva SIGFPE. Firmware se na to oslanja, npr. ARR = 1 + 100 /
+*             speed_current_X u position_controler.c kada je brzina 0.
+*
+*             Obrada signala preskace instrukciju DIV/IDIV i upisuje rezultat
+*             koji bi dao ARM: kolicnik 0, a ostatak (a - (a / 0) * 0) jednak
+*             deljeniku. Za INT_MIN / -1 kolicnik je INT_MIN i ostatak 0.
+*             Radi samo na x86-64 Linux-u, na drugim sistemima deljenje nulom
+*             prekida program.
+*/
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_internal.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <ucontext.h>
+
+/* Redosled registara u ModRM/REX kodiranju prema gregs[] iz ucontext-a. */
+static const int reg_map[16] = {
+  REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+  REG_R8,  REG_R9,  REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15
+};
+
+static void DivideFault(int sig, siginfo_t *info, void *context)
+{
+  ucontext_t *uc = context;
+  greg_t *r = uc->uc_mcontext.gregs;
+  const uint8_t *ip = (const uint8_t *)r[REG_RIP];
+  const uint8_t *p = ip;
+  uint8_t rex = 0, modrm, mod, rm;
+  int wide, divisor_minus_one = 0;
+
+  (void)sig;
+  (void)info;
+  while (*p == 0x66 || *p == 0x67 || *p == 0xF2 || *p == 0xF3 || *p == 0x2E || *p == 0x3E) p++;
+  if ((*p & 0xF0) == 0x40) rex = *p++;
+  if (*p != 0xF7) {
+    fprintf(stderr, "hal: deljenje nulom u nepodrzanoj instrukciji na %p\n", (const void *)ip);
+    abort();
+  }
+  p++;
+  modrm = *p++;
+  mod = modrm >> 6;
+  rm = modrm & 7;
+  if (mod != 3) {
+    if (rm == 4) {
+      uint8_t sib = *p++;
+      if ((sib & 7) == 5 && mod == 0) p += 4;
+    }
+    else if (rm == 5 && mod == 0) p += 4;
+    if (mod == 1) p += 1;
+    else if (mod == 2) p += 4;
+  }
+  wide = (rex & 0x08) != 0;
+
+  /* IDIV sa deliocem -1 u registru: prekoracenje, ne deljenje nulom. */
+  if (mod == 3 && ((modrm >> 3) & 7) == 7) {
+    greg_t d = r[reg_map[rm | ((rex & 1) << 3)]];
+    divisor_minus_one = wide ? d == -1 : (uint32_t)d == 0xFFFFFFFFu;
+  }
+  if (divisor_minus_one) {
+    r[REG_RDX] = 0;
+    if (!wide) r[REG_RAX] = (greg_t)(uint32_t)r[REG_RAX];
+  }
+  else {
+    r[REG_RDX] = wide ? r[REG_RAX] : (greg_t)(uint32_t)r[REG_RAX];
+    r[REG_RAX] = 0;
+  }
+  r[REG_RIP] = (greg_t)p;
+}
+
+void HalFaultInit(void)
+{
+  struct sigaction sa;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = DivideFault;
+  sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGFPE, &sa, NULL);
+}
+
+#else
+
+void HalFaultInit(void)
+{
+}
+
+#endif
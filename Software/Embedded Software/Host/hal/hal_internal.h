@@ -0,0 +1,35 @@
+/**
+*   @file:    hal_internal.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Veza izmedju jezgra (hal_core.c: vreme, NVIC, SysTick) i
+*             modela periferija (hal_periph.c). Ne koristi se van hal/.
+*/
+
+#ifndef __HAL_INTERNAL_H__
+#define __HAL_INTERNAL_H__
+
+#include <stdint.h>
+
+/* Periferije na reset vrednosti. */
+void HalPeriphReset(void);
+/* Primecuje upise registara koji pokrecu ili zaustavljaju brojanje (CEN). */
+void HalPeriphSync(uint64_t now);
+/* Najraniji dogadjaj periferija (od now, ukljucujuci now) ili HAL_TIME_NEVER. */
+uint64_t HalPeriphNext(uint64_t now);
+/* Pomera brojace i prenose do t i postavlja zastavice. */
+void HalPeriphAdvance(uint64_t t);
+#define HAL_IRQ_BIT(irqn)   ((uint64_t)1 << (irqn))
+/* Aktivne prekidne linije periferija, bit po IRQn, samo iz maske enabled. */
+uint64_t HalPeriphAssertedMask(uint64_t enabled);
+
+/* Deljenje nulom u firmware-u daje 0 kao na Cortex-M3 (hal_fault.c). */
+void HalFaultInit(void);
+
+/* Poziva prekide ciji je prioritet veci od trenutnog. */
+void HalDispatch(void);
+/* Jedan korak vremena iz petlje cekanja u firmware-u. */
+void HalWait(void);
+
+#endif
@@ -0,0 +1,1350 @@
+/**
+*   @file:    hal_periph.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Periferije host HAL-a i StdPeriph funkcije koje firmware ploce
+*             kretanja koristi (GPIO, EXTI, TIM, USART, DMA, RCC, NVIC_Init).
+*             Funkcije upisuju iste registre kao pravi drajver V3.3.0, a
+*             modeli periferija rade nad tim registrima:
+*
+*             - Tajmer broji na (PSC+1) ciklusa kada je CEN postavljen. PSC i
+*               ARR (uz ARPE) se preuzimaju na dogadjaju azuriranja, kao u
+*               hardveru. Poredjenje postavlja CCxIF, a ulaz u modu hvatanja
+*               (HalTimInput) upisuje CNT u CCRx.
+*             - USART salje bajt za 10 * BRR ciklusa, sa jednim bajtom u
+*               TDR-u (TXE) i TC na kraju. Prijem postavlja RXNE ili ORE.
+*             - DMA kanal iz memorije u USART_DR upisuje bajt kad god je TXE
+*               postavljen i na kraju postavlja TCIF. Memorijska adresa iz
+*               CMAR se cita direktno (zato host build ide sa -no-pie).
+*             - GPIO izlaz je ODR, a ulaz je spoljasnji nivo (HalGpioInput).
+*               Ivica na ulazu postavlja EXTI_PR po AFIO_EXTICR, RTSR i FTSR.
+*
+*             CRL/CRH i CEN kanala DMA se menjaju samo kroz GPIO_Init i
+*             DMA_Cmd, ostali registri se mogu upisivati i direktno.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32f10x.h"
+#include "hal.h"
+#include "hal_internal.h"
+
+#define USART_SR_RESET      (USART_SR_TXE | USART_SR_TC)
+#define USART_SR_RC_W0      (USART_SR_CTS | USART_SR_LBD | USART_SR_TC | USART_SR_RXNE)
+#define TIM_SR_CC_ALL       (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)
+
+TIM_TypeDef hal_tim[HAL_TIM_NUM];
+USART_TypeDef hal_usart[HAL_USART_NUM];
+GPIO_TypeDef hal_gpio[HAL_PORT_NUM];
+DMA_Channel_TypeDef hal_dma1_channel[HAL_DMA_CHANNEL_NUM];
+DMA_TypeDef hal_dma1;
+AFIO_TypeDef hal_afio;
+EXTI_TypeDef hal_exti;
+ADC_TypeDef hal_adc1;
+RCC_TypeDef hal_rcc;
+
+/* Tajmeri STM32F100 (MD_VL). */
+static const uint8_t tim_list[] = { 1, 2, 3, 4, 6, 7, 15, 16, 17 };
+
+typedef struct {
+  int running;
+  uint64_t next_tick;               // Sledeci korak brojaca, HAL_TIME_NEVER kada stoji.
+  uint16_t psc;                     // Aktivni preskaler.
+  uint16_t arr;                     // Aktivna perioda.
+  uint8_t input[4];                 // Nivoi ulaza kanala.
+  uint8_t oc_level[4];              // Izlazi kanala u modu poredjenja.
+  /* Kanali dekodirani iz CCMR1/CCMR2/CCER, obnavljaju se kad se oni promene. */
+  uint16_t ccmr1, ccmr2, ccer;
+  int hooked;
+  uint8_t oc_mask;                  // Kanali u modu poredjenja.
+  uint8_t hook_mask;                // Kanali ciji izlaz ide u OC hook.
+  uint8_t oc_mode[4];
+} TimState;
+
+typedef struct {
+  int active;                       // Bajt je na liniji.
+  uint64_t tx_end;
+  int holding;                      // Bajt ceka u TDR-u.
+  uint8_t hold;
+} UsartState;
+
+typedef struct {
+  int active;
+  int usart;                        // Odredisni USART.
+  uint32_t pos, count;
+  uint64_t next;
+} DmaState;
+
+static TimState tim_state[HAL_TIM_NUM];
+static UsartState usart_state[HAL_USART_NUM];
+static DmaState dma_state[HAL_DMA_CHANNEL_NUM];
+static uint16_t gpio_ext[HAL_PORT_NUM];
+static uint16_t gpio_out_mask[HAL_PORT_NUM];
+static uint16_t gpio_out_level[HAL_PORT_NUM];
+
+static HalPinHook pin_hook;
+static void *pin_ctx;
+static HalTxHook tx_hook;
+static void *tx_ctx;
+static HalOcHook oc_hook;
+static void *oc_ctx;
+
+/*----------------------------------------------------------------------------*/
+void HalPeriphReset(void)
+{
+  int i;
+
+  memset(hal_tim, 0, sizeof(hal_tim));
+  memset(hal_usart, 0, sizeof(hal_usart));
+  memset(hal_gpio, 0, sizeof(hal_gpio));
+  memset(hal_dma1_channel, 0, sizeof(hal_dma1_channel));
+  memset((void *)&hal_dma1, 0, sizeof(hal_dma1));
+  memset((void *)&hal_afio, 0, sizeof(hal_afio));
+  memset((void *)&hal_exti, 0, sizeof(hal_exti));
+  memset((void *)&hal_adc1, 0, sizeof(hal_adc1));
+  memset((void *)&hal_rcc, 0, sizeof(hal_rcc));
+  memset(tim_state, 0, sizeof(tim_state));
+  memset(usart_state, 0, sizeof(usart_state));
+  memset(dma_state, 0, sizeof(dma_state));
+  memset(gpio_ext, 0, sizeof(gpio_ext));
+  memset(gpio_out_mask, 0, sizeof(gpio_out_mask));
+  memset(gpio_out_level, 0, sizeof(gpio_out_level));
+
+  for (i = 0; i < HAL_TIM_NUM; i++) {
+    hal_tim[i].ARR = 0xFFFF;
+    tim_state[i].arr = 0xFFFF;
+    tim_state[i].next_tick = HAL_TIME_NEVER;
+    tim_state[i].hooked = -1;       // Maske kanala jos nisu dekodirane.
+  }
+  for (i = 0; i < HAL_USART_NUM; i++) hal_usart[i].SR = USART_SR_RESET;
+  for (i = 0; i < HAL_PORT_NUM; i++) hal_gpio[i].CRL = hal_gpio[i].CRH = 0x44444444;
+  hal_rcc.CR = 0x00000083;
+
+  pin_hook = NULL;
+  tx_hook = NULL;
+  oc_hook = NULL;
+}
+/*----------------------------------------------------------------------------*/
+void HalSetPinHook(HalPinHook hook, void *ctx)
+{
+  pin_hook = hook;
+  pin_ctx = ctx;
+}
+/*----------------------------------------------------------------------------*/
+void HalSetTxHook(HalTxHook hook, void *ctx)
+{
+  tx_hook = hook;
+  tx_ctx = ctx;
+}
+/*----------------------------------------------------------------------------*/
+void HalSetOcHook(HalOcHook hook, void *ctx)
+{
+  oc_hook = hook;
+  oc_ctx = ctx;
+}
+
+/******************************************************************************/
+/*                                 GPIO, EXTI                                 */
+/******************************************************************************/
+
+static int PortIndex(GPIO_TypeDef *GPIOx)
+{
+  return (int)(GPIOx - hal_gpio);
+}
+/*----------------------------------------------------------------------------*/
+/* IDR iz izlaza i spoljasnjih nivoa, i javljanje promene izlaza. */
+static void GpioUpdate(int port)
+{
+  uint16_t mask = gpio_out_mask[port];
+  uint16_t out = (uint16_t)(hal_gpio[port].ODR & mask);
+  uint16_t changed = out ^ gpio_out_level[port];
+
+  hal_gpio[port].IDR = out | (gpio_ext[port] & ~mask);
+  gpio_out_level[port] = out;
+  if (changed && pin_hook) pin_hook(pin_ctx, port, changed, out);
+}
+/*----------------------------------------------------------------------------*/
+void HalGpioInput(int port, int pin, int level)
+{
+  uint16_t bit = (uint16_t)(1u << pin);
+  int old = (gpio_ext[port] & bit) != 0;
+
+  if (level) gpio_ext[port] |= bit;
+  else gpio_ext[port] &= ~bit;
+  GpioUpdate(port);
+
+  if (old == (level != 0) || (gpio_out_mask[port] & bit)) return;
+  if (((hal_afio.EXTICR[pin >> 2] >> (4 * (pin & 3))) & 0xF) != (uint32_t)port) return;
+  if ((level ? hal_exti.RTSR : hal_exti.FTSR) & bit) hal_exti.PR |= bit;
+}
+/*----------------------------------------------------------------------------*/
+int HalGpioLevel(int port, int pin)
+{
+  uint16_t bit = (uint16_t)(1u << pin);
+
+  if (gpio_out_mask[port] & bit) return (hal_gpio[port].ODR & bit) != 0;
+  return (gpio_ext[port] & bit) != 0;
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct)
+{
+  uint32_t mode = (uint32_t)GPIO_InitStruct->GPIO_Mode & 0x0F;
+  int port = PortIndex(GPIOx), pin;
+
+  if ((uint32_t)GPIO_InitStruct->GPIO_Mode & 0x10) mode |= (uint32_t)GPIO_InitStruct->GPIO_Speed;
+  for (pin = 0; pin < 16; pin++) {
+    volatile uint32_t *cr = pin < 8 ? &GPIOx->CRL : &GPIOx->CRH;
+    uint32_t shift = (uint32_t)(pin & 7) * 4;
+
+    if (!(GPIO_InitStruct->GPIO_Pin & (1u << pin))) continue;
+    *cr = (*cr & ~(0x0Fu << shift)) | (mode << shift);
+    if (GPIO_InitStruct->GPIO_Mode == GPIO_Mode_IPD) GPIOx->ODR &= ~(1u << pin);
+    if (GPIO_InitStruct->GPIO_Mode == GPIO_Mode_IPU) GPIOx->ODR |= 1u << pin;
+    /* Izlaz opste namene: MODE != 0 i CNF1 = 0. */
+    if ((mode & 0x03) && !(mode & 0x08)) gpio_out_mask[port] |= 1u << pin;
+    else gpio_out_mask[port] &= ~(1u << pin);
+  }
+  GpioUpdate(port);
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_StructInit(GPIO_InitTypeDef* GPIO_InitStruct)
+{
+  GPIO_InitStruct->GPIO_Pin = GPIO_Pin_All;
+  GPIO_InitStruct->GPIO_Speed = GPIO_Speed_2MHz;
+  GPIO_InitStruct->GPIO_Mode = GPIO_Mode_IN_FLOATING;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+  return (GPIOx->IDR & GPIO_Pin) ? (uint8_t)Bit_SET : (uint8_t)Bit_RESET;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t GPIO_ReadInputData(GPIO_TypeDef* GPIOx)
+{
+  return (uint16_t)GPIOx->IDR;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t GPIO_ReadOutputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+  return (GPIOx->ODR & GPIO_Pin) ? (uint8_t)Bit_SET : (uint8_t)Bit_RESET;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx)
+{
+  return (uint16_t)GPIOx->ODR;
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+  GPIOx->ODR |= GPIO_Pin;
+  GpioUpdate(PortIndex(GPIOx));
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+  GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+  GpioUpdate(PortIndex(GPIOx));
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_WriteBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction BitVal)
+{
+  if (BitVal != Bit_RESET) GPIO_SetBits(GPIOx, GPIO_Pin);
+  else GPIO_ResetBits(GPIOx, GPIO_Pin);
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint16_t PortVal)
+{
+  GPIOx->ODR = PortVal;
+  GpioUpdate(PortIndex(GPIOx));
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_PinRemapConfig(uint32_t GPIO_Remap, FunctionalState NewState)
+{
+  /* Preslikavanje pinova nema uticaja na model, samo se pamti. */
+  if (NewState != DISABLE) hal_afio.MAPR |= GPIO_Remap & 0x000FFFFF;
+  else hal_afio.MAPR &= ~(GPIO_Remap & 0x000FFFFF);
+}
+/*----------------------------------------------------------------------------*/
+void GPIO_EXTILineConfig(uint8_t GPIO_PortSource, uint8_t GPIO_PinSource)
+{
+  uint32_t shift = 4 * (uint32_t)(GPIO_PinSource & 0x03);
+
+  hal_afio.EXTICR[GPIO_PinSource >> 2] &= ~(0x0Fu << shift);
+  hal_afio.EXTICR[GPIO_PinSource >> 2] |= (uint32_t)GPIO_PortSource << shift;
+}
+/*----------------------------------------------------------------------------*/
+void EXTI_Init(EXTI_InitTypeDef* EXTI_InitStruct)
+{
+  uint8_t *base = (uint8_t *)&hal_exti;
+  uint32_t line = EXTI_InitStruct->EXTI_Line;
+
+  /* Kao u drajveru, mod i ivica su pomeraji registara od pocetka EXTI. */
+  if (EXTI_InitStruct->EXTI_LineCmd != DISABLE) {
+    hal_exti.IMR &= ~line;
+    hal_exti.EMR &= ~line;
+    *(volatile uint32_t *)(base + EXTI_InitStruct->EXTI_Mode) |= line;
+    hal_exti.RTSR &= ~line;
+    hal_exti.FTSR &= ~line;
+    if (EXTI_InitStruct->EXTI_Trigger == EXTI_Trigger_Rising_Falling) {
+      hal_exti.RTSR |= line;
+      hal_exti.FTSR |= line;
+    }
+    else *(volatile uint32_t *)(base + EXTI_InitStruct->EXTI_Trigger) |= line;
+  }
+  else *(volatile uint32_t *)(base + EXTI_InitStruct->EXTI_Mode) &= ~line;
+}
+/*----------------------------------------------------------------------------*/
+void EXTI_StructInit(EXTI_InitTypeDef* EXTI_InitStruct)
+{
+  EXTI_InitStruct->EXTI_Line = 0;
+  EXTI_InitStruct->EXTI_Mode = EXTI_Mode_Interrupt;
+  EXTI_InitStruct->EXTI_Trigger = EXTI_Trigger_Falling;
+  EXTI_InitStruct->EXTI_LineCmd = DISABLE;
+}
+/*----------------------------------------------------------------------------*/
+void EXTI_GenerateSWInterrupt(uint32_t EXTI_Line)
+{
+  hal_exti.SWIER |= EXTI_Line;
+  hal_exti.PR |= EXTI_Line;
+  HalDispatch();
+}
+/*----------------------------------------------------------------------------*/
+FlagStatus EXTI_GetFlagStatus(uint32_t EXTI_Line)
+{
+  return (hal_exti.PR & EXTI_Line) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void EXTI_ClearFlag(uint32_t EXTI_Line)
+{
+  hal_exti.PR &= ~EXTI_Line;
+  hal_exti.SWIER &= ~EXTI_Line;
+}
+/*----------------------------------------------------------------------------*/
+ITStatus EXTI_GetITStatus(uint32_t EXTI_Line)
+{
+  return ((hal_exti.PR & EXTI_Line) && (hal_exti.IMR & EXTI_Line)) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void EXTI_ClearITPendingBit(uint32_t EXTI_Line)
+{
+  EXTI_ClearFlag(EXTI_Line);
+}
+
+/******************************************************************************/
+/*                                    RCC                                     */
+/******************************************************************************/
+
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState)
+{
+  if (NewState != DISABLE) hal_rcc.AHBENR |= RCC_AHBPeriph;
+  else hal_rcc.AHBENR &= ~RCC_AHBPeriph;
+}
+/*----------------------------------------------------------------------------*/
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+  if (NewState != DISABLE) hal_rcc.APB2ENR |= RCC_APB2Periph;
+  else hal_rcc.APB2ENR &= ~RCC_APB2Periph;
+}
+/*----------------------------------------------------------------------------*/
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+  if (NewState != DISABLE) hal_rcc.APB1ENR |= RCC_APB1Periph;
+  else hal_rcc.APB1ENR &= ~RCC_APB1Periph;
+}
+/*----------------------------------------------------------------------------*/
+void RCC_APB2PeriphResetCmd(uint32_t RCC_APB2Periph, FunctionalState NewState)
+{
+  (void)RCC_APB2Periph;
+  (void)NewState;
+}
+/*----------------------------------------------------------------------------*/
+void RCC_APB1PeriphResetCmd(uint32_t RCC_APB1Periph, FunctionalState NewState)
+{
+  (void)RCC_APB1Periph;
+  (void)NewState;
+}
+/*----------------------------------------------------------------------------*/
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks)
+{
+  RCC_Clocks->SYSCLK_Frequency = HAL_CPU_HZ;
+  RCC_Clocks->HCLK_Frequency = HAL_CPU_HZ;
+  RCC_Clocks->PCLK1_Frequency = HAL_CPU_HZ;
+  RCC_Clocks->PCLK2_Frequency = HAL_CPU_HZ;
+  RCC_Clocks->ADCCLK_Frequency = HAL_CPU_HZ / 2;
+}
+
+/******************************************************************************/
+/*                              NVIC (misc.c)                                 */
+/******************************************************************************/
+
+void NVIC_PriorityGroupConfig(uint32_t NVIC_PriorityGroup)
+{
+  SCB->AIRCR = 0x05FA0000 | NVIC_PriorityGroup;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Isti racun kao u misc.c. Na Cortex-M3 pomeranje registrom za 32 i
+  *         vise daje 0, pa bez NVIC_PriorityGroupConfig (PRIGROUP = 0) svi
+  *         kanali dobijaju prioritet 0, kao na ploci.
+  * @param  NVIC_InitStruct: kanal, prioriteti i dozvola.
+  * @retval None
+  */
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct)
+{
+  uint32_t tmppriority, tmppre, tmpsub = 0x0F;
+  uint8_t channel = NVIC_InitStruct->NVIC_IRQChannel;
+
+  if (NVIC_InitStruct->NVIC_IRQChannelCmd != DISABLE) {
+    tmppriority = (0x700 - (SCB->AIRCR & 0x700)) >> 0x08;
+    tmppre = 0x4 - tmppriority;
+    tmpsub = tmpsub >> tmppriority;
+    tmppriority = (tmppre & 0xFF) < 32 ? (uint32_t)NVIC_InitStruct->NVIC_IRQChannelPreemptionPriority << tmppre : 0;
+    tmppriority |= NVIC_InitStruct->NVIC_IRQChannelSubPriority & tmpsub;
+    tmppriority = tmppriority << 0x04;
+    NVIC->IP[channel] = (uint8_t)tmppriority;
+    NVIC->ISER[channel >> 0x05] |= 1u << (channel & 0x1F);
+    HalDispatch();
+  }
+  else NVIC->ISER[channel >> 0x05] &= ~(1u << (channel & 0x1F));
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SetVectorTable(uint32_t NVIC_VectTab, uint32_t Offset)
+{
+  SCB->VTOR = NVIC_VectTab | (Offset & 0x1FFFFF80);
+}
+/*----------------------------------------------------------------------------*/
+void NVIC_SystemLPConfig(uint8_t LowPowerMode, FunctionalState NewState)
+{
+  if (NewState != DISABLE) SCB->SCR |= LowPowerMode;
+  else SCB->SCR &= ~(uint32_t)LowPowerMode;
+}
+/*----------------------------------------------------------------------------*/
+void SysTick_CLKSourceConfig(uint32_t SysTick_CLKSource)
+{
+  if (SysTick_CLKSource == SysTick_CLKSource_HCLK) SysTick->CTRL |= SysTick_CLKSource_HCLK;
+  else SysTick->CTRL &= SysTick_CLKSource_HCLK_Div8;
+}
+
+/******************************************************************************/
+/*                                    TIM                                     */
+/******************************************************************************/
+
+static int TimIndex(TIM_TypeDef *TIMx)
+{
+  return (int)(TIMx - hal_tim);
+}
+/*----------------------------------------------------------------------------*/
+static volatile uint16_t *TimCcr(TIM_TypeDef *tim, int ch)
+{
+  switch (ch) {
+    case 0: return &tim->CCR1;
+    case 1: return &tim->CCR2;
+    case 2: return &tim->CCR3;
+    default: return &tim->CCR4;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/* Bajt CCMR registra za kanal 0..3. */
+static uint16_t TimCcmr(TIM_TypeDef *tim, int ch)
+{
+  return (uint16_t)(((ch < 2 ? tim->CCMR1 : tim->CCMR2) >> ((ch & 1) * 8)) & 0xFF);
+}
+/*----------------------------------------------------------------------------*/
+static void TimSetCcmr(TIM_TypeDef *tim, int ch, uint16_t clear, uint16_t set)
+{
+  volatile uint16_t *ccmr = ch < 2 ? &tim->CCMR1 : &tim->CCMR2;
+  int shift = (ch & 1) * 8;
+
+  *ccmr = (uint16_t)((*ccmr & ~(clear << shift)) | (set << shift));
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Kanali tajmera iz CCMR1/CCMR2/CCER. Dekodiraju se ponovo samo kada
+  *         se registri promene, jer se proveravaju na svakom dogadjaju.
+  *         OC hook dobija kanale ciji izlaz menja stanje na poklapanje
+  *         (OCxM 1..3) i koji su ukljuceni. Prinudni nivo (OCxM 4 i 5) vazi
+  *         od dekodiranja, bez poklapanja.
+  * @param  i: indeks tajmera.
+  * @retval Stanje tajmera sa obnovljenim maskama.
+  */
+static TimState *TimConfig(int i)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+  TimState *st = &tim_state[i];
+  int ch;
+
+  if (st->ccmr1 == tim->CCMR1 && st->ccmr2 == tim->CCMR2 && st->ccer == tim->CCER &&
+      st->hooked == (oc_hook != NULL))
+    return st;
+  st->ccmr1 = tim->CCMR1;
+  st->ccmr2 = tim->CCMR2;
+  st->ccer = tim->CCER;
+  st->hooked = oc_hook != NULL;
+  st->oc_mask = 0;
+  st->hook_mask = 0;
+  for (ch = 0; ch < 4; ch++) {
+    uint16_t ccmr = TimCcmr(tim, ch);
+
+    st->oc_mode[ch] = (uint8_t)((ccmr >> 4) & 7);
+    if (ccmr & 3) continue;
+    st->oc_mask |= (uint8_t)(1u << ch);
+    if (st->hooked && st->oc_mode[ch] >= 1 && st->oc_mode[ch] <= 5 && (tim->CCER & (TIM_CCER_CC1E << (4 * ch))))
+      st->hook_mask |= (uint8_t)(1u << ch);
+    if ((st->oc_mode[ch] == 4 || st->oc_mode[ch] == 5) && st->oc_level[ch] != st->oc_mode[ch] - 4) {
+      st->oc_level[ch] = (uint8_t)(st->oc_mode[ch] - 4);
+      if (st->hook_mask & (1u << ch))
+        oc_hook(oc_ctx, i, ch + 1, st->oc_level[ch] ^ ((tim->CCER >> (4 * ch + 1)) & 1));
+    }
+  }
+  return st;
+}
+/*----------------------------------------------------------------------------*/
+static void TimOcMatch(int i, int ch)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+  TimState *st = &tim_state[i];
+  uint8_t mode = st->oc_mode[ch];
+  uint8_t level = st->oc_level[ch];
+
+  if (mode == 1) level = 1;
+  else if (mode == 2) level = 0;
+  else if (mode == 3) level ^= 1;
+  else return;
+  if (level == st->oc_level[ch]) return;
+  st->oc_level[ch] = level;
+  if (st->hook_mask & (1u << ch))
+    oc_hook(oc_ctx, i, ch + 1, level ^ ((tim->CCER >> (4 * ch + 1)) & 1));
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Poredjenje za korake u kojima brojac prolazi vrednosti from+1 ..
+  *         from+count, a kada je wrap 1 poslednji korak vraca brojac na 0.
+  * @param  i: indeks tajmera.
+  * @param  from: vrednost brojaca pre prvog koraka.
+  * @param  count: broj koraka.
+  * @param  wrap: 1 ako je poslednji korak prelaz preko ARR.
+  * @retval None
+  */
+static void TimCompare(int i, uint32_t from, uint32_t count, int wrap)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+  TimState *st = &tim_state[i];
+  /* Kanal sa vec postavljenim CCxIF i bez OC hook-a se ne menja. */
+  unsigned int mask = st->oc_mask & ((~tim->SR >> 1) | st->hook_mask) & 0xF;
+
+  while (mask) {
+    int ch = __builtin_ctz(mask);
+    uint32_t ccr;
+
+    mask &= mask - 1;
+    ccr = *TimCcr(tim, ch);
+    if ((ccr > from && ccr <= from + count - (uint32_t)wrap) || (wrap && ccr == 0)) {
+      tim->SR |= TIM_SR_CC1IF << ch;
+      TimOcMatch(i, ch);
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+/* Dogadjaj azuriranja: preuzimanje PSC i ARR i UIF. */
+static void TimUpdateEvent(int i)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+
+  if (tim->CR1 & TIM_CR1_UDIS) return;
+  tim_state[i].psc = tim->PSC;
+  tim_state[i].arr = tim->ARR;
+  tim->SR |= TIM_SR_UIF;
+}
+/*----------------------------------------------------------------------------*/
+static void TimAdvance(int i, uint64_t t)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+  TimState *st = &tim_state[i];
+
+  if (!st->running || st->next_tick > t) return;
+  TimConfig(i);
+  while (st->running && st->next_tick <= t) {
+    uint64_t period = (uint64_t)st->psc + 1, n, update_time, full;
+    uint32_t cnt = tim->CNT, to_update;
+
+    if (!(tim->CR1 & TIM_CR1_ARPE)) st->arr = tim->ARR;
+    if (st->arr == 0) {
+      /* Sa ARR = 0 brojac stoji. */
+      st->next_tick = HAL_TIME_NEVER;
+      break;
+    }
+    n = (t - st->next_tick) / period + 1;
+    to_update = ((st->arr - cnt) & 0xFFFF) + 1;
+    if (n < to_update) {
+      TimCompare(i, cnt, (uint32_t)n, 0);
+      tim->CNT = (uint16_t)(cnt + n);
+      st->next_tick += n * period;
+      break;
+    }
+
+    TimCompare(i, cnt, to_update, 1);
+    tim->CNT = 0;
+    update_time = st->next_tick + (to_update - 1) * period;
+    TimUpdateEvent(i);
+    if (tim->CR1 & TIM_CR1_OPM) {
+      tim->CR1 &= ~TIM_CR1_CEN;
+      st->running = 0;
+      break;
+    }
+    st->next_tick = update_time + st->psc + 1;
+
+    /* Cele periode bez promene PSC/ARR i bez izlaza za OC hook se preskacu. */
+    full = ((uint64_t)st->arr + 1) * ((uint64_t)st->psc + 1);
+    if (st->next_tick <= t && t - st->next_tick >= full && tim->PSC == st->psc &&
+        tim->ARR == st->arr && st->hook_mask == 0) {
+      int ch;
+
+      st->next_tick += (t - st->next_tick) / full * full;
+      if (!(tim->CR1 & TIM_CR1_UDIS)) tim->SR |= TIM_SR_UIF;
+      for (ch = 0; ch < 4; ch++) {
+        if ((st->oc_mask & (1u << ch)) && *TimCcr(tim, ch) <= st->arr) tim->SR |= TIM_SR_CC1IF << ch;
+      }
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+/* Trenutak sledeceg azuriranja ili poredjenja koje zanima prekid ili OC hook. */
+static uint64_t TimNext(int i)
+{
+  TIM_TypeDef *tim = &hal_tim[i];
+  TimState *st = &tim_state[i];
+  uint32_t arr, cnt, to_update, d = 0, mask;
+
+  if (!st->running || st->next_tick == HAL_TIME_NEVER) return HAL_TIME_NEVER;
+  TimConfig(i);
+  mask = st->oc_mask & (((uint32_t)tim->DIER >> 1) | st->hook_mask) & 0xF;
+  if (!(tim->DIER & TIM_DIER_UIE) && mask == 0) return HAL_TIME_NEVER;
+  arr = (tim->CR1 & TIM_CR1_ARPE) ? st->arr : tim->ARR;
+  if (arr == 0) return HAL_TIME_NEVER;
+  cnt = tim->CNT;
+  to_update = ((arr - cnt) & 0xFFFF) + 1;
+  if (tim->DIER & TIM_DIER_UIE) d = to_update;
+  while (mask) {
+    int ch = __builtin_ctz(mask);
+    uint32_t ccr, dc;
+
+    mask &= mask - 1;
+    ccr = *TimCcr(tim, ch);
+    if (ccr > arr) continue;
+    dc = ccr > cnt ? ccr - cnt : to_update + ccr;
+    if (dc > to_update) dc = to_update;
+    if (d == 0 || dc < d) d = dc;
+  }
+  if (d == 0) return HAL_TIME_NEVER;
+  return st->next_tick + (uint64_t)(d - 1) * ((uint64_t)st->psc + 1);
+}
+/*----------------------------------------------------------------------------*/
+void HalTimInput(int tim_index, int channel, int level)
+{
+  TIM_TypeDef *tim = &hal_tim[tim_index];
+  TimState *st = &tim_state[tim_index];
+  int ch = channel - 1;
+  uint16_t flag = (uint16_t)(TIM_SR_CC1IF << ch);
+
+  level = level != 0;
+  if (st->input[ch] == level) return;
+  st->input[ch] = (uint8_t)level;
+  if (!(TimCcmr(tim, ch) & 3) || !(tim->CCER & (TIM_CCER_CC1E << (4 * ch)))) return;
+  /* CCxP = 0 hvata uzlaznu, CCxP = 1 silaznu ivicu. */
+  if (level == (int)((tim->CCER >> (4 * ch + 1)) & 1)) return;
+  if (tim->SR & flag) tim->SR |= TIM_SR_CC1OF << ch;
+  *TimCcr(tim, ch) = tim->CNT;
+  tim->SR |= flag;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_TimeBaseInit(TIM_TypeDef* TIMx, TIM_TimeBaseInitTypeDef* TIM_TimeBaseInitStruct)
+{
+  int i = TimIndex(TIMx);
+  uint16_t tmpcr1 = TIMx->CR1;
+
+  if (i == 1 || i == 2 || i == 3 || i == 4) {
+    tmpcr1 &= (uint16_t)~(TIM_CR1_DIR | TIM_CR1_CMS);
+    tmpcr1 |= TIM_TimeBaseInitStruct->TIM_CounterMode;
+  }
+  if (i != 6 && i != 7) {
+    tmpcr1 &= (uint16_t)~TIM_CR1_CKD;
+    tmpcr1 |= TIM_TimeBaseInitStruct->TIM_ClockDivision;
+  }
+  TIMx->CR1 = tmpcr1;
+  TIMx->ARR = TIM_TimeBaseInitStruct->TIM_Period;
+  TIMx->PSC = TIM_TimeBaseInitStruct->TIM_Prescaler;
+  if (i == 1 || i == 15 || i == 16 || i == 17) TIMx->RCR = TIM_TimeBaseInitStruct->TIM_RepetitionCounter;
+
+  /* EGR = UG: brojac na 0, PSC i ARR odmah vaze, UIF se postavlja. */
+  TIMx->CNT = 0;
+  TimUpdateEvent(i);
+  if (tim_state[i].running) tim_state[i].next_tick = HalNow() + tim_state[i].psc + 1;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_TimeBaseStructInit(TIM_TimeBaseInitTypeDef* TIM_TimeBaseInitStruct)
+{
+  TIM_TimeBaseInitStruct->TIM_Period = 0xFFFF;
+  TIM_TimeBaseInitStruct->TIM_Prescaler = 0x0000;
+  TIM_TimeBaseInitStruct->TIM_ClockDivision = TIM_CKD_DIV1;
+  TIM_TimeBaseInitStruct->TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInitStruct->TIM_RepetitionCounter = 0x0000;
+}
+/*----------------------------------------------------------------------------*/
+static void TimOCInit(TIM_TypeDef* TIMx, int ch, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  int i = TimIndex(TIMx), shift = 4 * ch;
+  uint16_t ccer;
+
+  TIMx->CCER &= (uint16_t)~(TIM_CCER_CC1E << shift);
+  ccer = TIMx->CCER;
+  TimSetCcmr(TIMx, ch, TIM_CCMR1_OC1M | TIM_CCMR1_CC1S, TIM_OCInitStruct->TIM_OCMode);
+  ccer &= (uint16_t)~(TIM_CCER_CC1P << shift);
+  ccer |= (uint16_t)((TIM_OCInitStruct->TIM_OCPolarity | TIM_OCInitStruct->TIM_OutputState) << shift);
+  if ((i == 1 || i == 15 || i == 16 || i == 17) && ch < 3) {
+    ccer &= (uint16_t)~((TIM_CCER_CC1NP | TIM_CCER_CC1NE) << shift);
+    ccer |= (uint16_t)((TIM_OCInitStruct->TIM_OCNPolarity | TIM_OCInitStruct->TIM_OutputNState) << shift);
+    TIMx->CR2 &= (uint16_t)~((TIM_CR2_OIS1 | TIM_CR2_OIS1N) << (2 * ch));
+    TIMx->CR2 |= (uint16_t)((TIM_OCInitStruct->TIM_OCIdleState | TIM_OCInitStruct->TIM_OCNIdleState) << (2 * ch));
+  }
+  *TimCcr(TIMx, ch) = TIM_OCInitStruct->TIM_Pulse;
+  TIMx->CCER = ccer;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC1Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  TimOCInit(TIMx, 0, TIM_OCInitStruct);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC2Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  TimOCInit(TIMx, 1, TIM_OCInitStruct);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC3Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  TimOCInit(TIMx, 2, TIM_OCInitStruct);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC4Init(TIM_TypeDef* TIMx, TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  TimOCInit(TIMx, 3, TIM_OCInitStruct);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OCStructInit(TIM_OCInitTypeDef* TIM_OCInitStruct)
+{
+  TIM_OCInitStruct->TIM_OCMode = TIM_OCMode_Timing;
+  TIM_OCInitStruct->TIM_OutputState = TIM_OutputState_Disable;
+  TIM_OCInitStruct->TIM_OutputNState = TIM_OutputNState_Disable;
+  TIM_OCInitStruct->TIM_Pulse = 0x0000;
+  TIM_OCInitStruct->TIM_OCPolarity = TIM_OCPolarity_High;
+  TIM_OCInitStruct->TIM_OCNPolarity = TIM_OCPolarity_High;
+  TIM_OCInitStruct->TIM_OCIdleState = TIM_OCIdleState_Reset;
+  TIM_OCInitStruct->TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ICInit(TIM_TypeDef* TIMx, TIM_ICInitTypeDef* TIM_ICInitStruct)
+{
+  int ch = TIM_ICInitStruct->TIM_Channel >> 2, shift = 4 * ch;
+
+  TIMx->CCER &= (uint16_t)~(TIM_CCER_CC1E << shift);
+  TimSetCcmr(TIMx, ch, TIM_CCMR1_CC1S | TIM_CCMR1_IC1F | TIM_CCMR1_IC1PSC,
+             (uint16_t)(TIM_ICInitStruct->TIM_ICSelection | (TIM_ICInitStruct->TIM_ICFilter << 4) |
+                        TIM_ICInitStruct->TIM_ICPrescaler));
+  TIMx->CCER &= (uint16_t)~(TIM_CCER_CC1P << shift);
+  TIMx->CCER |= (uint16_t)((TIM_ICInitStruct->TIM_ICPolarity | TIM_CCER_CC1E) << shift);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ICStructInit(TIM_ICInitTypeDef* TIM_ICInitStruct)
+{
+  TIM_ICInitStruct->TIM_Channel = TIM_Channel_1;
+  TIM_ICInitStruct->TIM_ICPolarity = TIM_ICPolarity_Rising;
+  TIM_ICInitStruct->TIM_ICSelection = TIM_ICSelection_DirectTI;
+  TIM_ICInitStruct->TIM_ICPrescaler = TIM_ICPSC_DIV1;
+  TIM_ICInitStruct->TIM_ICFilter = 0x00;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_Cmd(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+  if (NewState != DISABLE) TIMx->CR1 |= TIM_CR1_CEN;
+  else TIMx->CR1 &= (uint16_t)~TIM_CR1_CEN;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_CtrlPWMOutputs(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+  if (NewState != DISABLE) TIMx->BDTR |= TIM_BDTR_MOE;
+  else TIMx->BDTR &= (uint16_t)~TIM_BDTR_MOE;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ITConfig(TIM_TypeDef* TIMx, uint16_t TIM_IT, FunctionalState NewState)
+{
+  if (NewState != DISABLE) TIMx->DIER |= TIM_IT;
+  else TIMx->DIER &= (uint16_t)~TIM_IT;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ARRPreloadConfig(TIM_TypeDef* TIMx, FunctionalState NewState)
+{
+  if (NewState != DISABLE) TIMx->CR1 |= TIM_CR1_ARPE;
+  else TIMx->CR1 &= (uint16_t)~TIM_CR1_ARPE;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SelectInputTrigger(TIM_TypeDef* TIMx, uint16_t TIM_InputTriggerSource)
+{
+  TIMx->SMCR = (uint16_t)((TIMx->SMCR & ~TIM_SMCR_TS) | TIM_InputTriggerSource);
+}
+/*----------------------------------------------------------------------------*/
+static void TimCcerBits(TIM_TypeDef* TIMx, uint16_t mask, uint16_t value)
+{
+  TIMx->CCER = (uint16_t)((TIMx->CCER & ~mask) | value);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC1PolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC1P, TIM_OCPolarity);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC2PolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC2P, (uint16_t)(TIM_OCPolarity << 4));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC3PolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC3P, (uint16_t)(TIM_OCPolarity << 8));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC4PolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC4P, (uint16_t)(TIM_OCPolarity << 12));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC1NPolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCNPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC1NP, TIM_OCNPolarity);
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC2NPolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCNPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC2NP, (uint16_t)(TIM_OCNPolarity << 4));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_OC3NPolarityConfig(TIM_TypeDef* TIMx, uint16_t TIM_OCNPolarity)
+{
+  TimCcerBits(TIMx, TIM_CCER_CC3NP, (uint16_t)(TIM_OCNPolarity << 8));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_CCxCmd(TIM_TypeDef* TIMx, uint16_t TIM_Channel, uint16_t TIM_CCx)
+{
+  TimCcerBits(TIMx, (uint16_t)(TIM_CCER_CC1E << TIM_Channel), (uint16_t)(TIM_CCx << TIM_Channel));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_CCxNCmd(TIM_TypeDef* TIMx, uint16_t TIM_Channel, uint16_t TIM_CCxN)
+{
+  TimCcerBits(TIMx, (uint16_t)(TIM_CCER_CC1NE << TIM_Channel), (uint16_t)(TIM_CCxN << TIM_Channel));
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetCounter(TIM_TypeDef* TIMx, uint16_t Counter)
+{
+  TIMx->CNT = Counter;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetAutoreload(TIM_TypeDef* TIMx, uint16_t Autoreload)
+{
+  TIMx->ARR = Autoreload;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetCompare1(TIM_TypeDef* TIMx, uint16_t Compare1)
+{
+  TIMx->CCR1 = Compare1;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetCompare2(TIM_TypeDef* TIMx, uint16_t Compare2)
+{
+  TIMx->CCR2 = Compare2;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetCompare3(TIM_TypeDef* TIMx, uint16_t Compare3)
+{
+  TIMx->CCR3 = Compare3;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_SetCompare4(TIM_TypeDef* TIMx, uint16_t Compare4)
+{
+  TIMx->CCR4 = Compare4;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t TIM_GetCounter(TIM_TypeDef* TIMx)
+{
+  return TIMx->CNT;
+}
+/*----------------------------------------------------------------------------*/
+FlagStatus TIM_GetFlagStatus(TIM_TypeDef* TIMx, uint16_t TIM_FLAG)
+{
+  return (TIMx->SR & TIM_FLAG) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ClearFlag(TIM_TypeDef* TIMx, uint16_t TIM_FLAG)
+{
+  TIMx->SR &= (uint16_t)~TIM_FLAG;
+}
+/*----------------------------------------------------------------------------*/
+ITStatus TIM_GetITStatus(TIM_TypeDef* TIMx, uint16_t TIM_IT)
+{
+  return ((TIMx->SR & TIM_IT) && (TIMx->DIER & TIM_IT)) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void TIM_ClearITPendingBit(TIM_TypeDef* TIMx, uint16_t TIM_IT)
+{
+  TIMx->SR &= (uint16_t)~TIM_IT;
+}
+
+/******************************************************************************/
+/*                                   USART                                    */
+/******************************************************************************/
+
+static int UsartIndex(USART_TypeDef *USARTx)
+{
+  return (int)(USARTx - hal_usart);
+}
+/*----------------------------------------------------------------------------*/
+uint64_t HalUsartByteTime(int usart)
+{
+  uint64_t t = 10ull * hal_usart[usart].BRR;
+
+  return t ? t : 1;
+}
+/*----------------------------------------------------------------------------*/
+/* SR sa TXE iz stanja TDR-a (TXE je samo za citanje, a firmware upisuje SR). */
+static uint16_t UsartSr(int u)
+{
+  USART_TypeDef *us = &hal_usart[u];
+
+  if (usart_state[u].holding) us->SR &= (uint16_t)~USART_SR_TXE;
+  else us->SR |= USART_SR_TXE;
+  return us->SR;
+}
+/*----------------------------------------------------------------------------*/
+static void UsartStart(int u, uint8_t byte, uint64_t t)
+{
+  usart_state[u].active = 1;
+  usart_state[u].tx_end = t + HalUsartByteTime(u);
+  hal_usart[u].SR &= (uint16_t)~USART_SR_TC;
+  if (tx_hook) tx_hook(tx_ctx, u, byte, t);
+}
+/*----------------------------------------------------------------------------*/
+/* Upis u TDR: odmah na liniju ako je slobodna, inace ceka kraj bajta. */
+static void UsartWrite(int u, uint8_t byte)
+{
+  UsartState *st = &usart_state[u];
+
+  if (!st->active) {
+    UsartStart(u, byte, HalNow());
+    return;
+  }
+  st->holding = 1;
+  st->hold = byte;
+  hal_usart[u].SR &= (uint16_t)~(USART_SR_TXE | USART_SR_TC);
+}
+/*----------------------------------------------------------------------------*/
+static void UsartAdvance(int u, uint64_t t)
+{
+  UsartState *st = &usart_state[u];
+
+  while (st->active && st->tx_end <= t) {
+    if (st->holding) {
+      st->holding = 0;
+      hal_usart[u].SR |= USART_SR_TXE;
+      UsartStart(u, st->hold, st->tx_end);
+    }
+    else {
+      st->active = 0;
+      hal_usart[u].SR |= USART_SR_TC;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+static int UsartAsserted(int u)
+{
+  uint16_t sr = UsartSr(u), cr1 = hal_usart[u].CR1;
+
+  return ((sr & USART_SR_TXE) && (cr1 & USART_CR1_TXEIE)) ||
+         ((sr & USART_SR_TC) && (cr1 & USART_CR1_TCIE)) ||
+         ((sr & (USART_SR_RXNE | USART_SR_ORE)) && (cr1 & USART_CR1_RXNEIE)) ||
+         ((sr & USART_SR_IDLE) && (cr1 & USART_CR1_IDLEIE)) ||
+         ((sr & USART_SR_PE) && (cr1 & USART_CR1_PEIE));
+}
+/*----------------------------------------------------------------------------*/
+int HalUsartReceive(int usart, uint8_t byte)
+{
+  USART_TypeDef *us = &hal_usart[usart];
+
+  if (!(us->CR1 & USART_CR1_UE) || !(us->CR1 & USART_CR1_RE)) return 0;
+  if (us->SR & USART_SR_RXNE) {
+    us->SR |= USART_SR_ORE;
+    return 1;
+  }
+  us->DR = byte;
+  us->SR |= USART_SR_RXNE;
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+void USART_Init(USART_TypeDef* USARTx, USART_InitTypeDef* USART_InitStruct)
+{
+  USARTx->CR2 = (uint16_t)((USARTx->CR2 & ~USART_CR2_STOP) | USART_InitStruct->USART_StopBits);
+  USARTx->CR1 = (uint16_t)((USARTx->CR1 & ~(USART_CR1_M | USART_CR1_PCE | USART_CR1_PS | USART_CR1_TE | USART_CR1_RE)) |
+                           USART_InitStruct->USART_WordLength | USART_InitStruct->USART_Parity |
+                           USART_InitStruct->USART_Mode);
+  USARTx->CR3 = (uint16_t)((USARTx->CR3 & ~(USART_CR3_RTSE | USART_CR3_CTSE)) |
+                           USART_InitStruct->USART_HardwareFlowControl);
+  /* BRR = fPCLK / baud (mantisa i razlomak USARTDIV zajedno). */
+  USARTx->BRR = (uint16_t)((HAL_CPU_HZ + USART_InitStruct->USART_BaudRate / 2) / USART_InitStruct->USART_BaudRate);
+}
+/*----------------------------------------------------------------------------*/
+void USART_StructInit(USART_InitTypeDef* USART_InitStruct)
+{
+  USART_InitStruct->USART_BaudRate = 9600;
+  USART_InitStruct->USART_WordLength = USART_WordLength_8b;
+  USART_InitStruct->USART_StopBits = USART_StopBits_1;
+  USART_InitStruct->USART_Parity = USART_Parity_No;
+  USART_InitStruct->USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+  USART_InitStruct->USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+}
+/*----------------------------------------------------------------------------*/
+void USART_ClockInit(USART_TypeDef* USARTx, USART_ClockInitTypeDef* USART_ClockInitStruct)
+{
+  USARTx->CR2 = (uint16_t)((USARTx->CR2 & ~(USART_CR2_CLKEN | USART_CR2_CPOL | USART_CR2_CPHA | USART_CR2_LBCL)) |
+                           USART_ClockInitStruct->USART_Clock | USART_ClockInitStruct->USART_CPOL |
+                           USART_ClockInitStruct->USART_CPHA | USART_ClockInitStruct->USART_LastBit);
+}
+/*----------------------------------------------------------------------------*/
+void USART_ClockStructInit(USART_ClockInitTypeDef* USART_ClockInitStruct)
+{
+  USART_ClockInitStruct->USART_Clock = USART_Clock_Disable;
+  USART_ClockInitStruct->USART_CPOL = USART_CPOL_Low;
+  USART_ClockInitStruct->USART_CPHA = USART_CPHA_1Edge;
+  USART_ClockInitStruct->USART_LastBit = USART_LastBit_Disable;
+}
+/*----------------------------------------------------------------------------*/
+void USART_Cmd(USART_TypeDef* USARTx, FunctionalState NewState)
+{
+  if (NewState != DISABLE) USARTx->CR1 |= USART_CR1_UE;
+  else USARTx->CR1 &= (uint16_t)~USART_CR1_UE;
+}
+/*----------------------------------------------------------------------------*/
+/* Registar (CR1..CR3) i bit dozvole iz koda USART_IT_*, kao u drajveru. */
+static volatile uint16_t *UsartItReg(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+  switch (((uint8_t)USART_IT) >> 5) {
+    case 1: return &USARTx->CR1;
+    case 2: return &USARTx->CR2;
+    default: return &USARTx->CR3;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void USART_ITConfig(USART_TypeDef* USARTx, uint16_t USART_IT, FunctionalState NewState)
+{
+  volatile uint16_t *reg = UsartItReg(USARTx, USART_IT);
+  uint16_t mask = (uint16_t)(1u << (USART_IT & 0x1F));
+
+  if (NewState != DISABLE) *reg |= mask;
+  else *reg &= (uint16_t)~mask;
+}
+/*----------------------------------------------------------------------------*/
+void USART_DMACmd(USART_TypeDef* USARTx, uint16_t USART_DMAReq, FunctionalState NewState)
+{
+  if (NewState != DISABLE) USARTx->CR3 |= USART_DMAReq;
+  else USARTx->CR3 &= (uint16_t)~USART_DMAReq;
+}
+/*----------------------------------------------------------------------------*/
+void USART_SendData(USART_TypeDef* USARTx, uint16_t Data)
+{
+  USARTx->DR = (uint16_t)(Data & 0x01FF);
+  if (!(USARTx->CR1 & USART_CR1_UE) || !(USARTx->CR1 & USART_CR1_TE)) return;
+  UsartWrite(UsartIndex(USARTx), (uint8_t)Data);
+}
+/*----------------------------------------------------------------------------*/
+uint16_t USART_ReceiveData(USART_TypeDef* USARTx)
+{
+  USARTx->SR &= (uint16_t)~(USART_SR_RXNE | USART_SR_ORE);
+  return (uint16_t)(USARTx->DR & 0x01FF);
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Stanje zastavice. Firmware je cita samo u petljama cekanja, pa
+  *         zastavica koja nije postavljena pomera vreme do sledeceg dogadjaja.
+  * @param  USARTx: USART.
+  * @param  USART_FLAG: USART_FLAG_*.
+  * @retval SET ili RESET.
+  */
+FlagStatus USART_GetFlagStatus(USART_TypeDef* USARTx, uint16_t USART_FLAG)
+{
+  if (UsartSr(UsartIndex(USARTx)) & USART_FLAG) return SET;
+  HalWait();
+  return RESET;
+}
+/*----------------------------------------------------------------------------*/
+void USART_ClearFlag(USART_TypeDef* USARTx, uint16_t USART_FLAG)
+{
+  USARTx->SR &= (uint16_t)~(USART_FLAG & USART_SR_RC_W0);
+}
+/*----------------------------------------------------------------------------*/
+ITStatus USART_GetITStatus(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+  uint16_t enabled = (uint16_t)(*UsartItReg(USARTx, USART_IT) & (1u << (USART_IT & 0x1F)));
+  uint16_t flag = (uint16_t)(UsartSr(UsartIndex(USARTx)) & (1u << (USART_IT >> 8)));
+
+  return (enabled && flag) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void USART_ClearITPendingBit(USART_TypeDef* USARTx, uint16_t USART_IT)
+{
+  USARTx->SR &= (uint16_t)~((1u << (USART_IT >> 8)) & USART_SR_RC_W0);
+}
+
+/******************************************************************************/
+/*                                    DMA                                     */
+/******************************************************************************/
+
+static int DmaIndex(DMA_Channel_TypeDef* ch)
+{
+  return (int)(ch - hal_dma1_channel);
+}
+/*----------------------------------------------------------------------------*/
+/* USART ciji je DR odrediste kanala, 0 ako nije USART. */
+static int DmaUsart(int c)
+{
+  int u;
+
+  for (u = 1; u < HAL_USART_NUM; u++) {
+    if (hal_dma1_channel[c].CPAR == (uint32_t)(uintptr_t)&hal_usart[u].DR) return u;
+  }
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Pocetak prenosa. Modeluje se samo prenos iz memorije u USART_DR
+  *         (USART_DMAReq_Tx), ostali prenosi se nikad ne zavrsavaju.
+  * @param  c: kanal 1..7.
+  * @retval None
+  */
+static void DmaStart(int c)
+{
+  DmaState *st = &dma_state[c];
+  DMA_Channel_TypeDef *ch = &hal_dma1_channel[c];
+
+  st->active = 0;
+  st->usart = DmaUsart(c);
+  if (!st->usart || !(ch->CCR & DMA_CCR1_DIR) || ch->CNDTR == 0) return;
+  st->active = 1;
+  st->pos = 0;
+  st->count = ch->CNDTR;
+  st->next = HalNow();
+}
+/*----------------------------------------------------------------------------*/
+static void DmaAdvance(int c, uint64_t t)
+{
+  DmaState *st = &dma_state[c];
+  DMA_Channel_TypeDef *ch = &hal_dma1_channel[c];
+  uint32_t shift = 4 * (uint32_t)(c - 1);
+
+  while (st->active && st->next <= t) {
+    USART_TypeDef *us = &hal_usart[st->usart];
+    const uint8_t *mem = (const uint8_t *)(uintptr_t)ch->CMAR;
+
+    /* Zahtev dolazi kada je TXE postavljen i USART_CR3_DMAT ukljucen. */
+    if (!(us->CR3 & USART_CR3_DMAT) || usart_state[st->usart].holding) {
+      st->next = usart_state[st->usart].holding ? usart_state[st->usart].tx_end : HAL_TIME_NEVER;
+      if (st->next == HAL_TIME_NEVER) st->active = 0;
+      break;
+    }
+    us->DR = mem[(ch->CCR & DMA_CCR1_MINC) ? st->pos : 0];
+    UsartWrite(st->usart, (uint8_t)us->DR);
+    st->pos++;
+    ch->CNDTR--;
+    if (st->pos == st->count / 2) hal_dma1.ISR |= (DMA_ISR_GIF1 | DMA_ISR_HTIF1) << shift;
+    if (ch->CNDTR == 0) {
+      hal_dma1.ISR |= (DMA_ISR_GIF1 | DMA_ISR_TCIF1) << shift;
+      st->active = 0;
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+void DMA_DeInit(DMA_Channel_TypeDef* DMAy_Channelx)
+{
+  int c = DmaIndex(DMAy_Channelx);
+
+  DMAy_Channelx->CCR = 0;
+  DMAy_Channelx->CNDTR = 0;
+  DMAy_Channelx->CPAR = 0;
+  DMAy_Channelx->CMAR = 0;
+  hal_dma1.ISR &= ~(0x0Fu << (4 * (c - 1)));
+  dma_state[c].active = 0;
+}
+/*----------------------------------------------------------------------------*/
+void DMA_Init(DMA_Channel_TypeDef* DMAy_Channelx, DMA_InitTypeDef* DMA_InitStruct)
+{
+  uint32_t tmpreg = DMAy_Channelx->CCR & 0xFFFF800F;
+
+  tmpreg |= DMA_InitStruct->DMA_DIR | DMA_InitStruct->DMA_Mode |
+            DMA_InitStruct->DMA_PeripheralInc | DMA_InitStruct->DMA_MemoryInc |
+            DMA_InitStruct->DMA_PeripheralDataSize | DMA_InitStruct->DMA_MemoryDataSize |
+            DMA_InitStruct->DMA_Priority | DMA_InitStruct->DMA_M2M;
+  DMAy_Channelx->CCR = tmpreg;
+  DMAy_Channelx->CNDTR = DMA_InitStruct->DMA_BufferSize;
+  DMAy_Channelx->CPAR = DMA_InitStruct->DMA_PeripheralBaseAddr;
+  DMAy_Channelx->CMAR = DMA_InitStruct->DMA_MemoryBaseAddr;
+}
+/*----------------------------------------------------------------------------*/
+void DMA_StructInit(DMA_InitTypeDef* DMA_InitStruct)
+{
+  memset(DMA_InitStruct, 0, sizeof(*DMA_InitStruct));
+}
+/*----------------------------------------------------------------------------*/
+void DMA_Cmd(DMA_Channel_TypeDef* DMAy_Channelx, FunctionalState NewState)
+{
+  int c = DmaIndex(DMAy_Channelx);
+
+  if (NewState != DISABLE) {
+    if (!(DMAy_Channelx->CCR & DMA_CCR1_EN)) {
+      DMAy_Channelx->CCR |= DMA_CCR1_EN;
+      DmaStart(c);
+    }
+  }
+  else {
+    DMAy_Channelx->CCR &= ~(uint32_t)DMA_CCR1_EN;
+    dma_state[c].active = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void DMA_ITConfig(DMA_Channel_TypeDef* DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState)
+{
+  if (NewState != DISABLE) DMAy_Channelx->CCR |= DMA_IT;
+  else DMAy_Channelx->CCR &= ~DMA_IT;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef* DMAy_Channelx)
+{
+  return (uint16_t)DMAy_Channelx->CNDTR;
+}
+/*----------------------------------------------------------------------------*/
+FlagStatus DMA_GetFlagStatus(uint32_t DMA_FLAG)
+{
+  return (hal_dma1.ISR & DMA_FLAG & 0x0FFFFFFF) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+/* Brisanje GIFx brise sve zastavice kanala, kao upis CGIFx u IFCR. */
+void DMA_ClearFlag(uint32_t DMA_FLAG)
+{
+  uint32_t clear = DMA_FLAG & 0x0FFFFFFF, c;
+
+  for (c = 0; c < 7; c++) {
+    if (clear & (DMA_ISR_GIF1 << (4 * c))) clear |= 0x0Fu << (4 * c);
+  }
+  hal_dma1.ISR &= ~clear;
+}
+/*----------------------------------------------------------------------------*/
+ITStatus DMA_GetITStatus(uint32_t DMA_IT)
+{
+  return (hal_dma1.ISR & DMA_IT & 0x0FFFFFFF) ? SET : RESET;
+}
+/*----------------------------------------------------------------------------*/
+void DMA_ClearITPendingBit(uint32_t DMA_IT)
+{
+  DMA_ClearFlag(DMA_IT);
+}
+
+/******************************************************************************/
+/*                         Veza sa jezgrom (hal_core.c)                       */
+/******************************************************************************/
+
+void HalPeriphSync(uint64_t now)
+{
+  unsigned k;
+
+  for (k = 0; k < sizeof(tim_list); k++) {
+    int i = tim_list[k];
+    TimState *st = &tim_state[i];
+
+    if (!(hal_tim[i].CR1 & TIM_CR1_CEN)) st->running = 0;
+    else if (!st->running) {
+      st->running = 1;
+      st->next_tick = now + st->psc + 1;
+    }
+    else if (st->next_tick == HAL_TIME_NEVER && hal_tim[i].ARR != 0) st->next_tick = now + st->psc + 1;
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint64_t HalPeriphNext(uint64_t now)
+{
+  uint64_t t = HAL_TIME_NEVER, d;
+  unsigned k;
+  int i;
+
+  (void)now;
+  for (k = 0; k < sizeof(tim_list); k++) {
+    d = TimNext(tim_list[k]);
+    if (d < t) t = d;
+  }
+  for (i = 1; i < HAL_USART_NUM; i++) {
+    if (usart_state[i].active && usart_state[i].tx_end < t) t = usart_state[i].tx_end;
+  }
+  for (i = 1; i < HAL_DMA_CHANNEL_NUM; i++) {
+    if (dma_state[i].active && dma_state[i].next < t) t = dma_state[i].next;
+  }
+  return t;
+}
+/*----------------------------------------------------------------------------*/
+void HalPeriphAdvance(uint64_t t)
+{
+  unsigned k;
+  int i;
+
+  for (k = 0; k < sizeof(tim_list); k++) TimAdvance(tim_list[k], t);
+  for (i = 1; i < HAL_USART_NUM; i++) UsartAdvance(i, t);
+  for (i = 1; i < HAL_DMA_CHANNEL_NUM; i++) DmaAdvance(i, t);
+}
+/*----------------------------------------------------------------------------*/
+static int TimAsserted(int i, uint16_t mask)
+{
+  return (hal_tim[i].SR & hal_tim[i].DIER & mask) != 0;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Prekidne linije periferija, bit po IRQn. Racunaju se samo linije
+  *         iz maske enabled, da bi pretraga u HalDispatch() posle svakog
+  *         prekida bila jedan prolaz kroz registre umesto poziva po liniji.
+  * @param  enabled: maska IRQn koje zanimaju pozivaoca (npr. NVIC->ISER).
+  * @retval Maska IRQn cija je linija aktivna.
+  */
+uint64_t HalPeriphAssertedMask(uint64_t enabled)
+{
+  uint32_t exti = hal_exti.PR & hal_exti.IMR;
+  uint64_t m = (uint64_t)(exti & 0x1F) << EXTI0_IRQn;
+  int c;
+
+  if (exti & 0x03E0) m |= HAL_IRQ_BIT(EXTI9_5_IRQn);
+  if (exti & 0xFC00) m |= HAL_IRQ_BIT(EXTI15_10_IRQn);
+  if (hal_dma1.ISR) {
+    for (c = 1; c < HAL_DMA_CHANNEL_NUM; c++)
+      if ((hal_dma1.ISR >> (4 * (c - 1))) & hal_dma1_channel[c].CCR & 0x0E)
+        m |= HAL_IRQ_BIT(DMA1_Channel1_IRQn + c - 1);
+  }
+#define TIM_LINE(irqn, cond) \
+  if ((enabled & HAL_IRQ_BIT(irqn)) && (cond)) m |= HAL_IRQ_BIT(irqn)
+  TIM_LINE(TIM1_BRK_TIM15_IRQn, TimAsserted(15, 0xFF) || TimAsserted(1, TIM_SR_BIF));
+  TIM_LINE(TIM1_UP_TIM16_IRQn, TimAsserted(16, 0xFF) || TimAsserted(1, TIM_SR_UIF));
+  TIM_LINE(TIM1_TRG_COM_TIM17_IRQn, TimAsserted(17, 0xFF) || TimAsserted(1, TIM_SR_TIF | TIM_SR_COMIF));
+  TIM_LINE(TIM1_CC_IRQn, TimAsserted(1, TIM_SR_CC_ALL));
+  TIM_LINE(TIM2_IRQn, TimAsserted(2, 0xFF));
+  TIM_LINE(TIM3_IRQn, TimAsserted(3, 0xFF));
+  TIM_LINE(TIM4_IRQn, TimAsserted(4, 0xFF));
+  TIM_LINE(TIM6_DAC_IRQn, TimAsserted(6, 0xFF));
+  TIM_LINE(TIM7_IRQn, TimAsserted(7, 0xFF));
+  TIM_LINE(USART1_IRQn, UsartAsserted(1));
+  TIM_LINE(USART2_IRQn, UsartAsserted(2));
+  TIM_LINE(USART3_IRQn, UsartAsserted(3));
+#undef TIM_LINE
+  return m & enabled;
+}
+/*----------------------------------------------------------------------------*/
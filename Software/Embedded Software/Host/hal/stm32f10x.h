@@ -0,0 +1,101 @@
+/**
+*   @file:    stm32f10x.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Omotac pravog stm32f10x.h za host build ploce kretanja. Tipovi,
+*             bitovi i IRQn su iz pravog zaglavlja, a makroi periferija
+*             (TIM1, GPIOA, USART3, ...) se preusmeravaju na promenljive iz
+*             hal_periph.c, pa su upisi kao TIM1->CCR1 ili TIM2->ARR obicni
+*             upisi u memoriju koje host program cita posle svakog prekida.
+*/
+
+#ifndef __HAL_STM32F10X_H__
+#define __HAL_STM32F10X_H__
+
+/* Pravo zaglavlje se ukljucuje putanjom, jer bi ga #include_next promasio
+   kada je ovaj fajl nadjen u direktorijumu fajla koji ga ukljucuje. */
+#include "../../Motion Board/Libraries/CMSIS/CM3/DeviceSupport/ST/STM32F10x/stm32f10x.h"
+#include "hal.h"
+
+#undef TIM1
+#undef TIM2
+#undef TIM3
+#undef TIM4
+#undef TIM6
+#undef TIM7
+#undef TIM15
+#undef TIM16
+#undef TIM17
+#undef USART1
+#undef USART2
+#undef USART3
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef AFIO
+#undef EXTI
+#undef ADC1
+#undef DMA1
+#undef DMA1_Channel1
+#undef DMA1_Channel2
+#undef DMA1_Channel3
+#undef DMA1_Channel4
+#undef DMA1_Channel5
+#undef DMA1_Channel6
+#undef DMA1_Channel7
+#undef RCC
+
+/* Instance periferija, indeks je broj periferije (0 se ne koristi). */
+extern TIM_TypeDef hal_tim[HAL_TIM_NUM];
+extern USART_TypeDef hal_usart[HAL_USART_NUM];
+extern GPIO_TypeDef hal_gpio[HAL_PORT_NUM];
+extern DMA_Channel_TypeDef hal_dma1_channel[HAL_DMA_CHANNEL_NUM];
+extern DMA_TypeDef hal_dma1;
+extern AFIO_TypeDef hal_afio;
+extern EXTI_TypeDef hal_exti;
+extern ADC_TypeDef hal_adc1;
+extern RCC_TypeDef hal_rcc;
+
+#define TIM1           (&hal_tim[1])
+#define TIM2           (&hal_tim[2])
+#define TIM3           (&hal_tim[3])
+#define TIM4           (&hal_tim[4])
+#define TIM6           (&hal_tim[6])
+#define TIM7           (&hal_tim[7])
+#define TIM15          (&hal_tim[15])
+#define TIM16          (&hal_tim[16])
+#define TIM17          (&hal_tim[17])
+#define USART1         (&hal_usart[1])
+#define USART2         (&hal_usart[2])
+#define USART3         (&hal_usart[3])
+#define GPIOA          (&hal_gpio[HAL_PORT_A])
+#define GPIOB          (&hal_gpio[HAL_PORT_B])
+#define GPIOC          (&hal_gpio[HAL_PORT_C])
+#define GPIOD          (&hal_gpio[HAL_PORT_D])
+#define GPIOE          (&hal_gpio[HAL_PORT_E])
+#define AFIO           (&hal_afio)
+#define EXTI           (&hal_exti)
+#define ADC1           (&hal_adc1)
+#define DMA1           (&hal_dma1)
+#define DMA1_Channel1  (&hal_dma1_channel[1])
+#define DMA1_Channel2  (&hal_dma1_channel[2])
+#define DMA1_Channel3  (&hal_dma1_channel[3])
+#define DMA1_Channel4  (&hal_dma1_channel[4])
+#define DMA1_Channel5  (&hal_dma1_channel[5])
+#define DMA1_Channel6  (&hal_dma1_channel[6])
+#define DMA1_Channel7  (&hal_dma1_channel[7])
+#define RCC            (&hal_rcc)
+
+/* IAR intrinsic koji main() koristi na kraju meca. */
+#define __disable_interrupt()  __disable_irq()
+
+/* Brojac ciklusa je virtuelno vreme (cycle_counter.h). */
+#define CYCLE_COUNTER_READ()   HalCycles()
+
+/* Glavna petlja ceka sledeci prekid umesto da se vrti (main_template.c). */
+#define MAIN_IDLE()            HalIdle()
+
+#endif
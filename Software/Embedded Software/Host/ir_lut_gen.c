@@ -0,0 +1,222 @@
+/**
+*   @file:    ir_lut_gen.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Generator tabele ir_lut.c glavne ploce iz merenja IR senzora.
+*             Cita linije oblika "cm30 = [1192, 1171, ...];" (kao u
+*             Misc/IR-senzor/ZavisnostIr.m), za svako rastojanje uzima
+*             zaokruzenu srednju vrednost ADC-a, pa karakteristiku cini
+*             monotonom: susedne tacke kod kojih ADC ne opada sa
+*             rastojanjem se spajaju (srednja vrednost ADC-a i rastojanja),
+*             uz upozorenje. Tabela ima ADC -> mm za svaki 2^shift-ti ADC
+*             kod od ADC-a najveceg rastojanja, izmedju tacaka linearno. Na kraju proverava da
+*             interpolacija iz irLookup() odstupa od izlomljene linije kroz
+*             tacke najvise za ispisanu gresku.
+*
+*             gcc -std=c99 -O2 -o ir_lut_gen ir_lut_gen.c
+*             ./ir_lut_gen -o "../Main Board/ir_lut.c" "../Misc/IR-senzor/ZavisnostIr.m"
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_POINTS  64
+
+typedef struct {
+  double mm;
+  double raw;
+  int count;                     // Broj spojenih rastojanja.
+} Point;
+
+static Point points[MAX_POINTS];
+static int num_points;
+
+static int parse(const char *path)
+{
+  char line[1024];
+  FILE *f = fopen(path, "r");
+
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    char *p = line, *end;
+    long cm, sum = 0;
+    int n = 0;
+
+    while (*p == ' ' || *p == '\t') p++;
+    if (strncmp(p, "cm", 2) != 0) continue;
+    cm = strtol(p + 2, &end, 10);
+    if (end == p + 2 || cm <= 0) continue;
+    p = strchr(end, '[');
+    if (p == NULL) continue;
+    p++;
+    for (;;) {
+      long v = strtol(p, &end, 10);
+      if (end == p) break;
+      sum += v;
+      n++;
+      p = end;
+      while (*p == ',' || *p == ' ' || *p == '\t') p++;
+    }
+    if (n == 0) continue;
+    if (num_points == MAX_POINTS) {
+      fprintf(stderr, "%s: vise od %d rastojanja\n", path, MAX_POINTS);
+      fclose(f);
+      return -1;
+    }
+    points[num_points].mm = cm * 10.0;
+    points[num_points].raw = (double)((sum + n / 2) / n);    // round(mean()) kao u .m fajlu.
+    points[num_points].count = 1;
+    num_points++;
+  }
+  fclose(f);
+  return 0;
+}
+
+static int cmp_mm(const void *a, const void *b)
+{
+  const Point *x = a, *y = b;
+  return x->mm < y->mm ? -1 : x->mm > y->mm;
+}
+
+/* Spaja susedne tacke dok ADC ne opada strogo sa rastojanjem. */
+static void make_monotonic(void)
+{
+  int i = 0;
+
+  while (i + 1 < num_points) {
+    Point *a = &points[i], *b = &points[i + 1];
+    if (b->raw < a->raw) {
+      i++;
+      continue;
+    }
+    fprintf(stderr, "upozorenje: %.0f mm (%.0f) i %.0f mm (%.0f) nisu monotoni, spajaju se\n", a->mm, a->raw,
+            b->mm, b->raw);
+    a->mm = (a->mm * a->count + b->mm * b->count) / (a->count + b->count);
+    a->raw = (a->raw * a->count + b->raw * b->count) / (a->count + b->count);
+    a->count += b->count;
+    memmove(b, b + 1, (num_points - i - 2) * sizeof(Point));
+    num_points--;
+    if (i > 0) i--;
+  }
+}
+
+/* Izlomljena linija kroz tacke, ADC -> mm, ogranicena na opseg merenja. */
+static double curve(double raw)
+{
+  int i;
+
+  if (raw >= points[0].raw) return points[0].mm;
+  if (raw <= points[num_points - 1].raw) return points[num_points - 1].mm;
+  for (i = 0; i + 1 < num_points; i++) {
+    const Point *a = &points[i], *b = &points[i + 1];
+    if (raw <= a->raw && raw >= b->raw) return a->mm + (b->mm - a->mm) * (a->raw - raw) / (a->raw - b->raw);
+  }
+  return points[num_points - 1].mm;
+}
+
+int main(int argc, char **argv)
+{
+  const char *out_path = NULL;
+  unsigned int shift = 4, size, i;
+  unsigned int *lut;
+  unsigned int raw_near, raw_far;
+  double max_err = 0.0;
+  int opt, err_raw = 0;
+  FILE *out = stdout;
+
+  while ((opt = getopt(argc, argv, "o:s:")) != -1) {
+    switch (opt) {
+      case 'o': out_path = optarg; break;
+      case 's': shift = (unsigned int)atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-o ir_lut.c] [-s shift] ZavisnostIr.m\n", argv[0]);
+        return 1;
+    }
+  }
+  if (optind >= argc || shift < 2 || shift > 8) {
+    fprintf(stderr, "usage: %s [-o ir_lut.c] [-s shift] ZavisnostIr.m\n", argv[0]);
+    return 1;
+  }
+  if (parse(argv[optind]) != 0) return 1;
+  if (num_points < 2) {
+    fprintf(stderr, "%s: potrebna su bar dva rastojanja\n", argv[optind]);
+    return 1;
+  }
+  qsort(points, num_points, sizeof(Point), cmp_mm);
+  make_monotonic();
+  if (num_points < 2) {
+    fprintf(stderr, "karakteristika nije monotona ni posle spajanja\n");
+    return 1;
+  }
+
+  /* Tabela pocinje od ADC-a najveceg rastojanja, a poslednja vrednost je
+     posle ADC-a najmanjeg, pa interpolacija nikad ne izlazi iz tabele. */
+  raw_near = (unsigned int)(points[0].raw + 0.5);
+  raw_far = (unsigned int)(points[num_points - 1].raw + 0.5);
+  size = ((raw_near - raw_far) >> shift) + 2;
+  lut = malloc(size * sizeof(unsigned int));
+  if (lut == NULL) return 1;
+  for (i = 0; i < size; i++) lut[i] = (unsigned int)(curve((double)(raw_far + (i << shift))) + 0.5);
+
+  /* Provera: ista racunica kao irLookup(). */
+  for (i = raw_far; i <= raw_near; i++) {
+    unsigned int k = (i - raw_far) >> shift, frac = (i - raw_far) & ((1u << shift) - 1);
+    int mm = (int)lut[k] + ((int)lut[k + 1] - (int)lut[k]) * (int)frac / (1 << shift);
+    double e = mm - curve(i);
+    if (e < 0) e = -e;
+    if (e > max_err) {
+      max_err = e;
+      err_raw = (int)i;
+    }
+  }
+
+  if (out_path) {
+    out = fopen(out_path, "w");
+    if (out == NULL) {
+      perror(out_path);
+      return 1;
+    }
+  }
+  fprintf(out, "/**\n");
+  fprintf(out, "*   @file:    ir_lut.c\n");
+  fprintf(out, "*   @author:  Cuvari plaze(Praetorian)\n");
+  fprintf(out, "*   @version: v1.00.181026 (Praetorian)\n");
+  fprintf(out, "*   @date:    18/10/2026\n");
+  fprintf(out, "*   @brief:   Inverzna karakteristika IR senzora, ADC -> mm. Generise\n");
+  fprintf(out, "*             Host/ir_lut_gen.c iz merenja, ne menjati rucno.\n");
+  fprintf(out, "*             Tacke (mm: ADC):");
+  for (i = 0; i < (unsigned int)num_points; i++) {
+    if (i % 5 == 0) fprintf(out, "\n*              ");
+    fprintf(out, " %.0f: %.0f%s", points[i].mm, points[i].raw, i + 1 < (unsigned int)num_points ? "," : "");
+  }
+  fprintf(out, "\n*             Najveca greska interpolacije %.1f mm (ADC %d).\n", max_err, err_raw);
+  fprintf(out, "*/\n\n");
+  fprintf(out, "#include \"ir_sensor.h\"\n\n");
+  fprintf(out, "#if IR_LUT_SHIFT != %u\n", shift);
+  fprintf(out, "#error \"ir_lut.c je generisan za IR_LUT_SHIFT %u\"\n", shift);
+  fprintf(out, "#endif\n\n");
+  fprintf(out, "const uint16_t ir_lut_raw_near = %u;\n", raw_near);
+  fprintf(out, "const uint16_t ir_lut_raw_far = %u;\n\n", raw_far);
+  fprintf(out, "const uint16_t ir_lut[ %u ] =\n{\n", size);
+  for (i = 0; i < size; i++) {
+    if (i % 12 == 0) fprintf(out, "  ");
+    fprintf(out, "%u%s", lut[i], i + 1 < size ? "," : "");
+    if (i % 12 == 11 || i + 1 == size) fprintf(out, "\n");
+    else fprintf(out, " ");
+  }
+  fprintf(out, "};\n");
+  if (out != stdout) fclose(out);
+
+  fprintf(stderr, "%d tacaka, %u vrednosti u tabeli, ADC %u..%u, najveca greska %.1f mm\n", num_points, size,
+          raw_far, raw_near, max_err);
+  free(lut);
+  return 0;
+}
@@ -0,0 +1,237 @@
+/**
+*   @file:    log_download.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Preuzimanje data_log-a sa ploce kretanja preko USB-RS485
+*             adaptera (komanda CMD_LOG_READ, 0xE8). Ploca salje log u
+*             frejmovima od po 64 podatka, svaki sa svojim offset-om. Delovi
+*             koji nisu stigli ili imaju losu checksum-u se traze ponovo, od
+*             prvog podatka koji nedostaje. Rezultat se upisuje u tekstualni
+*             fajl (indeks, vrednost), a na kraju se ispisuje trajanje i
+*             poredjenje sa citanjem podatak po podatak.
+*
+*             log_download [-b baud] [-o offset] [-n broj] [-f fajl] uredjaj
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MOTION_ADDR      0x0A
+#define REPLY_ADDR       (MOTION_ADDR | 0x40)
+#define CMD_LOG_READ     0xE8
+#define CHUNK_HEADER     5
+#define MAX_LOG          16384
+#define IDLE_TIMEOUT_MS  50
+#define MAX_RETRIES      20
+/* Stari nacin: zahtev sa indeksom (9 bajtova) i odgovor SendLogSingle (8 bajtova). */
+#define SINGLE_ROUND_TRIP_BYTES 17
+
+static int16_t log_data[MAX_LOG];
+static unsigned char have[MAX_LOG];
+static unsigned int total = 0;
+static unsigned long frames = 0, bad_frames = 0, rx_bytes = 0;
+
+static speed_t BaudConstant(long baud)
+{
+  switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    default:     return B115200;
+  }
+}
+
+static int OpenSerial(const char *path, long baud)
+{
+  struct termios tio;
+  int fd = open(path, O_RDWR | O_NOCTTY);
+
+  if (fd < 0) return -1;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, BaudConstant(baud));
+    cfsetospeed(&tio, BaudConstant(baud));
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+static double Now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Salje FF, adresa, duzina, 0xE8, offset i broj kao po cetiri nibl-a, checksum. */
+static int SendRequest(int fd, unsigned int offset, unsigned int count)
+{
+  unsigned char msg[14];
+  unsigned int i, n = 0, sum = 0;
+
+  msg[n++] = 0xFF;
+  msg[n++] = MOTION_ADDR;
+  msg[n++] = 10;
+  msg[n++] = CMD_LOG_READ;
+  for (i = 0; i < 4; i++) msg[n++] = (offset >> (4 * i)) & 0x0F;
+  for (i = 0; i < 4; i++) msg[n++] = (count >> (4 * i)) & 0x0F;
+  for (i = 1; i < n; i++) sum += msg[i];
+  msg[n++] = sum & 0x7F;
+  return write(fd, msg, n) == (ssize_t)n ? 0 : -1;
+}
+
+/* Raspakivanje jednog frejma (bez 0xFF), videti BuildLogChunk() u firmware-u. */
+static void DecodeChunk(const unsigned char *data, unsigned int len)
+{
+  unsigned int offset, count, i, n = CHUNK_HEADER;
+  unsigned long bits = 0;
+  int nbits = 0;
+
+  if (len < CHUNK_HEADER) return;
+  offset = data[0] | data[1] << 7;
+  count = data[2];
+  total = data[3] | data[4] << 7;
+  if (total > MAX_LOG) total = MAX_LOG;
+  for (i = 0; i < count && offset + i < total; i++) {
+    while (nbits < 16 && n < len) {
+      bits |= (unsigned long)data[n++] << nbits;
+      nbits += 7;
+    }
+    if (nbits < 16) break;
+    log_data[offset + i] = (int16_t)(bits & 0xFFFF);
+    have[offset + i] = 1;
+    bits >>= 16;
+    nbits -= 16;
+  }
+}
+
+/**
+ * @brief   Prima frejmove dok linija ne utihne IDLE_TIMEOUT_MS.
+ * @param   fd: serijski port.
+ * @retval  Broj ispravnih frejmova.
+ */
+static int ReceiveStream(int fd)
+{
+  unsigned char frame[260];
+  unsigned int pos = 0, len = 0;
+  int good = 0;
+  struct pollfd pfd = { fd, POLLIN, 0 };
+
+  while (poll(&pfd, 1, IDLE_TIMEOUT_MS) > 0) {
+    unsigned char buf[256];
+    ssize_t n = read(fd, buf, sizeof(buf)), k;
+    if (n <= 0) break;
+    rx_bytes += (unsigned long)n;
+    for (k = 0; k < n; k++) {
+      unsigned char b = buf[k];
+      if (b == 0xFF) {
+        pos = 0;
+        continue;
+      }
+      frame[pos++] = b;
+      if (pos == 2) len = b;
+      if (pos >= 2 && pos == len + 2) {
+        unsigned int i, sum = 0;
+        for (i = 0; i < pos - 1; i++) sum += frame[i];
+        if (frame[0] == REPLY_ADDR && (sum & 0x7F) == frame[pos - 1]) {
+          DecodeChunk(frame + 2, len - 1);
+          frames++;
+          good++;
+        }
+        else bad_frames++;
+        pos = 0;
+      }
+      if (pos >= sizeof(frame)) pos = 0;
+    }
+  }
+  return good;
+}
+
+static unsigned int FirstMissing(unsigned int from, unsigned int end)
+{
+  while (from < end && have[from]) from++;
+  return from;
+}
+
+int main(int argc, char **argv)
+{
+  long baud = 115200;
+  unsigned int offset = 0, count = 0, end, next, i;
+  const char *out_path = "data_log.txt";
+  int fd, opt, retries = 0, requests = 0;
+  double t0, elapsed, byte_s;
+  FILE *out;
+
+  while ((opt = getopt(argc, argv, "b:o:n:f:")) != -1) {
+    switch (opt) {
+      case 'b': baud = atol(optarg); break;
+      case 'o': offset = (unsigned int)atoi(optarg); break;
+      case 'n': count = (unsigned int)atoi(optarg); break;
+      case 'f': out_path = optarg; break;
+      default: optind = argc + 1; break;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "usage: %s [-b baud] [-o offset] [-n count] [-f file] device\n", argv[0]);
+    return 1;
+  }
+  fd = OpenSerial(argv[optind], baud);
+  if (fd < 0) {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  t0 = Now();
+  /* Prvi zahtev vraca i ukupnu duzinu log-a. */
+  end = count ? offset + count : MAX_LOG;
+  next = offset;
+  while (retries < MAX_RETRIES) {
+    SendRequest(fd, next, end - next > 0xFFFF ? 0xFFFF : end - next);
+    requests++;
+    ReceiveStream(fd);
+    if (total && end > total) end = total;
+    i = next;
+    next = FirstMissing(next, end);
+    if (next == i) retries++;
+    if (total && next >= end) break;
+  }
+  elapsed = Now() - t0;
+
+  if (total == 0) {
+    fprintf(stderr, "no reply from motion board\n");
+    return 1;
+  }
+  out = fopen(out_path, "w");
+  if (!out) {
+    perror(out_path);
+    return 1;
+  }
+  for (i = offset; i < end; i++) {
+    if (have[i]) fprintf(out, "%u %d\n", i, log_data[i]);
+  }
+  fclose(out);
+
+  byte_s = 10.0 / baud;
+  printf("%u/%u entries -> %s\n", FirstMissing(offset, end) - offset, end - offset, out_path);
+  printf("%d requests, %lu frames (%lu bad), %lu bytes in %.1f ms\n",
+         requests, frames, bad_frames, rx_bytes, elapsed * 1e3);
+  printf("line time: bulk %.1f ms, one entry per request %.1f ms (+ turnaround per request)\n",
+         rx_bytes * byte_s * 1e3, (end - offset) * SINGLE_ROUND_TRIP_BYTES * byte_s * 1e3);
+  close(fd);
+  return next >= end ? 0 : 2;
+}
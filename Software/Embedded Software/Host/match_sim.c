@@ -0,0 +1,211 @@
+/**
+*   @file:    match_sim.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Simulacija meca od 90 sekundi sa akcijama glavne misije
+*             (mission_actions.c) i planerom glavne ploce (planner.c).
+*             Trajanje akcije je ocekivano trajanje pomnozeno tempom meca
+*             (baterija, podloga) i sumom po akciji, plus cekanje kada
+*             protivnik blokira put. Poredi izvrsavanje redom do isteka
+*             vremena sa planerom: poeni (prekinuta akcija donosi partial),
+*             mecevi u kojima je akcija prekinuta krajem meca i vreme u kome
+*             robot stoji na kraju.
+*
+*             -l cita izmerena trajanja sa ranijih meceva (planner_measured_ms
+*             iz debugger-a, jedan mec po liniji, ms po akciji, 0 ako akcija
+*             nije izvrsena), racuna eksponencijalni prosek po akciji i
+*             ispisuje novu tabelu za mission_actions.c. Simulacija se onda
+*             radi sa novom tabelom.
+*
+*             gcc -std=c99 -O2 -I"../Main Board" -o match_sim match_sim.c "../Main Board/planner.c" "../Main Board/mission_actions.c" -lm
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "planner.h"
+#include "mission_actions.h"
+
+static const char *action_names[ ACTION_NUM ] = { "ACTION_CUBES", "ACTION_DOOR_1", "ACTION_DOOR_2", "ACTION_CENTER" };
+
+static PlannerActionType actions[ PLANNER_MAX_ACTIONS ];
+static unsigned int num_actions;
+
+/* Parametri modela trajanja. */
+static double pace_min = 0.85, pace_max = 1.35;
+static double noise_min = 0.90, noise_max = 1.15;
+static double block_prob = 0.25, block_mean_ms = 8000.0, block_max_ms = 25000.0;
+
+typedef struct {
+  long score;
+  long cut;
+  double idle_ms;
+} Result;
+
+static double uniform(double a, double b)
+{
+  return a + (b - a) * (rand() / (RAND_MAX + 1.0));
+}
+
+static double exponential(double mean)
+{
+  double u = uniform(0.0, 1.0);
+  return u > 0.0 ? -mean * log(1.0 - u) : 0.0;
+}
+
+/* Stvarna trajanja akcija za jedan mec. */
+static void draw_match(uint32_t *duration)
+{
+  double pace = uniform(pace_min, pace_max);
+  unsigned int i;
+
+  for (i = 0; i < num_actions; i++) {
+    double d = actions[i].expected_ms * pace * uniform(noise_min, noise_max);
+    if (uniform(0.0, 1.0) < block_prob) {
+      double block = exponential(block_mean_ms);
+      d += block > block_max_ms ? block_max_ms : block;
+    }
+    duration[i] = (uint32_t)d;
+  }
+}
+
+/* Akcije redom iz tabele dok ne istekne vreme. */
+static void run_fixed(const uint32_t *duration, Result *r)
+{
+  uint32_t t = 0;
+  unsigned int i;
+
+  for (i = 0; i < num_actions; i++) {
+    if (t + duration[i] > MATCH_DURATION_MS) {
+      r->score += actions[i].partial;
+      r->cut++;
+      return;
+    }
+    t += duration[i];
+    r->score += actions[i].score;
+  }
+  r->idle_ms += MATCH_DURATION_MS - t;
+}
+
+static void run_planner(const uint32_t *duration, Result *r)
+{
+  uint32_t t = 0;
+  int8_t a;
+
+  plannerStart(actions, (uint8_t)num_actions);
+  while ((a = plannerNext(t)) != PLANNER_NONE) {
+    if (t + duration[a] > MATCH_DURATION_MS) {
+      r->score += actions[a].partial;
+      r->cut++;
+      return;
+    }
+    t += duration[a];
+    r->score += actions[a].score;
+    plannerDone(a, duration[a]);
+  }
+  r->idle_ms += MATCH_DURATION_MS - t;
+}
+
+/* Eksponencijalni prosek izmerenih trajanja po akciji. */
+static int learn(const char *path, double alpha)
+{
+  double avg[PLANNER_MAX_ACTIONS] = { 0 };
+  unsigned int seen[PLANNER_MAX_ACTIONS] = { 0 };
+  char line[256];
+  unsigned int i, runs = 0;
+  FILE *f = fopen(path, "r");
+
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    char *p = line, *end;
+    if (line[0] == '#') continue;
+    for (i = 0; i < num_actions; i++) {
+      double ms = strtod(p, &end);
+      if (end == p) break;
+      p = end;
+      if (ms <= 0.0) continue;
+      avg[i] = seen[i] ? avg[i] + alpha * (ms - avg[i]) : ms;
+      seen[i]++;
+    }
+    if (i > 0) runs++;
+  }
+  fclose(f);
+
+  printf("mecevi iz %s: %u\n\n", path, runs);
+  printf("  /* score  partial  requires  expected_ms */\n");
+  for (i = 0; i < num_actions; i++) {
+    char score[8], partial[8], requires[8];
+    if (seen[i]) actions[i].expected_ms = avg[i] > 0xFFFF ? 0xFFFF : (uint16_t)(avg[i] + 0.5);
+    snprintf(score, sizeof(score), "%u,", actions[i].score);
+    snprintf(partial, sizeof(partial), "%u,", actions[i].partial);
+    snprintf(requires, sizeof(requires), "0x%02X,", actions[i].requires);
+    printf("  { %-7s %-8s %-9s %-5u }%s   // %s, %u merenja\n", score, partial, requires,
+           actions[i].expected_ms, i + 1 < num_actions ? "," : " ", action_names[i], seen[i]);
+  }
+  printf("\n");
+  return 0;
+}
+
+static void report(const char *name, const Result *r, long matches)
+{
+  printf("%-8s poeni %6.2f  prekinuta akcija %5.1f%%  stoji na kraju %5.1f s\n", name,
+         (double)r->score / matches, 100.0 * r->cut / matches,
+         (matches - r->cut) ? r->idle_ms / (matches - r->cut) / 1000.0 : 0.0);
+}
+
+int main(int argc, char **argv)
+{
+  long matches = 100000, m;
+  unsigned int seed = 1, i;
+  int opt, free_order = 0;
+  double alpha = 0.3;
+  const char *log_path = NULL;
+  uint32_t duration[PLANNER_MAX_ACTIONS];
+  Result fixed = { 0 }, planned = { 0 };
+
+  while ((opt = getopt(argc, argv, "n:s:l:a:p:b:f")) != -1) {
+    switch (opt) {
+      case 'n': matches = atol(optarg); break;
+      case 's': seed = (unsigned int)atoi(optarg); break;
+      case 'l': log_path = optarg; break;
+      case 'a': alpha = atof(optarg); break;
+      case 'p': pace_max = atof(optarg); break;
+      case 'b': block_prob = atof(optarg); break;
+      case 'f': free_order = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-n matches] [-s seed] [-l measured.txt] [-a alpha] "
+                "[-p max_pace] [-b block_prob] [-f]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (matches <= 0) matches = 1;
+
+  num_actions = mission_main_num_actions;
+  memcpy(actions, mission_main_actions, num_actions * sizeof(actions[0]));
+  if (log_path && learn(log_path, alpha) != 0) return 1;
+  /* Bez zavisnosti, kao da svaka akcija ima svoj prilaz. */
+  if (free_order)
+    for (i = 0; i < num_actions; i++) actions[i].requires = 0;
+
+  srand(seed);
+  for (m = 0; m < matches; m++) {
+    draw_match(duration);
+    run_fixed(duration, &fixed);
+    run_planner(duration, &planned);
+  }
+
+  printf("%ld meceva, tempo %.2f-%.2f, blokada %.0f%% po akciji (prosek %.1f s)%s\n", matches,
+         pace_min, pace_max, 100.0 * block_prob, block_mean_ms / 1000.0, free_order ? ", bez zavisnosti" : "");
+  report("redom", &fixed, matches);
+  report("planer", &planned, matches);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/**
+*   @file:    mission_time_sim.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Trajanje glavne misije (missions.c) u vremenskom modelu
+*             interpretera iz mission.c, serijski (svaki pokret se ceka do
+*             kraja, kao pre kanala iz actuator.h) i sa preklapanjem po
+*             zastavicama koraka (MS_WAIT, MS_AFTER_MOTION, MS_AFTER_SERVO).
+*
+*             Model: komanda sa acknowledge-om traje cmd ms, dolazak se vidi
+*             na prvoj proveri posle stvarnog dolaska (CHECK_ARRIVE svakih
+*             MOTION_POLL_MS, odgovor se cita na sledecoj proveri), brzina
+*             je obrnuto srazmerna preskaleru ploce kretanja (TIM2/TIM7 PSC).
+*             Komanda zadata dok se robot krece ceka jos BUS_REPLY_MS zbog
+*             odgovora na CHECK_ARRIVE.
+*
+*             Pokret servoa je korak MISSION_SERVO iz missions.c i traje
+*             svoj timeout; korak sa MS_AFTER_SERVO ga ceka, pa se vidi
+*             dobitak kada servo radi dok se robot okrece.
+*
+*             gcc -std=c99 -O2 -I"../Main Board" -I"../Main Board/Libraries/CMSIS/CM3/DeviceSupport/ST/STM32F10x" -o mission_time_sim mission_time_sim.c
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* missions.c se prevodi ovde, bez STM32 zaglavlja. */
+#define __STM32F10x_H
+typedef enum { FALSE = 0, TRUE = !FALSE } bool;
+#include "missions.c"
+
+#define BUS_REPLY_MS  5.0
+
+static double cmd_ms = 2.0;          // Komanda i acknowledge.
+static double speed_cm_s = 20.0;     // Pravolinijski, na preskaleru 1000.
+static double speed_deg_s = 90.0;    // Rotacija, na preskaleru 1000.
+
+typedef struct {
+  double total_ms;
+  double action_ms[PLANNER_MAX_ACTIONS];
+} Timing;
+
+static int is_motion(uint8_t c)
+{
+  return c == MOVE_FORWARD || c == MOVE_BACKWARD || c == ROTATE_LEFT || c == ROTATE_RIGHT;
+}
+
+/* Kada motionThread vidi dolazak za pokret zadat u trenutku start. */
+static double arrival_seen(double start, double duration)
+{
+  double polls = duration / MOTION_POLL_MS;
+  long k = (long)polls;
+  if (k < polls) k++;
+  return start + (k + 1) * MOTION_POLL_MS;
+}
+
+static double max2(double a, double b)
+{
+  return a > b ? a : b;
+}
+
+static void run(const MissionStepType *steps, int overlap, Timing *tm)
+{
+  double t = 0.0, motion_free = 0.0, motion_ready = 0.0, servo_free = 0.0, action_start = 0.0;
+  double speed = 1.0;
+  int action = -1;
+  const MissionStepType *s;
+
+  for (s = steps;; s++) {
+    if (s->command == MISSION_ACTION || s->command == MISSION_END) {
+      t = max2(t, max2(motion_ready, servo_free));
+      if (action >= 0) tm->action_ms[action] = t - action_start;
+      if (s->command == MISSION_END) break;
+      action = s->arg;
+      action_start = t;
+      continue;
+    }
+
+    uint8_t flags = s->flags;
+    /* Serijski: svaki pokret se ceka do kraja. */
+    if (!overlap && (is_motion(s->command) || s->command == MISSION_SERVO)) flags |= MS_WAIT;
+
+    if (flags & MS_AFTER_MOTION) t = max2(t, motion_free);
+    if (flags & MS_AFTER_SERVO) t = max2(t, servo_free);
+    double busy_bus = t < motion_free ? BUS_REPLY_MS : 0.0;
+    if (flags & MS_US_ON) t += cmd_ms + busy_bus;
+    if (flags & MS_US_OFF) t += cmd_ms + busy_bus;
+    if (flags & MS_WALL) t += cmd_ms + busy_bus;
+
+    if (s->command == MISSION_DELAY) {
+      t += s->arg;
+    } else if (s->command == MISSION_SERVO) {
+      t = max2(t, servo_free);
+      servo_free = t + s->timeout;
+      if (flags & MS_WAIT) t = servo_free;
+    } else if (is_motion(s->command)) {
+      double d;
+      t = max2(t, motion_ready) + cmd_ms;
+      if (s->command == ROTATE_LEFT || s->command == ROTATE_RIGHT) d = 1000.0 * s->arg / (speed_deg_s * speed);
+      else d = 1000.0 * s->arg / (speed_cm_s * speed);
+      motion_free = arrival_seen(t, d);
+      motion_ready = motion_free + ((flags & MS_SETTLE) ? MISSION_SETTLE_MS : 0);
+      if (flags & MS_WAIT) t = motion_ready;
+      continue;
+    } else {
+      t += cmd_ms + busy_bus;
+      if (s->command == PRESCALER) speed = 1000.0 / s->arg;
+    }
+    if (flags & MS_SETTLE) t += MISSION_SETTLE_MS;
+  }
+  tm->total_ms = t;
+}
+
+int main(int argc, char **argv)
+{
+  const MissionStepType *steps = mission_main_left;
+  static const char *names[ACTION_NUM] = { "ACTION_CUBES", "ACTION_DOOR_1", "ACTION_DOOR_2", "ACTION_CENTER" };
+  Timing serial = { 0 }, overlap = { 0 };
+  int opt, i;
+
+  while ((opt = getopt(argc, argv, "c:v:w:")) != -1) {
+    switch (opt) {
+      case 'c': cmd_ms = atof(optarg); break;
+      case 'v': speed_cm_s = atof(optarg); break;
+      case 'w': speed_deg_s = atof(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-c cmd_ms] [-v cm_per_s] [-w deg_per_s]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  run(steps, 0, &serial);
+  run(steps, 1, &overlap);
+
+  printf("komanda %.1f ms, %.0f cm/s, %.0f deg/s na preskaleru 1000\n\n", cmd_ms, speed_cm_s, speed_deg_s);
+  printf("%-14s %10s %10s %8s\n", "akcija", "serijski", "preklop.", "usteda");
+  for (i = 0; i < ACTION_NUM; i++)
+    printf("%-14s %8.0f ms %7.0f ms %6.0f ms\n", names[i], serial.action_ms[i], overlap.action_ms[i],
+           serial.action_ms[i] - overlap.action_ms[i]);
+  printf("%-14s %8.0f ms %7.0f ms %6.0f ms (%.1f%%)\n", "misija", serial.total_ms, overlap.total_ms,
+         serial.total_ms - overlap.total_ms, 100.0 * (serial.total_ms - overlap.total_ms) / serial.total_ms);
+  return 0;
+}
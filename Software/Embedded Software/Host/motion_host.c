@@ -0,0 +1,591 @@
+/**
+*   @file:    motion_host.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Firmware ploce kretanja preveden za Linux protiv host HAL-a
+*             (hal/). main() iz main_template.c se prevodi kao
+*             MotionBoardMain i izvrsava u virtuelnom vremenu od 24 MHz, sa
+*             prekidima po prioritetima iz NVIC-a. Komande glavne ploce
+*             dolaze iz skripte (-c) ili preko rs485_bus_pty (-l).
+*
+*             Skripta ima jednu komandu po liniji, "t_ms kod [data16 [id]]"
+*             (kod i podaci kao u command_table.h, # je komentar). Komanda se
+*             pakuje u poruku FF 0A size kod nibl-ovi chksum i salje bajt po
+*             bajt na USART3 brzinom linije.
+*
+*             -r upisuje CSV sa promenama TIM1->CCR1/CCR2 (PWM motora),
+*             TIM2->ARR i TIM7->ARR (koraci profila brzine) i pinova smera i
+*             DE pina, -d upisuje bajtove debug log-a sa USART2.
+*
+*             -p ukljucuje model robota (robot_plant.c) koji vraca ivice
+*             enkodera u EXTI prekide, pa se regulacija vrti u zatvorenoj
+*             petlji. -P ime=vrednost menja parametar modela (i ukljucuje ga),
+*             a trace tada ima i polozaj i brzinu robota.
+*
+*             -g ime=vrednost menja pojacanja regulatora (Kp, Ki, Kd za
+*             PID1/PID2, Kpc, Kic, Kdc za PID_continous) ili tabele profila
+*             brzine (acc i dec mnoze ubrzanje i usporenje, vmax ogranicava
+*             brzinu iz tabela). -m na kraju ispisuje red "metrics ..." sa
+*             vremenom smirivanja, preskokom i greskom pracenja po pokretu,
+*             koji cita gain_sweep.
+*
+*             Prevodi se sa CMakeLists.txt iz ovog direktorijuma.
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stm32f10x.h"
+#include "hal.h"
+#include "rs485_link.h"
+#include "robot_plant.h"
+#include "variables.h"
+
+#define ADDR_MOTION    0x0A
+#define TX_FRAME_MAX   64
+#define RAD_TO_DEG     57.29577951308232
+#define ACC_TABLE_LEN  100
+#define SPEED_TABLE_LEN 2000
+#define COUNTS_PER_MM  12.048        // LENGTH_CONST glavne ploce / 10.
+#define SETTLE_BAND    12            // Robot je smiren na +-1 mm od cilja.
+
+int MotionBoardMain(void);
+extern bool running;
+
+/* Bajtovi koji cekaju prijem na USART3. */
+typedef struct {
+  uint64_t t;
+  uint8_t byte;
+} RxByte;
+
+static RxByte *rx_queue;
+static size_t rx_head, rx_num, rx_cap;
+static uint64_t rx_free;            // Najraniji trenutak sledeceg bajta na liniji.
+static unsigned long rx_overruns;
+
+static int link_fd = -1;
+static uint64_t link_grant = HAL_TIME_NEVER;
+
+static FILE *trace_file;
+static FILE *debug_file;
+
+static uint8_t tx_frame[TX_FRAME_MAX];
+static int tx_frame_len;
+static uint64_t tx_frame_t;
+static unsigned long replies;
+
+/* Vrednosti iz poslednjeg reda trace-a. */
+static unsigned int trace_last[9];
+static int trace_started;
+
+static RobotPlant plant;
+static int plant_on;
+
+/* Pokret jedne ose (X: ENC1, Y: ENC2) za -m. */
+typedef struct {
+  int active;
+  int target, dir;
+  int ref_done;                     // Profil (trenutna_pozicija) je stigao do cilja.
+  uint64_t t_ref, t_out;            // Kraj profila i poslednji uzorak van SETTLE_BAND.
+  int overshoot;
+} AxisMove;
+
+static int metrics_on;
+static uint64_t metrics_next;
+static AxisMove axis_move[2];
+static unsigned long moves, unsettled, track_n;
+static double settle_sum, settle_max, track_sq, track_max, overshoot_max;
+
+/*----------------------------------------------------------------------------*/
+static void RxPush(uint64_t t, uint8_t byte)
+{
+  if (rx_num == rx_cap) {
+    size_t cap = rx_cap ? 2 * rx_cap : 256;
+    RxByte *q = realloc(rx_queue, cap * sizeof(RxByte));
+    if (q == NULL) {
+      fprintf(stderr, "motion_host: nema memorije za red prijema\n");
+      exit(1);
+    }
+    rx_queue = q;
+    rx_cap = cap;
+  }
+  if (rx_head > 0 && rx_head == rx_num) rx_head = rx_num = 0;
+  rx_queue[rx_num].t = t;
+  rx_queue[rx_num].byte = byte;
+  rx_num++;
+}
+
+static uint64_t RxNext(void *ctx)
+{
+  uint64_t t;
+
+  (void)ctx;
+  if (rx_head == rx_num) return HAL_TIME_NEVER;
+  t = rx_queue[rx_head].t;
+  return t > rx_free ? t : rx_free;
+}
+
+/* Jedan bajt po trajanju bajta, kao na liniji. */
+static void RxRun(void *ctx, uint64_t now)
+{
+  (void)ctx;
+  rx_overruns += HalUsartReceive(3, rx_queue[rx_head].byte);
+  rx_head++;
+  rx_free = now + HalUsartByteTime(3);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Poruka glavne ploce: FF, adresa, size, kod, nibl-ovi, chksum. size broji
+   kod, nibl-ove i checksum. */
+static void PushCommand(uint64_t t, const uint8_t *payload, int num)
+{
+  unsigned int chksum = ADDR_MOTION + (unsigned int)num + 1;
+  int i;
+
+  RxPush(t, 0xFF);
+  RxPush(t, ADDR_MOTION);
+  RxPush(t, (uint8_t)(num + 1));
+  for (i = 0; i < num; i++) {
+    RxPush(t, payload[i]);
+    chksum += payload[i];
+  }
+  RxPush(t, (uint8_t)(chksum & 0x7F));
+}
+
+static int LoadScript(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  char line[256];
+  int n = 0;
+
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    double t_ms;
+    unsigned int code, data, id;
+    uint8_t payload[8];
+    int k, fields, num = 1;
+
+    if (line[0] == '#') continue;
+    fields = sscanf(line, "%lf %i %i %i", &t_ms, &code, &data, &id);
+    if (fields < 2) continue;
+    payload[0] = (uint8_t)code;
+    if (fields >= 3) {
+      for (k = 0; k < 4; k++) payload[num++] = (uint8_t)((data >> (4 * k)) & 0xF);
+    }
+    if (fields >= 4) {
+      payload[num++] = (uint8_t)(id & 0xF);
+      payload[num++] = (uint8_t)((id >> 4) & 0xF);
+    }
+    PushCommand((uint64_t)(t_ms * (HAL_CPU_HZ / 1000)), payload, num);
+    n++;
+  }
+  fclose(f);
+  return n;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Veza sa rs485_bus_pty: firmware radi do granice kvanta, pa se sinhronizuje. */
+static void LinkRx(const Rs485LinkRecord *rec, void *ctx)
+{
+  (void)ctx;
+  /* Bajt je vec primljen na magistrali, prijem kasni najvise jedan kvant.
+     Zastavice greske se ne modeluju, bajt se predaje kakav je stigao. */
+  RxPush(HAL_FROM_NS(rec->t), rec->value);
+}
+
+static uint64_t LinkNext(void *ctx)
+{
+  (void)ctx;
+  return link_grant;
+}
+
+static void LinkRun(void *ctx, uint64_t now)
+{
+  uint64_t grant = Rs485LinkSync(link_fd, HAL_TO_NS(now), LinkRx, ctx);
+
+  if (grant == 0) {
+    link_grant = HAL_TIME_NEVER;
+    HalStop();
+    return;
+  }
+  link_grant = HAL_FROM_NS(grant);
+}
+
+static void LinkPin(void *ctx, int port, uint16_t changed, uint16_t level)
+{
+  (void)ctx;
+  if (port == HAL_PORT_C && (changed & GPIO_Pin_12))
+    Rs485LinkSend(link_fd, LINK_DE, (level & GPIO_Pin_12) != 0, HAL_TO_NS(HalNow()));
+}
+
+/*----------------------------------------------------------------------------*/
+static void FlushReply(void)
+{
+  int i;
+
+  if (tx_frame_len == 0) return;
+  printf("%10.3f ms  odgovor:", (double)tx_frame_t * 1000.0 / HAL_CPU_HZ);
+  for (i = 0; i < tx_frame_len; i++) printf(" %02X", tx_frame[i]);
+  printf("\n");
+  tx_frame_len = 0;
+  replies++;
+}
+
+static void Transmit(void *ctx, int usart, uint8_t byte, uint64_t t)
+{
+  (void)ctx;
+  if (usart == 2) {
+    if (debug_file) fputc(byte, debug_file);
+    return;
+  }
+  if (usart != 3) return;
+  if (link_fd >= 0) Rs485LinkSend(link_fd, LINK_TX, byte, HAL_TO_NS(t));
+  if (byte == 0xFF) {
+    FlushReply();
+    tx_frame_t = t;
+  }
+  if (tx_frame_len < TX_FRAME_MAX) tx_frame[tx_frame_len++] = byte;
+}
+
+/*----------------------------------------------------------------------------*/
+static void Trace(uint64_t now)
+{
+  unsigned int v[9];
+  int i;
+
+  v[0] = TIM1->CCR1;
+  v[1] = TIM1->CCR2;
+  v[2] = TIM2->ARR;
+  v[3] = TIM7->ARR;
+  v[4] = (unsigned int)HalGpioLevel(HAL_PORT_A, 4);
+  v[5] = (unsigned int)HalGpioLevel(HAL_PORT_A, 10);
+  v[6] = (unsigned int)HalGpioLevel(HAL_PORT_C, 8);
+  v[7] = (unsigned int)HalGpioLevel(HAL_PORT_C, 9);
+  v[8] = (unsigned int)HalGpioLevel(HAL_PORT_C, 12);
+  if (trace_started && memcmp(v, trace_last, sizeof(v)) == 0) return;
+  trace_started = 1;
+  memcpy(trace_last, v, sizeof(v));
+  fprintf(trace_file, "%.3f", (double)now * 1e6 / HAL_CPU_HZ);
+  for (i = 0; i < 9; i++) fprintf(trace_file, ",%u", v[i]);
+  fprintf(trace_file, ",%d,%d", ENC1, ENC2);
+  if (plant_on) {
+    RobotPlantState s;
+
+    RobotPlantGet(&plant, now, &s);
+    fprintf(trace_file, ",%.1f,%.1f,%.2f,%.1f", s.x * 1000, s.y * 1000, s.theta * RAD_TO_DEG, s.v * 1000);
+  }
+  fputc('\n', trace_file);
+}
+
+/*----------------------------------------------------------------------------*/
+static const struct {
+  const char *name;
+  float *gain;
+} gain_names[] = {
+  { "Kp", &Kp }, { "Ki", &Ki }, { "Kd", &Kd },
+  { "Kpc", &Kpc }, { "Kic", &Kic }, { "Kdc", &Kdc },
+};
+
+static double table_acc = 1.0, table_dec = 1.0;
+static int table_vmax = 255;
+
+static int SetGain(const char *assignment)
+{
+  const char *eq = strchr(assignment, '=');
+  size_t len;
+  unsigned int i;
+
+  if (eq == NULL) return -1;
+  len = (size_t)(eq - assignment);
+  for (i = 0; i < sizeof(gain_names) / sizeof(gain_names[0]); i++) {
+    if (strlen(gain_names[i].name) == len && strncmp(gain_names[i].name, assignment, len) == 0) {
+      *gain_names[i].gain = (float)atof(eq + 1);
+      return 0;
+    }
+  }
+  if (len == 3 && strncmp(assignment, "acc", 3) == 0) table_acc = atof(eq + 1);
+  else if (len == 3 && strncmp(assignment, "dec", 3) == 0) table_dec = atof(eq + 1);
+  else if (len == 4 && strncmp(assignment, "vmax", 4) == 0) table_vmax = atoi(eq + 1);
+  else return -1;
+  return table_acc > 0 && table_dec > 0 && table_vmax > 0 ? 0 : -1;
+}
+
+/* Tabele profila za ubrzanje k puta vece: brzina v se dostize na putu
+   acc_table[v] / k, a brzina na putu p je ona sa puta p * k. Isto za
+   usporenje i preostali put. */
+static void ScaleTables(void)
+{
+  unsigned int *acc = acc_table;
+  unsigned char *up = speed_table_acc, *down = speed_table_decc;
+  unsigned int acc0[ACC_TABLE_LEN];
+  unsigned char up0[SPEED_TABLE_LEN], down0[SPEED_TABLE_LEN];
+  int i;
+
+  if (table_acc == 1.0 && table_dec == 1.0 && table_vmax >= 255) return;
+  memcpy(acc0, acc, sizeof(acc0));
+  memcpy(up0, up, sizeof(up0));
+  memcpy(down0, down, sizeof(down0));
+  for (i = 0; i < ACC_TABLE_LEN; i++) acc[i] = (unsigned int)(acc0[i] / table_acc + 0.5);
+  for (i = 0; i < SPEED_TABLE_LEN; i++) {
+    double p = i * table_acc + 0.5, d = i * table_dec + 0.5;
+
+    up[i] = up0[p < SPEED_TABLE_LEN - 1 ? (int)p : SPEED_TABLE_LEN - 1];
+    down[i] = down0[d < SPEED_TABLE_LEN - 1 ? (int)d : SPEED_TABLE_LEN - 1];
+    if (up[i] > table_vmax) up[i] = (unsigned char)table_vmax;
+    if (down[i] > table_vmax) down[i] = (unsigned char)table_vmax;
+  }
+  for (i = 0; i < ACC_TABLE_LEN; i++)
+    if (acc[i] >= SPEED_TABLE_LEN) acc[i] = SPEED_TABLE_LEN - 1;
+}
+
+/*----------------------------------------------------------------------------*/
+static void FinishMove(AxisMove *m, uint64_t now)
+{
+  double settle;
+
+  if (!m->active) return;
+  if (m->overshoot > overshoot_max) overshoot_max = m->overshoot;
+  /* Profil nije zavrsio ili je osa jos van opsega na kraju pokreta. */
+  if (!m->ref_done || m->t_out + HAL_MS(1) >= now) {
+    unsettled++;
+    return;
+  }
+  settle = m->t_out > m->t_ref ? (double)(m->t_out - m->t_ref) * 1000.0 / HAL_CPU_HZ : 0.0;
+  settle_sum += settle;
+  if (settle > settle_max) settle_max = settle;
+}
+
+/* Uzorak ose svake 1 ms: novi cilj zapocinje pokret. Greska pracenja je
+   trenutna_pozicija - ENC dok se profil krece, preskok i smirivanje se mere
+   od kraja profila do sledeceg cilja. */
+static void SampleAxis(int axis, uint64_t now)
+{
+  AxisMove *m = &axis_move[axis];
+  int target = axis ? zadata_pozicija_Y : zadata_pozicija_X;
+  int ref = axis ? trenutna_pozicija_Y : trenutna_pozicija_X;
+  int enc = axis ? ENC2 : ENC1;
+  int err;
+
+  if (target != m->target) {
+    FinishMove(m, now);
+    m->active = m->target != 0;
+    m->dir = target > m->target ? 1 : -1;
+    m->target = target;
+    m->ref_done = 0;
+    m->overshoot = 0;
+    m->t_out = now;
+    if (m->active) moves++;
+  }
+  if (!m->active) return;
+  if (!m->ref_done) {
+    err = ref - enc;
+    track_sq += (double)err * err;
+    track_n++;
+    if (abs(err) > track_max) track_max = abs(err);
+    if (ref == target) {
+      m->ref_done = 1;
+      m->t_ref = now;
+    }
+  }
+  if (m->ref_done) {
+    if (m->dir * (enc - target) > m->overshoot) m->overshoot = m->dir * (enc - target);
+    if (abs(enc - target) > SETTLE_BAND) m->t_out = now;
+  }
+}
+
+static void PrintMetrics(uint64_t end)
+{
+  unsigned long settled;
+
+  FinishMove(&axis_move[0], end);
+  FinishMove(&axis_move[1], end);
+  settled = moves - unsettled;
+  printf("metrics moves=%lu unsettled=%lu settle_ms=%.1f settle_max_ms=%.1f overshoot_mm=%.2f "
+         "track_rms_mm=%.2f track_max_mm=%.2f final_mm=%.2f\n",
+         moves, unsettled, settled ? settle_sum / settled : 0.0, settle_max, overshoot_max / COUNTS_PER_MM,
+         track_n ? sqrt(track_sq / track_n) / COUNTS_PER_MM : 0.0, track_max / COUNTS_PER_MM,
+         (abs(ENC1 - zadata_pozicija_X) + abs(ENC2 - zadata_pozicija_Y)) / COUNTS_PER_MM);
+}
+
+/* Model prvo preuzima nove ulaze, pa trace i metrike vide stanje posle
+   prekida. */
+static void Step(void *ctx, uint64_t now)
+{
+  (void)ctx;
+  if (plant_on) RobotPlantSync(&plant, now);
+  if (trace_file) Trace(now);
+  if (metrics_on && now >= metrics_next) {
+    SampleAxis(0, now);
+    SampleAxis(1, now);
+    metrics_next = now + HAL_MS(1);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+static const struct {
+  const char *name;
+  int irqn;
+} irq_names[] = {
+  { "SysTick", -1 },
+  { "EXTI2", EXTI2_IRQn },
+  { "EXTI9_5", EXTI9_5_IRQn },
+  { "EXTI15_10", EXTI15_10_IRQn },
+  { "DMA1_Channel7", DMA1_Channel7_IRQn },
+  { "TIM1_BRK_TIM15", TIM1_BRK_TIM15_IRQn },
+  { "TIM2", TIM2_IRQn },
+  { "TIM3", TIM3_IRQn },
+  { "TIM4", TIM4_IRQn },
+  { "TIM6_DAC", TIM6_DAC_IRQn },
+  { "TIM7", TIM7_IRQn },
+  { "USART3", USART3_IRQn },
+};
+
+static void PrintSummary(uint64_t end, double wall)
+{
+  double virt = (double)end / HAL_CPU_HZ;
+  unsigned int i;
+
+  FlushReply();
+  printf("\nvirtuelno %.3f s, realno %.3f s (x%.1f)\n", virt, wall, wall > 0 ? virt / wall : 0.0);
+  printf("%-16s %12s %10s\n", "prekid", "ulazaka", "prioritet");
+  for (i = 0; i < sizeof(irq_names) / sizeof(irq_names[0]); i++) {
+    int irqn = irq_names[i].irqn;
+    unsigned int prio = irqn < 0 ? SCB->SHP[11] >> 4 : NVIC->IP[irqn] >> 4;
+    int enabled = irqn < 0 ? (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) != 0
+                           : (NVIC->ISER[irqn >> 5] >> (irqn & 0x1F)) & 1;
+
+    if (!enabled && HalIrqCount(irqn) == 0) continue;
+    printf("%-16s %12lu %10u\n", irq_names[i].name, HalIrqCount(irqn), prio);
+  }
+  printf("\nENC1 %d, ENC2 %d, zadata pozicija %d / %d, running %d\n", ENC1, ENC2, zadata_pozicija_X,
+         zadata_pozicija_Y, (int)running);
+  printf("odgovora %lu, izgubljenih bajtova na prijemu %lu\n", replies, rx_overruns);
+  if (plant_on) {
+    RobotPlantState s;
+
+    RobotPlantGet(&plant, end, &s);
+    printf("robot x %.1f mm, y %.1f mm, ugao %.2f deg, brzina %.1f mm/s, predjeno %.1f mm\n", s.x * 1000,
+           s.y * 1000, s.theta * RAD_TO_DEG, s.v * 1000, plant.distance * 1000);
+    printf("ivica enkodera %lu, proklizavanje %.3f / %.3f s, najveca struja %.2f A, baterija %.2f V\n",
+           plant.edges, (double)plant.slip_cycles[PLANT_LEFT] / HAL_CPU_HZ,
+           (double)plant.slip_cycles[PLANT_RIGHT] / HAL_CPU_HZ, plant.peak_current, s.v_battery);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+static double WallSeconds(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+  const char *script = NULL, *link = NULL, *trace = NULL, *debug = NULL;
+  double seconds = 95.0, wall;
+  HalDevice rx_dev, link_dev;
+  RobotPlantParams plant_par;
+  uint64_t end;
+  int opt;
+
+  RobotPlantDefaults(&plant_par);
+  while ((opt = getopt(argc, argv, "t:c:l:r:d:pP:g:m")) != -1) {
+    switch (opt) {
+      case 't': seconds = atof(optarg); break;
+      case 'c': script = optarg; break;
+      case 'l': link = optarg; break;
+      case 'r': trace = optarg; break;
+      case 'd': debug = optarg; break;
+      case 'p': plant_on = 1; break;
+      case 'P':
+        if (RobotPlantSet(&plant_par, optarg) < 0) {
+          fprintf(stderr, "motion_host: nepoznat parametar modela %s\n", optarg);
+          return 1;
+        }
+        plant_on = 1;
+        break;
+      case 'g':
+        if (SetGain(optarg) < 0) {
+          fprintf(stderr, "motion_host: nepoznato pojacanje ili parametar tabele %s\n", optarg);
+          return 1;
+        }
+        break;
+      case 'm': metrics_on = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-t sekundi] [-c skripta] [-l pty] [-r trace.csv] [-d debug.log] [-p] "
+                "[-P ime=vrednost] [-g ime=vrednost] [-m]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  HalReset();
+  if (script && LoadScript(script) < 0) return 1;
+
+  rx_dev.next = RxNext;
+  rx_dev.run = RxRun;
+  rx_dev.ctx = NULL;
+  HalAddDevice(&rx_dev);
+  HalSetTxHook(Transmit, NULL);
+
+  if (link) {
+    uint64_t byte_ns, grant;
+
+    link_fd = Rs485LinkOpen(link, &byte_ns);
+    if (link_fd < 0) {
+      perror(link);
+      return 1;
+    }
+    /* Prvi GRANT dolazi tek kada se svi cvorovi jave. */
+    grant = Rs485LinkSync(link_fd, 0, LinkRx, NULL);
+    if (grant == 0) return 1;
+    link_grant = HAL_FROM_NS(grant);
+    link_dev.next = LinkNext;
+    link_dev.run = LinkRun;
+    link_dev.ctx = NULL;
+    HalAddDevice(&link_dev);
+    HalSetPinHook(LinkPin, NULL);
+  }
+  if (trace) {
+    trace_file = fopen(trace, "w");
+    if (trace_file == NULL) {
+      perror(trace);
+      return 1;
+    }
+    fprintf(trace_file, "t_us,tim1_ccr1,tim1_ccr2,tim2_arr,tim7_arr,pa4,pa10,pc8,pc9,pc12,enc1,enc2%s\n",
+            plant_on ? ",x_mm,y_mm,theta_deg,v_mm_s" : "");
+  }
+  if (plant_on) RobotPlantInit(&plant, &plant_par);
+  if (trace_file || plant_on || metrics_on) HalSetStepHook(Step, NULL);
+  ScaleTables();
+  if (debug) {
+    debug_file = fopen(debug, "wb");
+    if (debug_file == NULL) {
+      perror(debug);
+      return 1;
+    }
+  }
+
+  wall = WallSeconds();
+  end = HalRun(MotionBoardMain, (uint64_t)(seconds * HAL_CPU_HZ));
+  wall = WallSeconds() - wall;
+  PrintSummary(end, wall);
+  if (metrics_on) PrintMetrics(end);
+
+  if (trace_file) fclose(trace_file);
+  if (debug_file) fclose(debug_file);
+  if (link_fd >= 0) close(link_fd);
+  free(rx_queue);
+  return 0;
+}
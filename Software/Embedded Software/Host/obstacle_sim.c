@@ -0,0 +1,277 @@
+/**
+*   @file:    obstacle_sim.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Trajanje misije od -n pravolinijskih pokreta sa protivnikom
+*             koji se pojavljuje ispred robota, sa ranijim zaustavljanjem na
+*             300 mm (stop, cekanje da se put oslobodi, polazak iz mesta) i
+*             sa zonama usporavanja iz obstacle_zone.c i brzinom
+*             priblizavanja iz range_rate.c. Isti scenariji se puste kroz oba
+*             nacina.
+*
+*             Model: korak 1 ms, zadatak prepreke svakih 10 ms. Brzina
+*             trajektorije raste sa -a mm/s^2 (tabela ubrzanja) i ogranicena
+*             je brzinom koja odgovara maximum_speed_X (perioda TIM2 je
+*             2 + 100 / brzina, -v je brzina za 60), a robot je prati sa
+*             najvecim usporenjem -d. Senzor daje rastojanje sa sumom svakih
+*             60 ms (US_MIN_CYCLE_TICKS, pri kretanju se okida samo grupa u
+*             smeru kretanja). Protivnik se pojavljuje na
+*             400..1500 mm, ceka ili prilazi do -o mm/s (do OPP_HALT_MM)
+*             i odlazi posle slucajnog vremena srednje vrednosti -s ms.
+*             Ispisuje srednje i najduze trajanje misije, broj stajanja,
+*             najmanje rastojanje, najmanje rastojanje dok nacin dozvoljava
+*             voznju (u voznji, za zone ne sme biti manje od OBST_STOP_MM),
+*             vreme na manje od CONTACT_MM, i trajanje istih pokreta bez
+*             protivnika.
+*
+*             gcc -std=c99 -O2 -I"../Motion Board" -o obstacle_sim obstacle_sim.c "../Motion Board/obstacle_zone.c" "../Motion Board/range_rate.c" -lm
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "obstacle_zone.h"
+#include "range_rate.h"
+
+#define NOMINAL_SPEED   60
+#define OLD_STOP_MM     300      // Ranije MAX_DISTANCE_MM.
+#define SENSOR_MS       60
+#define SENSOR_MAX_MM   2500
+#define NO_DATA         0xFFFF
+#define CONTACT_MM      30
+#define OPP_HALT_MM     100      // Protivnik ima svoje senzore i staje.
+#define MAX_MISSION_MS  600000
+
+static int segments = 20;
+static int runs = 200;
+static double v_nominal = 500.0;     // mm/s za maximum_speed 60.
+static double accel = 800.0;         // mm/s^2, tabela ubrzanja.
+static double decel = 2500.0;        // mm/s^2, najvece usporenje robota.
+static double opp_prob = 0.5;        // Verovatnoca protivnika po pokretu.
+static double opp_speed = 200.0;     // Najveca brzina prilazenja, mm/s.
+static double stay_ms = 1500.0;
+static double noise_mm = 10.0;
+
+typedef struct {
+  double length;                     // Duzina pokreta, mm.
+  int has_opp;
+  double appear_at;                  // Predjeni deo pokreta kada se pojavi, 0..1.
+  double gap0;                       // Rastojanje pri pojavljivanju.
+  double speed;                      // Brzina prilazenja.
+  double stay;                       // Koliko ostaje, ms.
+  unsigned int seed;                 // Sum senzora.
+} Segment;
+
+typedef struct {
+  double time_ms;
+  long stops;
+  long contacts;
+  double min_gap;
+  double min_gap_driving;            // Najmanje rastojanje dok nacin dozvoljava voznju.
+} Result;
+
+static double uniform(void)
+{
+  return rand() / (RAND_MAX + 1.0);
+}
+
+static double gauss(void)
+{
+  double u = uniform() + 1e-12, v = uniform();
+  return sqrt(-2.0 * log(u)) * cos(6.283185307 * v);
+}
+
+/* Brzina u mm/s za ogranicenje maximum_speed_X, perioda TIM2 je ARR + 1. */
+static double speed_of(int s)
+{
+  return v_nominal * (2.0 + 100.0 / NOMINAL_SPEED) / (2.0 + 100 / s);
+}
+
+static void make_segment(Segment *sg)
+{
+  sg->length = 300.0 + uniform() * 1200.0;
+  sg->has_opp = uniform() < opp_prob;
+  sg->appear_at = uniform() * 0.8;
+  sg->gap0 = 400.0 + uniform() * 1100.0;
+  sg->speed = uniform() < 0.5 ? 0.0 : uniform() * opp_speed;
+  sg->stay = -stay_ms * log(uniform() + 1e-12);
+  sg->seed = (unsigned int)rand();
+}
+
+/* Jedan pokret. zones = 0 ranije zaustavljanje, 1 zone usporavanja. */
+static double run_segment(const Segment *sg, int zones, Result *r)
+{
+  ObstacleZoneType z;
+  RangeRateType rr;
+  double pos = 0.0, v = 0.0, v_traj = 0.0, opp = 0.0, opp_left = 0.0, t = 0.0;
+  double last_pos = 0.0;
+  int opp_on = 0, opp_done = 0, hold = 0, limit = NOMINAL_SPEED;
+  unsigned int reading = NO_DATA;
+  long ms;
+
+  ObstacleZoneInit(&z, NOMINAL_SPEED);
+  RangeRateReset(&rr);
+  srand(sg->seed);
+
+  for (ms = 0; ms < MAX_MISSION_MS; ms++) {
+    double remaining = sg->length - pos, v_ref;
+
+    /* Protivnik. */
+    if (sg->has_opp && !opp_on && !opp_done && pos >= sg->appear_at * sg->length) {
+      opp_on = 1;
+      opp = pos + sg->gap0;
+      opp_left = sg->stay;
+    }
+    if (opp_on) {
+      if (opp - pos > OPP_HALT_MM) opp -= sg->speed * 0.001;
+      opp_left -= 1.0;
+      if (opp_left <= 0.0) {
+        opp_on = 0;
+        opp_done = 1;
+      }
+    }
+    if (opp_on) {
+      double gap = opp - pos;
+      if (gap < r->min_gap) r->min_gap = gap;
+      if (!hold && v > 0.0 && gap < r->min_gap_driving) r->min_gap_driving = gap;
+      if (gap <= CONTACT_MM) r->contacts++;
+    }
+
+    /* Senzor. */
+    if (ms % SENSOR_MS == 0) {
+      double d = opp_on ? opp - pos + noise_mm * gauss() : 1e9;
+      reading = (d > SENSOR_MAX_MM) ? NO_DATA : (unsigned int)(d < 0.0 ? 0.0 : d);
+      if (reading == NO_DATA) RangeRateReset(&rr);
+      else RangeRateUpdate(&rr, (uint16_t)reading, SENSOR_MS * 10);
+    }
+
+    /* Zadatak prepreke. */
+    if (ms % 10 == 0) {
+      if (zones) {
+        unsigned int speed = (unsigned int)((pos - last_pos) * 100.0);
+        limit = ObstacleZoneUpdate(&z, (uint16_t)reading, (uint16_t)speed,
+                                   reading == NO_DATA ? OBST_NO_RATE : RangeRateClosing(&rr),
+                                   (uint16_t)(remaining > 0.0 ? remaining : 0.0));
+        if (limit == 0) {
+          if (!hold) r->stops++;
+          if (!hold) v_traj = 0.0;    // Posle zaustavljanja krece iz pocetka tabele.
+          hold = 1;
+          limit = OBST_MIN_SPEED;
+        } else {
+          hold = 0;
+        }
+      } else {
+        if (!hold && reading <= OLD_STOP_MM) {
+          hold = 1;
+          r->stops++;
+          v_traj = 0.0;
+        } else if (hold && v == 0.0 && reading > OLD_STOP_MM) {
+          hold = 0;
+        }
+      }
+      last_pos = pos;
+    }
+
+    /* Trajektorija i robot. */
+    if (remaining <= 0.5 && v == 0.0) break;
+    if (hold) {
+      v_traj = 0.0;
+      v_ref = 0.0;
+    } else {
+      v_traj += accel * 0.001;
+      if (v_traj > v_nominal) v_traj = v_nominal;
+      if (v_traj > sqrt(2.0 * accel * (remaining > 0.0 ? remaining : 0.0)))
+        v_traj = sqrt(2.0 * accel * (remaining > 0.0 ? remaining : 0.0));
+      v_ref = v_traj < speed_of(limit) ? v_traj : speed_of(limit);
+    }
+    if (v_ref > v + accel * 0.001) v += accel * 0.001;
+    else if (v_ref < v - decel * 0.001) v -= decel * 0.001;
+    else v = v_ref;
+    if (v < 0.0) v = 0.0;
+    pos += v * 0.001;
+    if (pos > sg->length) {
+      pos = sg->length;
+      v = 0.0;
+    }
+    t += 1.0;
+  }
+  return t;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int seed = 1;
+  Result res[3];
+  double times[3][2000];
+  int opt, k, i, p;
+  Segment *sg;
+
+  while ((opt = getopt(argc, argv, "n:r:v:a:d:p:o:s:e:x:")) != -1) {
+    switch (opt) {
+      case 'n': segments = atoi(optarg); break;
+      case 'r': runs = atoi(optarg); break;
+      case 'v': v_nominal = atof(optarg); break;
+      case 'a': accel = atof(optarg); break;
+      case 'd': decel = atof(optarg); break;
+      case 'p': opp_prob = atof(optarg); break;
+      case 'o': opp_speed = atof(optarg); break;
+      case 's': stay_ms = atof(optarg); break;
+      case 'e': noise_mm = atof(optarg); break;
+      case 'x': seed = (unsigned int)atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-n segments] [-r runs] [-v mm_s] [-a accel] [-d decel] [-p opp_prob] "
+                "[-o opp_mm_s] [-s stay_ms] [-e noise_mm] [-x seed]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (runs > 2000) runs = 2000;
+  if (segments < 1 || runs < 1) return 1;
+
+  sg = malloc(segments * sizeof(Segment));
+  if (sg == NULL) return 1;
+  memset(res, 0, sizeof(res));
+  for (p = 0; p < 3; p++) res[p].min_gap = res[p].min_gap_driving = 1e9;
+
+  srand(seed);
+  for (k = 0; k < runs; k++) {
+    unsigned int next = (unsigned int)rand();
+    for (i = 0; i < segments; i++) {
+      srand(next + i);
+      make_segment(&sg[i]);
+    }
+    for (p = 0; p < 3; p++) {
+      double t = 0.0;
+      for (i = 0; i < segments; i++) {
+        Segment free_path = sg[i];
+        free_path.has_opp = 0;
+        t += run_segment(p == 2 ? &free_path : &sg[i], p == 1, &res[p]);
+      }
+      times[p][k] = t;
+      res[p].time_ms += t;
+    }
+    srand(next);
+  }
+
+  printf("%d misija od %d pokreta, %.0f mm/s, ubrzanje %.0f, usporenje %.0f mm/s^2, protivnik %.0f%%, "
+         "do %.0f mm/s, ostaje %.0f ms\n\n", runs, segments, v_nominal, accel, decel, 100.0 * opp_prob, opp_speed,
+         stay_ms);
+  printf("%-16s %12s %12s %12s %14s %14s %12s\n", "", "misija [s]", "najduza [s]", "stajanja", "min. raz. [mm]",
+         "u voznji [mm]", "dodiri [ms]");
+  for (p = 0; p < 3; p++) {
+    static const char *names[] = { "stop na 300 mm", "zone usporavanja", "bez protivnika" };
+    double worst = 0.0;
+    for (k = 0; k < runs; k++)
+      if (times[p][k] > worst) worst = times[p][k];
+    printf("%-16s %12.2f %12.2f %12.2f %14.0f %14.0f %12.2f\n", names[p],
+           res[p].time_ms / runs / 1000.0, worst / 1000.0, (double)res[p].stops / runs,
+           p == 2 ? 0.0 : res[p].min_gap, p == 2 ? 0.0 : res[p].min_gap_driving, (double)res[p].contacts / runs);
+  }
+  free(sg);
+  return 0;
+}
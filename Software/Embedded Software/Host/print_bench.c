@@ -0,0 +1,203 @@
+/**
+*   @file:    print_bench.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Poredjenje brzine formatiranja celih brojeva u print.c ploce
+*             kretanja sa ranijim verzijama: cifre preko mod()/div() sa
+*             oduzimanjem u petlji i preko dva deljenja po cifri (% i /).
+*             Proverava i da %d/%u/%x, itoa i ftoa daju isto sto i libc.
+*             Brojevi su relativni, na STM32F100 (UDIV 2-12 ciklusa, UMULL
+*             3-5 ciklusa) razlika izmedju deljenja i mnozenja je veca nego
+*             na PC-ju.
+*
+*             gcc -std=gnu99 -O2 -I"../Motion Board" -o print_bench print_bench.c -lm
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdarg.h>
+
+/* print.c se prevodi u ovom fajlu, sa preimenovanim funkcijama da se ne
+   sudare sa libc-om, i bez UartDebug.h koji vuce STM32 zaglavlja. */
+#define _UART_DEBUG_H_
+#define printf  mb_printf
+#define sprintf mb_sprintf
+#define putc    mb_putc
+#define getc    mb_getc
+#define itoa    mb_itoa
+#define ftoa    mb_ftoa
+static void UsartPut(unsigned char ch) { (void)ch; }
+static char UsartGet(void) { return 0; }
+#include "print.c"
+#undef printf
+#undef sprintf
+#undef putc
+#undef getc
+#undef itoa
+#undef ftoa
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_VALUES 4096
+#define ROUNDS     200
+
+static int values[NUM_VALUES];
+static volatile unsigned int sink;
+/* U printi() je osnova bila argument, pa je kompajler morao da deli. */
+static volatile unsigned int base = 10;
+
+/* mod() i div() iz ranije verzije print.c. */
+static int old_mod(int a, int b)
+{
+  while (a >= b) a = a - b;
+  return a;
+}
+
+static int old_div(int a, int b)
+{
+  unsigned int result = 0;
+  while (a >= b) {
+    a = a - b;
+    result++;
+  }
+  return result;
+}
+
+/* Petlja iz ranijeg printi() za osnovu 10, sa izborom nacina deljenja. */
+static char *OldFormat(int i, char *buf, int subtract)
+{
+  char *s = buf + PRINT_BUF_LEN - 1;
+  unsigned int u = i;
+  int neg = 0;
+
+  *s = '\0';
+  if (i == 0) *--s = '0';
+  if (i < 0) {
+    neg = 1;
+    u = -i;
+  }
+  while (u) {
+    if (subtract) {
+      /* mod/div rade sa int-om, kao u originalu. */
+      *--s = old_mod((int)u, 10) + '0';
+      u = old_div((int)u, 10);
+    }
+    else {
+      unsigned int b = base;
+      *--s = u % b + '0';
+      u /= b;
+    }
+  }
+  if (neg) *--s = '-';
+  return s;
+}
+
+static double Now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void FillValues(int range)
+{
+  unsigned int x = 12345, i;
+
+  for (i = 0; i < NUM_VALUES; i++) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    values[i] = range ? (int)(x % (2u * range + 1)) - range : (int)x;
+  }
+}
+
+/* Vraca ns po broju. */
+static double Bench(int method, int rounds)
+{
+  char buf[32];
+  double t0 = Now();
+  int r, i;
+
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < NUM_VALUES; i++) {
+      switch (method) {
+        case 0: sink += (unsigned char)*OldFormat(values[i], buf, 1); break;
+        case 1: sink += (unsigned char)*OldFormat(values[i], buf, 0); break;
+        case 2: mb_sprintf(buf, "%d", values[i]); sink += (unsigned char)buf[0]; break;
+        case 3: sink += (unsigned char)*format_dec((unsigned int)values[i], buf + PRINT_BUF_LEN - 1); break;
+        case 4: sink += (unsigned char)*mb_itoa((unsigned int)values[i], buf); break;
+      }
+    }
+  }
+  return (Now() - t0) * 1e9 / ((double)rounds * NUM_VALUES);
+}
+
+static int Check(void)
+{
+  char a[64], b[64];
+  int errors = 0, i, d;
+
+  FillValues(0);
+  for (i = 0; i < NUM_VALUES; i++) {
+    int v = values[i];
+    mb_sprintf(a, "%d|%u|%x|%08X|%-6d|%05d", v, v, v, v, v % 1000, v % 1000);
+    snprintf(b, sizeof(b), "%d|%u|%x|%08X|%-6d|%05d", v, (unsigned)v, (unsigned)v, (unsigned)v, v % 1000, v % 1000);
+    if (strcmp(a, b)) {
+      if (errors++ < 5) printf("sprintf: '%s' != '%s'\n", a, b);
+    }
+    mb_itoa((unsigned int)v, a);
+    snprintf(b, sizeof(b), "%u", (unsigned)v);
+    if (strcmp(a, b)) {
+      if (errors++ < 5) printf("itoa: '%s' != '%s'\n", a, b);
+    }
+    for (d = 0; d <= 4; d++) {
+      float f = (float)v / (float)(1 << (v & 15)) / 1000.0f;
+      double expected;
+      if (fabs(f) * pow(10, d) >= 4294967296.0) continue;
+      mb_ftoa(f, a, d);
+      /* ftoa zaokruzuje float proizvod, pa se poredi numericki. */
+      expected = (float)(fabsf(f) * (float)pow(10, d));
+      if (fabs(fabs(atof(a)) * pow(10, d) - floor(expected + 0.5)) > 0.5 + expected * 1e-7) {
+        if (errors++ < 5) printf("ftoa(%g, %d): '%s'\n", f, d, a);
+      }
+    }
+  }
+  mb_ftoa(-0.0004f, a, 3);
+  if (strcmp(a, "0.000")) {
+    errors++;
+    printf("ftoa(-0.0004, 3): '%s'\n", a);
+  }
+  return errors;
+}
+
+int main(void)
+{
+  static const char *names[] = {
+    "mod()/div() oduzimanjem", "% i / po cifri", "sprintf %d (novo)", "format_dec (novo)", "itoa (novo)"
+  };
+  static const int ranges[] = { 32767, 0 };
+  static const char *range_names[] = { "enkoder +-32767", "ceo int opseg" };
+  int errors = Check(), m, r;
+
+  printf("provera formata: %s\n", errors ? "GRESKA" : "ok");
+  for (r = 0; r < 2; r++) {
+    printf("\n%s:\n", range_names[r]);
+    FillValues(ranges[r]);
+    for (m = 0; m < 5; m++) {
+      /* Oduzimanje je sporo: dva kruga za enkoder, ceo int opseg se preskace. */
+      int rounds = m == 0 ? (r == 0 ? 2 : 0) : ROUNDS;
+      if (rounds == 0) {
+        printf("  %-26s  (preskoceno, do 2e8 iteracija za prvu cifru)\n", names[m]);
+        continue;
+      }
+      printf("  %-26s %10.1f ns/broj\n", names[m], Bench(m, rounds));
+    }
+  }
+  return errors ? 1 : 0;
+}
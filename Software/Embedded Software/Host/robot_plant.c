@@ -0,0 +1,409 @@
+/**
+*   @file:    robot_plant.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Model robota za motion_host, opis je u robot_plant.h.
+*
+*             H most: pin "napred" na 1 i "nazad" na 0 daje +Vbat dok je PWM
+*             izlaz aktivan, obrnuto -Vbat, a oba pina na istom nivou i
+*             neaktivan PWM izlaz kratko spajaju motor (kocenje). Srednji
+*             napon motora je zato smer * duty * Vbat. Baterija pada za
+*             r_battery * struja iz baterije.
+*
+*             Struja motora se racuna tacno (eksponencijalno) za korak, uz
+*             kontra EMS sa pocetka koraka, pa korak moze biti veci od L/R.
+*             Tocak koji se kotrlja je vezan za telo robota; kada sila na
+*             podlogu predje mu_static * N tocak proklizava sa silom
+*             mu_kinetic * N dok se brzine tocka i podloge ne izjednace.
+*
+*             Razmera: glavna ploca salje put sa LENGTH_CONST = 120.48
+*             impulsa/cm (Main Board/Communication.c), a WHEEL_RADIUS = 45 i
+*             WHEEL_BASE = 288 mm su samo u EUROBOT_Movement.c (uz Cm koji sa
+*             njima ne odgovara ovoj razmeri), pa su ovde prepisani kao
+*             podrazumevane vrednosti.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f10x.h"
+#include "robot_plant.h"
+
+#define GRAVITY         9.81
+#define SPEED_EPS       0.01        // [m/s], zaobljenje znaka za otpor kotrljanja.
+#define MOTOR_SPEED_EPS 1.0         // [rad/s], zaobljenje znaka za trenje motora.
+#define REST_SPEED      1.0e-5      // [m/s], ispod ovoga i bez napona robot miruje.
+#define REST_CURRENT    1.0e-4      // [A].
+
+/* Znak polozaja tocka: v_tocka = v + side * omega * baza / 2. */
+static const double side[2] = { -1.0, 1.0 };
+
+/*----------------------------------------------------------------------------*/
+void RobotPlantDefaults(RobotPlantParams *par)
+{
+  par->v_battery = 12.0;
+  par->r_battery = 0.15;
+  par->r_motor = 2.0;
+  par->l_motor = 1.0e-3;
+  par->k_motor = 0.012;
+  par->j_motor = 3.0e-6;
+  par->friction_motor = 0.004;
+  par->damping_motor = 1.0e-6;
+  par->gear_ratio = 50.0;
+  par->gear_efficiency = 0.8;
+  par->wheel_radius = 0.045;
+  par->wheel_base = 0.288;
+  par->counts_per_m = 12048.0;
+  par->mass = 5.0;
+  par->inertia = 0.08;
+  par->drive_load = 0.8;
+  par->mu_static = 0.9;
+  par->mu_kinetic = 0.7;
+  par->rolling = 0.02;
+  par->step_s = 0.001;
+}
+
+static const struct {
+  const char *name;
+  size_t offset;
+} param_names[] = {
+  { "vbat",       offsetof(RobotPlantParams, v_battery) },
+  { "rbat",       offsetof(RobotPlantParams, r_battery) },
+  { "rmotor",     offsetof(RobotPlantParams, r_motor) },
+  { "lmotor",     offsetof(RobotPlantParams, l_motor) },
+  { "kmotor",     offsetof(RobotPlantParams, k_motor) },
+  { "jmotor",     offsetof(RobotPlantParams, j_motor) },
+  { "friction",   offsetof(RobotPlantParams, friction_motor) },
+  { "damping",    offsetof(RobotPlantParams, damping_motor) },
+  { "gear",       offsetof(RobotPlantParams, gear_ratio) },
+  { "efficiency", offsetof(RobotPlantParams, gear_efficiency) },
+  { "radius",     offsetof(RobotPlantParams, wheel_radius) },
+  { "base",       offsetof(RobotPlantParams, wheel_base) },
+  { "counts",     offsetof(RobotPlantParams, counts_per_m) },
+  { "mass",       offsetof(RobotPlantParams, mass) },
+  { "inertia",    offsetof(RobotPlantParams, inertia) },
+  { "load",       offsetof(RobotPlantParams, drive_load) },
+  { "mus",        offsetof(RobotPlantParams, mu_static) },
+  { "muk",        offsetof(RobotPlantParams, mu_kinetic) },
+  { "rolling",    offsetof(RobotPlantParams, rolling) },
+  { "step",       offsetof(RobotPlantParams, step_s) },
+};
+
+int RobotPlantSet(RobotPlantParams *par, const char *assignment)
+{
+  const char *eq = strchr(assignment, '=');
+  unsigned int i;
+
+  if (eq == NULL) return -1;
+  for (i = 0; i < sizeof(param_names) / sizeof(param_names[0]); i++) {
+    if (strlen(param_names[i].name) == (size_t)(eq - assignment) &&
+        strncmp(param_names[i].name, assignment, eq - assignment) == 0) {
+      *(double *)((char *)par + param_names[i].offset) = atof(eq + 1);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Udeo periode u kome je izlaz kanala TIM1 aktivan (1 = PWM pin na 1). */
+static double PwmDuty(int channel)
+{
+  unsigned int shift = 4 * (channel - 1);
+  unsigned int mode = (channel == 1 ? TIM1->CCMR1 >> 4 : TIM1->CCMR1 >> 12) & 7;
+  double period = (double)TIM1->ARR + 1.0;
+  double ccr = TIM1->CCR1;
+  double duty;
+
+  if (channel == 2) ccr = TIM1->CCR2;
+  if (!(TIM1->CR1 & TIM_CR1_CEN) || !(TIM1->BDTR & TIM_BDTR_MOE) || !((TIM1->CCER >> shift) & 1)) return 0.0;
+  if (ccr > period) ccr = period;
+  switch (mode) {
+    case 4: duty = 0.0; break;                          // Force inactive.
+    case 5: duty = 1.0; break;                          // Force active.
+    case 6: duty = ccr / period; break;                 // PWM1: aktivan dok je CNT < CCR.
+    case 7: duty = 1.0 - ccr / period; break;           // PWM2: aktivan dok je CNT >= CCR.
+    default: return 0.0;
+  }
+  if ((TIM1->CCER >> (shift + 1)) & 1) duty = 1.0 - duty;
+  return duty;
+}
+
+/* Napon motora kao udeo napona baterije, -1..1. Vraca 0 ako se registri i
+   pinovi od kojih zavisi nisu promenili (poziva se posle svakog dogadjaja). */
+static int ReadDrive(RobotPlant *plant, double drive[2])
+{
+  uint32_t in[8];
+  int fwd1, rev1, fwd2, rev2;
+
+  fwd1 = HalGpioLevel(HAL_PORT_A, 10);
+  rev1 = HalGpioLevel(HAL_PORT_A, 4);
+  fwd2 = HalGpioLevel(HAL_PORT_C, 9);
+  rev2 = HalGpioLevel(HAL_PORT_C, 8);
+  in[0] = TIM1->CCR1;
+  in[1] = TIM1->CCR2;
+  in[2] = TIM1->CCMR1;
+  in[3] = TIM1->CCER;
+  in[4] = TIM1->ARR;
+  in[5] = TIM1->CR1 & TIM_CR1_CEN;
+  in[6] = TIM1->BDTR & TIM_BDTR_MOE;
+  in[7] = (uint32_t)(fwd1 | rev1 << 1 | fwd2 << 2 | rev2 << 3);
+  if (memcmp(in, plant->inputs, sizeof(in)) == 0) return 0;
+  memcpy(plant->inputs, in, sizeof(in));
+
+  drive[PLANT_LEFT] = (fwd1 - rev1) ? (fwd1 - rev1) * PwmDuty(2) : 0.0;
+  drive[PLANT_RIGHT] = (fwd2 - rev2) ? (fwd2 - rev2) * PwmDuty(1) : 0.0;
+  return 1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Jedan korak h od stanja a do stanja b sa ulazom plant->drive. */
+static void Integrate(RobotPlant *plant, const RobotPlantState *a, RobotPlantState *b, double h)
+{
+  const RobotPlantParams *p = &plant->par;
+  double r = p->wheel_radius, half = p->wheel_base / 2;
+  double c = p->j_motor * p->gear_ratio * p->gear_ratio / (r * r);
+  double normal = p->mass * GRAVITY * p->drive_load / 2;
+  double roll = p->rolling * p->mass * GRAVITY;
+  double tau_e = p->l_motor / p->r_motor, decay;
+  double vbat, torque[2], force[2], acc = 0, alpha = 0;
+  int k, iter;
+
+  if (h != plant->decay_h) {
+    plant->decay_h = h;
+    plant->decay = exp(-h / tau_e);
+  }
+  decay = plant->decay;
+  vbat = p->v_battery - p->r_battery * (fabs(a->current[0] * plant->drive[0]) + fabs(a->current[1] * plant->drive[1]));
+  if (vbat < 0) vbat = 0;
+  b->v_battery = vbat;
+
+  for (k = 0; k < 2; k++) {
+    double w_motor = a->wheel[k] * p->gear_ratio;
+    double i_end = (plant->drive[k] * vbat - p->k_motor * w_motor) / p->r_motor;
+    double i_avg = i_end + (a->current[k] - i_end) * (1 - decay) * tau_e / h;
+    double loss = p->friction_motor * w_motor / (fabs(w_motor) + MOTOR_SPEED_EPS) + p->damping_motor * w_motor;
+
+    b->current[k] = i_end + (a->current[k] - i_end) * decay;
+    torque[k] = p->gear_ratio * (p->gear_efficiency * p->k_motor * i_avg - loss);
+    if (fabs(b->current[k]) > plant->peak_current) plant->peak_current = fabs(b->current[k]);
+  }
+
+  /* Sile tockova na podlogu. Tocak koji se kotrlja ima ubrzanje tela, tocak
+     koji proklizava ima poznatu silu, pa je sistem 2x2 po (acc, alpha). */
+  for (iter = 0; iter < 3; iter++) {
+    double m11 = p->mass, m12 = 0, m22 = p->inertia, f1, f2, det;
+    int changed = 0;
+
+    f1 = -roll * a->v / (fabs(a->v) + SPEED_EPS);
+    f2 = -roll * half * a->omega * half / (fabs(a->omega * half) + SPEED_EPS);
+    for (k = 0; k < 2; k++) {
+      if (plant->slip[k]) {
+        double slip = a->wheel[k] * r - (a->v + side[k] * a->omega * half);
+        force[k] = p->mu_kinetic * normal * (slip > 0 ? 1 : (slip < 0 ? -1 : (torque[k] >= 0 ? 1 : -1)));
+        f1 += force[k];
+        f2 += side[k] * half * force[k];
+      }
+      else {
+        m11 += c;
+        m12 += c * side[k] * half;
+        m22 += c * half * half;
+        f1 += torque[k] / r;
+        f2 += side[k] * half * torque[k] / r;
+      }
+    }
+    det = m11 * m22 - m12 * m12;
+    acc = (f1 * m22 - f2 * m12) / det;
+    alpha = (m11 * f2 - m12 * f1) / det;
+    for (k = 0; k < 2; k++) {
+      if (plant->slip[k]) continue;
+      force[k] = torque[k] / r - c * (acc + side[k] * alpha * half);
+      if (fabs(force[k]) > p->mu_static * normal) {
+        plant->slip[k] = 1;
+        changed = 1;
+      }
+    }
+    if (!changed) break;
+  }
+
+  b->v = a->v + acc * h;
+  b->omega = a->omega + alpha * h;
+  for (k = 0; k < 2; k++) {
+    double ground = b->v + side[k] * b->omega * half;
+
+    if (plant->slip[k]) {
+      b->wheel[k] = a->wheel[k] + (torque[k] - force[k] * r) / (c * r * r) * h;
+      /* Sila trenja ima znak proklizavanja. Kada proklizavanje promeni znak,
+         brzine su se izjednacile i tocak se ponovo kotrlja. */
+      if ((b->wheel[k] * r - ground) * force[k] <= 0) {
+        b->wheel[k] = ground / r;
+        plant->slip[k] = 0;
+      }
+    }
+    else b->wheel[k] = ground / r;
+    b->angle[k] = a->angle[k] + 0.5 * (a->wheel[k] + b->wheel[k]) * h;
+  }
+  b->theta = a->theta + 0.5 * (a->omega + b->omega) * h;
+  b->x = a->x + 0.5 * (a->v + b->v) * cos(0.5 * (a->theta + b->theta)) * h;
+  b->y = a->y + 0.5 * (a->v + b->v) * sin(0.5 * (a->theta + b->theta)) * h;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Pozicija enkodera (impulsi) u stanju s. */
+static double Counts(const RobotPlant *plant, const RobotPlantState *s, int k)
+{
+  return s->angle[k] * plant->par.wheel_radius * plant->par.counts_per_m;
+}
+
+/* Trenutak sledece promene celobrojne pozicije enkodera unutar koraka, uz
+   linearni ugao tocka izmedju s0 i s1. */
+static uint64_t NextEdge(const RobotPlant *plant, int k)
+{
+  double c0 = Counts(plant, &plant->s0, k), c1 = Counts(plant, &plant->s1, k), f;
+  long e = plant->count[k];
+
+  if (c1 >= e + 1) f = (e + 1 - c0) / (c1 - c0);
+  else if (c1 < e) f = (c0 - e) / (c0 - c1);
+  else return HAL_TIME_NEVER;
+  if (f < 0) f = 0;
+  return plant->t0 + (uint64_t)ceil(f * (double)(plant->t1 - plant->t0));
+}
+
+/* ENC1 broji napred niz (A, B) = 00, 10, 11, 01 na PD2/PB5, ENC2 niz 00, 01,
+   11, 10 na PB14/PB15. Svaka promena pozicije menja tacno jedan pin. */
+static void EmitEdge(RobotPlant *plant, int k, long count)
+{
+  static const uint8_t quad_a[4] = { 0, 1, 1, 0 };
+  static const uint8_t quad_b[4] = { 0, 0, 1, 1 };
+  unsigned int q = (unsigned int)count & 3, old = (unsigned int)plant->count[k] & 3;
+  int a = quad_a[q], b = quad_b[q];
+
+  plant->count[k] = count;
+  plant->edges++;
+  if (k == PLANT_LEFT) {
+    if (a != quad_a[old]) HalGpioInput(HAL_PORT_D, 2, a);
+    else HalGpioInput(HAL_PORT_B, 5, b);
+  }
+  else {
+    /* Za ENC2 vodi kanal B, pa su uloge pinova zamenjene. */
+    if (a != quad_a[old]) HalGpioInput(HAL_PORT_B, 15, a);
+    else HalGpioInput(HAL_PORT_B, 14, b);
+  }
+}
+
+/* Bez napona na motorima i bez kretanja stanje se ne menja, pa model ne
+   pravi korake dok firmware ne promeni ulaz. */
+static int AtRest(const RobotPlant *plant)
+{
+  const RobotPlantState *s = &plant->s0;
+  double r = plant->par.wheel_radius, half = plant->par.wheel_base / 2;
+  int k;
+
+  if (plant->drive[0] != 0 || plant->drive[1] != 0) return 0;
+  if (fabs(s->v) > REST_SPEED || fabs(s->omega * half) > REST_SPEED) return 0;
+  for (k = 0; k < 2; k++)
+    if (fabs(s->wheel[k] * r) > REST_SPEED || fabs(s->current[k]) > REST_CURRENT) return 0;
+  return 1;
+}
+
+static void StartStep(RobotPlant *plant)
+{
+  uint64_t cycles = (uint64_t)(plant->par.step_s * HAL_CPU_HZ + 0.5);
+
+  if (AtRest(plant)) {
+    plant->s0.v = plant->s0.omega = 0;
+    plant->s0.wheel[0] = plant->s0.wheel[1] = 0;
+    plant->s0.current[0] = plant->s0.current[1] = 0;
+    plant->s0.v_battery = plant->par.v_battery;
+    plant->slip[0] = plant->slip[1] = 0;
+    plant->s1 = plant->s0;
+    plant->t1 = HAL_TIME_NEVER;
+    plant->next_edge[0] = plant->next_edge[1] = HAL_TIME_NEVER;
+    return;
+  }
+  if (cycles == 0) cycles = 1;
+  plant->t1 = plant->t0 + cycles;
+  Integrate(plant, &plant->s0, &plant->s1, (double)cycles / HAL_CPU_HZ);
+  plant->next_edge[0] = NextEdge(plant, 0);
+  plant->next_edge[1] = NextEdge(plant, 1);
+}
+
+/* Kraj dela koraka od t0 do now: statistika i novo pocetno stanje. */
+static void Advance(RobotPlant *plant, uint64_t now)
+{
+  RobotPlantState s;
+  int k;
+
+  RobotPlantGet(plant, now, &s);
+  for (k = 0; k < 2; k++)
+    if (plant->slip[k]) plant->slip_cycles[k] += now - plant->t0;
+  plant->distance += fabs(s.v + plant->s0.v) * 0.5 * (double)(now - plant->t0) / HAL_CPU_HZ;
+  plant->s0 = s;
+  plant->t0 = now;
+}
+
+static uint64_t PlantNext(void *ctx)
+{
+  RobotPlant *plant = ctx;
+  uint64_t t = plant->t1;
+
+  if (plant->next_edge[0] < t) t = plant->next_edge[0];
+  if (plant->next_edge[1] < t) t = plant->next_edge[1];
+  return t;
+}
+
+static void PlantRun(void *ctx, uint64_t now)
+{
+  RobotPlant *plant = ctx;
+  int k;
+
+  for (k = 0; k < 2; k++) {
+    while (plant->next_edge[k] <= now) {
+      EmitEdge(plant, k, plant->count[k] + (Counts(plant, &plant->s1, k) >= plant->count[k] + 1 ? 1 : -1));
+      plant->next_edge[k] = NextEdge(plant, k);
+    }
+  }
+  if (now >= plant->t1) {
+    Advance(plant, plant->t1);
+    StartStep(plant);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+void RobotPlantInit(RobotPlant *plant, const RobotPlantParams *par)
+{
+  memset(plant, 0, sizeof(*plant));
+  plant->par = *par;
+  plant->s0.v_battery = par->v_battery;
+  plant->t0 = HalNow();
+  StartStep(plant);
+  plant->dev.next = PlantNext;
+  plant->dev.run = PlantRun;
+  plant->dev.ctx = plant;
+  HalAddDevice(&plant->dev);
+}
+
+void RobotPlantSync(RobotPlant *plant, uint64_t now)
+{
+  double drive[2];
+
+  if (!ReadDrive(plant, drive) || (drive[0] == plant->drive[0] && drive[1] == plant->drive[1])) return;
+  /* Ivice do now su vec poslate, korak se skracuje i pocinje od now. */
+  if (now > plant->t0) Advance(plant, now);
+  plant->drive[0] = drive[0];
+  plant->drive[1] = drive[1];
+  StartStep(plant);
+}
+
+void RobotPlantGet(const RobotPlant *plant, uint64_t now, RobotPlantState *state)
+{
+  const double *a = (const double *)&plant->s0, *b = (const double *)&plant->s1;
+  double *s = (double *)state, f;
+  unsigned int i;
+
+  f = now <= plant->t0 ? 0.0 : now >= plant->t1 ? 1.0 : (double)(now - plant->t0) / (double)(plant->t1 - plant->t0);
+  for (i = 0; i < sizeof(RobotPlantState) / sizeof(double); i++) s[i] = a[i] + (b[i] - a[i]) * f;
+}
@@ -0,0 +1,95 @@
+/**
+*   @file:    robot_plant.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Model robota za host build ploce kretanja (motion_host): dva DC
+*             motora sa H mostom, reduktor, tockovi sa proklizavanjem,
+*             diferencijalni pogon i kvadraturni enkoderi. Ulazi su PWM sa
+*             TIM1 (CH2 motor 1, CH1 motor 2) i pinovi smera PA4/PA10 i
+*             PC8/PC9, izlazi su ivice na PD2/PB5 (ENC1) i PB14/PB15 (ENC2)
+*             koje idu u EXTI prekide firmware-a.
+*
+*             Model se integrali korakom step_s unapred, a ivice enkodera su
+*             dogadjaji u virtuelnom vremenu HAL-a. Kada firmware promeni
+*             ulaz usred koraka, stanje se interpolira do tog trenutka i
+*             korak pocinje ispocetka sa novim ulazom.
+*/
+
+#ifndef __ROBOT_PLANT_H__
+#define __ROBOT_PLANT_H__
+
+#include <stdint.h>
+
+#include "hal.h"
+
+#define PLANT_LEFT   0              // Motor 1, ENC1.
+#define PLANT_RIGHT  1              // Motor 2, ENC2.
+
+typedef struct {
+  /* Baterija i motor (strana motora, pre reduktora). */
+  double v_battery;                 // Napon baterije bez opterecenja [V].
+  double r_battery;                 // Unutrasnja otpornost baterije i kablova [Ohm].
+  double r_motor;                   // Otpornost namotaja [Ohm].
+  double l_motor;                   // Induktivnost namotaja [H].
+  double k_motor;                   // Konstanta momenta i kontra EMS [Nm/A = Vs/rad].
+  double j_motor;                   // Moment inercije rotora [kg m^2].
+  double friction_motor;            // Kulonovo trenje na osovini motora [Nm].
+  double damping_motor;             // Viskozno trenje na osovini motora [Nm s/rad].
+  /* Reduktor i tockovi. */
+  double gear_ratio;
+  double gear_efficiency;
+  double wheel_radius;              // [m], WHEEL_RADIUS iz EUROBOT_Movement.c.
+  double wheel_base;                // [m], WHEEL_BASE iz EUROBOT_Movement.c.
+  double counts_per_m;              // Impulsa enkodera po metru puta tocka (sve ivice).
+  /* Telo robota i podloga. */
+  double mass;                      // [kg].
+  double inertia;                   // Moment inercije oko vertikalne ose [kg m^2].
+  double drive_load;                // Udeo tezine na pogonskim tockovima.
+  double mu_static;                 // Koeficijent trenja tocak - podloga pre proklizavanja.
+  double mu_kinetic;                // Koeficijent trenja pri proklizavanju.
+  double rolling;                   // Koeficijent otpora kotrljanja.
+  double step_s;                    // Korak integracije [s].
+} RobotPlantParams;
+
+/* Stanje koje se integrali (samo double, da bi se moglo interpolirati). */
+typedef struct {
+  double current[2];                // Struja motora [A].
+  double wheel[2];                  // Ugaona brzina tocka [rad/s].
+  double angle[2];                  // Ugao tocka [rad].
+  double v;                         // Brzina centra robota [m/s].
+  double omega;                     // Ugaona brzina robota [rad/s].
+  double x, y, theta;               // Polozaj [m] i orijentacija [rad].
+  double v_battery;                 // Napon baterije pod opterecenjem [V].
+} RobotPlantState;
+
+typedef struct {
+  RobotPlantParams par;
+  HalDevice dev;
+  RobotPlantState s0, s1;           // Stanje na pocetku i kraju tekuceg koraka.
+  uint64_t t0, t1;                  // Pocetak i kraj koraka u ciklusima.
+  int slip[2];                      // Tocak proklizava.
+  double drive[2];                  // Ulaz: -1..1, napon motora / napon baterije.
+  uint32_t inputs[8];               // Registri TIM1 i pinovi smera od kojih je drive.
+  double decay_h, decay;            // exp(-h R / L) za poslednji korak h.
+  long count[2];                    // Pozicija enkodera koju firmware vec vidi.
+  uint64_t next_edge[2];            // Sledeca ivica enkodera ili HAL_TIME_NEVER.
+  /* Statistika. */
+  uint64_t slip_cycles[2];          // Ukupno vreme proklizavanja.
+  unsigned long edges;
+  double distance;                  // Predjeni put centra robota [m].
+  double peak_current;
+} RobotPlant;
+
+/* Podrazumevani parametri: robot od 5 kg sa motorima 12 V i reduktorom 50:1. */
+void RobotPlantDefaults(RobotPlantParams *par);
+/* Postavlja parametar po imenu ("mass=4.2"), vraca -1 ako ime ne postoji. */
+int RobotPlantSet(RobotPlantParams *par, const char *assignment);
+/* Robot u mirovanju u (0, 0, 0) i dodavanje uredjaja u HAL (posle HalReset). */
+void RobotPlantInit(RobotPlant *plant, const RobotPlantParams *par);
+/* Poziva se iz step hook-a: ulazi koje je firmware upravo promenio vaze od now. */
+void RobotPlantSync(RobotPlant *plant, uint64_t now);
+/* Stanje u trenutku now (interpolirano unutar koraka). */
+void RobotPlantGet(const RobotPlant *plant, uint64_t now, RobotPlantState *state);
+
+#endif
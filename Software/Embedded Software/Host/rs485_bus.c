@@ -0,0 +1,207 @@
+/**
+*   @file:    rs485_bus.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Model half-duplex RS485 magistrale, videti rs485_bus.h.
+*/
+
+#include <string.h>
+
+#include "rs485_bus.h"
+
+/* xorshift32, dovoljno za ubacivanje gresaka i ponovljiv za isto seme. */
+static uint32_t NextRandom(Rs485Bus *bus)
+{
+  uint32_t x = bus->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  bus->rng = x;
+  return x;
+}
+
+/* Uniformno u [0, 1). */
+static double NextUniform(Rs485Bus *bus)
+{
+  return (NextRandom(bus) >> 8) * (1.0 / 16777216.0);
+}
+
+/**
+ * @brief   Svaki od deset bitova na liniji se invertuje sa verovatnocom ber.
+ *          Greska na start ili stop bitu se vidi kao framing error, greska na
+ *          bitu podatka samo menja vrednost bajta.
+ * @param   bus: magistrala.
+ * @param   frame: bajt koji se salje.
+ * @retval  None
+ */
+static void InjectBitErrors(Rs485Bus *bus, Rs485Frame *frame)
+{
+  int bit;
+
+  if (bus->cfg.ber <= 0.0) return;
+  for (bit = 0; bit < RS485_BITS_PER_BYTE; bit++) {
+    if (NextUniform(bus) >= bus->cfg.ber) continue;
+    bus->stats.bit_errors++;
+    if (bit == 0 || bit == RS485_BITS_PER_BYTE - 1)
+      frame->flags |= RS485_FLAG_FE;
+    else
+      frame->byte ^= (uint8_t)(1 << (bit - 1));
+  }
+}
+
+/* Bajt unisten sudarom, prijemnik vidi smece sa framing error-om. */
+static void Corrupt(Rs485Bus *bus, Rs485Frame *frame)
+{
+  if (!(frame->flags & RS485_FLAG_FE)) bus->stats.collisions++;
+  frame->flags |= RS485_FLAG_FE | RS485_FLAG_NE;
+  frame->byte ^= (uint8_t)(NextRandom(bus) | 1);
+}
+
+static void PushRx(Rs485Bus *bus, Rs485Node *node, const Rs485Frame *frame)
+{
+  Rs485RxByte *rx;
+
+  if (node->head - node->tail >= RS485_RX_FIFO) {
+    bus->stats.overruns++;
+    node->pending_flags |= RS485_FLAG_ORE;
+    return;
+  }
+  rx = &node->fifo[node->head & (RS485_RX_FIFO - 1)];
+  rx->t = frame->end;
+  rx->byte = frame->byte;
+  rx->flags = frame->flags | node->pending_flags;
+  node->pending_flags = 0;
+  node->head++;
+}
+
+void Rs485BusInit(Rs485Bus *bus, const Rs485Config *cfg)
+{
+  memset(bus, 0, sizeof(*bus));
+  bus->cfg = *cfg;
+  if (bus->cfg.baud == 0) bus->cfg.baud = 115200;
+  bus->byte_ns = (uint64_t)RS485_BITS_PER_BYTE * 1000000000ull / bus->cfg.baud;
+  bus->rng = cfg->seed ? cfg->seed : 0x2545F491u;
+}
+
+int Rs485BusAttach(Rs485Bus *bus)
+{
+  if (bus->nodes >= RS485_MAX_NODES) return -1;
+  return bus->nodes++;
+}
+
+/**
+ * @brief   Gasenje DE pina dok se bajt jos salje odseca taj bajt (tipicna
+ *          greska kada se DE gasi na TXE umesto na TC). Posle gasenja
+ *          predajnik drzi liniju jos turnaround_ns.
+ * @param   bus: magistrala.
+ * @param   node: indeks cvora.
+ * @param   on: novo stanje pina.
+ * @param   t: virtuelno vreme promene.
+ * @retval  None
+ */
+void Rs485BusSetDE(Rs485Bus *bus, int node, int on, uint64_t t)
+{
+  Rs485Node *n = &bus->node[node];
+  int i;
+
+  if (on) {
+    n->de = 1;
+    return;
+  }
+  if (n->de) n->release_t = t + bus->cfg.turnaround_ns;
+  n->de = 0;
+  for (i = 0; i < bus->inflight_num; i++) {
+    if (bus->inflight[i].src == node && bus->inflight[i].end > t)
+      bus->inflight[i].flags |= RS485_FLAG_FE;
+  }
+}
+
+/**
+ * @brief   Bajt izlazi na liniju cim se zavrsi prethodni iz istog predajnika.
+ *          Ako u tom intervalu neki drugi cvor drzi liniju (DE je upaljen ili
+ *          jos nije prosao turnaround), oba bajta su unistena.
+ * @param   bus: magistrala.
+ * @param   node: indeks cvora koji salje.
+ * @param   byte: podatak.
+ * @param   t: virtuelno vreme upisa u USART_DR.
+ * @retval  Trenutak kada se zavrsava stop bit (TC prekid).
+ */
+uint64_t Rs485BusWrite(Rs485Bus *bus, int node, uint8_t byte, uint64_t t)
+{
+  Rs485Node *n = &bus->node[node];
+  Rs485Frame frame;
+  int i, collision = 0;
+
+  frame.start = t > n->tx_busy_until ? t : n->tx_busy_until;
+  frame.end = frame.start + bus->byte_ns;
+  frame.byte = byte;
+  frame.flags = 0;
+  frame.src = node;
+  n->tx_busy_until = frame.end;
+
+  if (!n->de) {
+    bus->stats.de_violations++;
+    return frame.end;
+  }
+  bus->stats.bytes++;
+
+  for (i = 0; i < bus->nodes; i++) {
+    if (i != node && (bus->node[i].de || frame.start < bus->node[i].release_t))
+      collision = 1;
+  }
+  for (i = 0; i < bus->inflight_num; i++) {
+    Rs485Frame *other = &bus->inflight[i];
+    if (other->src != node && other->start < frame.end && frame.start < other->end) {
+      Corrupt(bus, other);
+      collision = 1;
+    }
+  }
+  if (collision)
+    Corrupt(bus, &frame);
+  else
+    InjectBitErrors(bus, &frame);
+
+  if (bus->inflight_num == RS485_MAX_INFLIGHT) Rs485BusAdvance(bus, frame.start);
+  if (bus->inflight_num < RS485_MAX_INFLIGHT) bus->inflight[bus->inflight_num++] = frame;
+  return frame.end;
+}
+
+void Rs485BusAdvance(Rs485Bus *bus, uint64_t t)
+{
+  for (;;) {
+    int i, first = -1;
+    for (i = 0; i < bus->inflight_num; i++) {
+      if (bus->inflight[i].end <= t && (first < 0 || bus->inflight[i].end < bus->inflight[first].end))
+        first = i;
+    }
+    if (first < 0) return;
+
+    for (i = 0; i < bus->nodes; i++) {
+      if (i != bus->inflight[first].src || bus->cfg.echo)
+        PushRx(bus, &bus->node[i], &bus->inflight[first]);
+    }
+    bus->inflight[first] = bus->inflight[--bus->inflight_num];
+  }
+}
+
+int Rs485BusRead(Rs485Bus *bus, int node, Rs485RxByte *rx)
+{
+  Rs485Node *n = &bus->node[node];
+
+  if (n->head == n->tail) return 0;
+  *rx = n->fifo[n->tail & (RS485_RX_FIFO - 1)];
+  n->tail++;
+  return 1;
+}
+
+uint64_t Rs485BusNextEvent(const Rs485Bus *bus)
+{
+  uint64_t next = RS485_TIME_NEVER;
+  int i;
+
+  for (i = 0; i < bus->inflight_num; i++) {
+    if (bus->inflight[i].end < next) next = bus->inflight[i].end;
+  }
+  return next;
+}
@@ -0,0 +1,95 @@
+/**
+*   @file:    rs485_bus.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Model half-duplex RS485 magistrale (USART3 + PC12 driver enable)
+*             za host build-ove obe ploce. Vreme je virtuelno (ns), tako da
+*             simulacija ide brze od realnog vremena. Model racuna trajanje
+*             bajta na zadatom baud rate-u, kasnjenje otpustanja linije posle
+*             gasenja DE pina, sudar dva predajnika i greske po bitu.
+*             Moze se linkovati direktno u jedan proces (in-process kanal) ili
+*             koristiti preko rs485_bus_pty programa.
+*/
+
+#ifndef __RS485_BUS_H__
+#define __RS485_BUS_H__
+
+#include <stdint.h>
+
+#define RS485_MAX_NODES     4
+#define RS485_RX_FIFO       256     // Mora biti stepen dvojke.
+#define RS485_MAX_INFLIGHT  16
+#define RS485_BITS_PER_BYTE 10      // Start bit, 8 bita podatka, stop bit.
+#define RS485_TIME_NEVER    UINT64_MAX
+
+/* Flag-ovi primljenog bajta, odgovaraju bitovima USART_SR. */
+#define RS485_FLAG_FE       0x02    // Framing error (los stop bit ili sudar).
+#define RS485_FLAG_NE       0x04    // Noise error.
+#define RS485_FLAG_ORE      0x08    // Bajt pre ovoga je izgubljen (pun FIFO).
+
+typedef struct {
+  uint32_t baud;            // Bit/s, ploce rade na 115200.
+  uint32_t turnaround_ns;   // Koliko predajnik jos drzi liniju posle gasenja DE.
+  double   ber;             // Verovatnoca da je jedan bit pogresan.
+  uint32_t seed;            // Seme generatora slucajnih brojeva za BER.
+  int      echo;            // 1 - predajnik prima i sopstvene bajtove.
+} Rs485Config;
+
+typedef struct {
+  uint64_t t;               // Trenutak kada je stop bit primljen.
+  uint8_t  byte;
+  uint8_t  flags;
+} Rs485RxByte;
+
+typedef struct {
+  int      de;              // Stanje driver enable pina.
+  uint64_t release_t;       // Do kada predajnik drzi liniju posle gasenja DE.
+  uint64_t tx_busy_until;   // Kraj poslednjeg bajta u shift registru.
+  Rs485RxByte fifo[RS485_RX_FIFO];
+  unsigned head, tail;
+  uint8_t  pending_flags;   // Flag-ovi za sledeci bajt koji ulazi u FIFO.
+} Rs485Node;
+
+typedef struct {
+  uint64_t start, end;
+  uint8_t  byte;
+  uint8_t  flags;
+  int      src;
+} Rs485Frame;
+
+typedef struct {
+  unsigned long bytes;          // Bajtova koji su izasli na liniju.
+  unsigned long collisions;     // Bajtova unistenih sudarom.
+  unsigned long bit_errors;     // Ubacenih gresaka po bitu.
+  unsigned long de_violations;  // Slanja sa ugasenim DE pinom.
+  unsigned long overruns;       // Izgubljenih bajtova zbog punog FIFO-a.
+} Rs485Stats;
+
+typedef struct {
+  Rs485Config cfg;
+  uint64_t    byte_ns;
+  Rs485Node   node[RS485_MAX_NODES];
+  int         nodes;
+  Rs485Frame  inflight[RS485_MAX_INFLIGHT];
+  int         inflight_num;
+  uint32_t    rng;
+  Rs485Stats  stats;
+} Rs485Bus;
+
+/* Inicijalizacija magistrale. */
+void Rs485BusInit(Rs485Bus *bus, const Rs485Config *cfg);
+/* Dodaje cvor na magistralu, vraca njegov indeks ili -1. */
+int Rs485BusAttach(Rs485Bus *bus);
+/* Promena stanja DE pina cvora u trenutku t. */
+void Rs485BusSetDE(Rs485Bus *bus, int node, int on, uint64_t t);
+/* Upis bajta u predajnik cvora u trenutku t, vraca trenutak TC prekida. */
+uint64_t Rs485BusWrite(Rs485Bus *bus, int node, uint8_t byte, uint64_t t);
+/* Isporucuje sve bajtove ciji se stop bit zavrsio do trenutka t. */
+void Rs485BusAdvance(Rs485Bus *bus, uint64_t t);
+/* Cita sledeci primljeni bajt cvora, vraca 0 ako je FIFO prazan. */
+int Rs485BusRead(Rs485Bus *bus, int node, Rs485RxByte *rx);
+/* Trenutak sledeceg isporucivanja bajta ili RS485_TIME_NEVER. */
+uint64_t Rs485BusNextEvent(const Rs485Bus *bus);
+
+#endif
@@ -0,0 +1,203 @@
+/**
+*   @file:    rs485_bus_pty.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Program koji otvara po jedan pseudo-terminal za svaku plocu i
+*             povezuje ih preko modela RS485 magistrale (rs485_bus.c).
+*             Host build-ovi ploca se povezuju na ispisane putanje (ili na
+*             simbolicke linkove zadate sa -l) i govore protokol rs485_link.h.
+*
+*             rs485_bus_pty [-n cvorova] [-b baud] [-t turnaround_ns]
+*                           [-e ber] [-s seed] [-q kvant_ns] [-d sekundi]
+*                           [-E] [-l link]...
+*/
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rs485_bus.h"
+#include "rs485_link.h"
+
+#define MAX_EVENTS 1024
+
+typedef struct {
+  Rs485LinkRecord rec;
+  int node;
+  int seq;
+} BusEvent;
+
+static Rs485Bus bus;
+static int master_fd[RS485_MAX_NODES];
+static BusEvent events[MAX_EVENTS];
+static int events_num;
+
+/* Dogadjaji iz kvanta se primenjuju po virtuelnom vremenu, pa po redosledu prijema. */
+static int CompareEvents(const void *a, const void *b)
+{
+  const BusEvent *ea = a, *eb = b;
+
+  if (ea->rec.t != eb->rec.t) return ea->rec.t < eb->rec.t ? -1 : 1;
+  return ea->seq - eb->seq;
+}
+
+static int OpenPty(const char *link)
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+  if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+    perror("posix_openpt");
+    exit(1);
+  }
+  Rs485LinkRaw(fd);
+  printf("%s", ptsname(fd));
+  if (link) {
+    unlink(link);
+    if (symlink(ptsname(fd), link) != 0) perror(link);
+    else printf(" -> %s", link);
+  }
+  printf("\n");
+  return fd;
+}
+
+/* Ceka HELLO (pre toga read na master strani vraca EIO jer slave nije otvoren). */
+static void WaitHello(int fd)
+{
+  Rs485LinkRecord rec;
+
+  for (;;) {
+    if (Rs485LinkRead(fd, &rec) == 0) {
+      if (rec.type == LINK_HELLO) return;
+    }
+    else usleep(10000);
+  }
+}
+
+/* Skuplja TX/DE zapise cvora do DONE, vraca -1 ako je veza zatvorena. */
+static int CollectNode(int node)
+{
+  Rs485LinkRecord rec;
+
+  for (;;) {
+    if (Rs485LinkRead(master_fd[node], &rec) != 0) return -1;
+    if (rec.type == LINK_DONE) return 0;
+    if ((rec.type == LINK_TX || rec.type == LINK_DE) && events_num < MAX_EVENTS) {
+      events[events_num].rec = rec;
+      events[events_num].node = node;
+      events[events_num].seq = events_num;
+      events_num++;
+    }
+  }
+}
+
+static double WallSeconds(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+  Rs485Config cfg = { 115200, 2000, 0.0, 1, 0 };
+  const char *links[RS485_MAX_NODES] = { 0 };
+  int links_num = 0, nodes = 2, i, opt;
+  uint64_t quantum = 0, now = 0, duration = 0;
+  double wall_start;
+
+  while ((opt = getopt(argc, argv, "n:b:t:e:s:q:d:El:")) != -1) {
+    switch (opt) {
+      case 'n': nodes = atoi(optarg); break;
+      case 'b': cfg.baud = (uint32_t)atol(optarg); break;
+      case 't': cfg.turnaround_ns = (uint32_t)atol(optarg); break;
+      case 'e': cfg.ber = atof(optarg); break;
+      case 's': cfg.seed = (uint32_t)atol(optarg); break;
+      case 'q': quantum = (uint64_t)atoll(optarg); break;
+      case 'd': duration = (uint64_t)(atof(optarg) * 1e9); break;
+      case 'E': cfg.echo = 1; break;
+      case 'l': if (links_num < RS485_MAX_NODES) links[links_num++] = optarg; break;
+      default:
+        fprintf(stderr, "usage: %s [-n nodes] [-b baud] [-t turnaround_ns] [-e ber] "
+                        "[-s seed] [-q quantum_ns] [-d seconds] [-E] [-l link]...\n", argv[0]);
+        return 1;
+    }
+  }
+  if (nodes < 1 || nodes > RS485_MAX_NODES) nodes = 2;
+
+  Rs485BusInit(&bus, &cfg);
+  if (quantum == 0) quantum = bus.byte_ns;
+  for (i = 0; i < nodes; i++) {
+    Rs485BusAttach(&bus);
+    master_fd[i] = OpenPty(links[i]);
+  }
+  fflush(stdout);
+
+  for (i = 0; i < nodes; i++) {
+    Rs485LinkRecord cfg_rec;
+    WaitHello(master_fd[i]);
+    memset(&cfg_rec, 0, sizeof(cfg_rec));
+    cfg_rec.type = LINK_CONFIG;
+    cfg_rec.t = bus.byte_ns;
+    Rs485LinkWrite(master_fd[i], &cfg_rec);
+  }
+
+  wall_start = WallSeconds();
+  for (;;) {
+    Rs485LinkRecord out;
+    Rs485RxByte rx;
+
+    events_num = 0;
+    for (i = 0; i < nodes; i++) {
+      if (CollectNode(i) != 0) goto done;
+    }
+    qsort(events, events_num, sizeof(events[0]), CompareEvents);
+    for (i = 0; i < events_num; i++) {
+      if (events[i].rec.type == LINK_TX)
+        Rs485BusWrite(&bus, events[i].node, events[i].rec.value, events[i].rec.t);
+      else
+        Rs485BusSetDE(&bus, events[i].node, events[i].rec.value, events[i].rec.t);
+    }
+    Rs485BusAdvance(&bus, now);
+
+    memset(&out, 0, sizeof(out));
+    for (i = 0; i < nodes; i++) {
+      while (Rs485BusRead(&bus, i, &rx)) {
+        out.type = LINK_RX;
+        out.t = rx.t;
+        out.value = rx.byte;
+        out.flags = rx.flags;
+        if (Rs485LinkWrite(master_fd[i], &out) != 0) goto done;
+      }
+    }
+
+    if (duration && now >= duration) break;
+    now += quantum;
+    out.type = LINK_GRANT;
+    out.t = now;
+    out.value = 0;
+    out.flags = 0;
+    for (i = 0; i < nodes; i++) {
+      if (Rs485LinkWrite(master_fd[i], &out) != 0) goto done;
+    }
+  }
+
+done:
+  {
+    double wall = WallSeconds() - wall_start;
+    fprintf(stderr, "virtual %.3f s, wall %.3f s (x%.1f)\n", now * 1e-9, wall,
+            wall > 0 ? now * 1e-9 / wall : 0.0);
+    fprintf(stderr, "bytes %lu, collisions %lu, bit errors %lu, DE violations %lu, overruns %lu\n",
+            bus.stats.bytes, bus.stats.collisions, bus.stats.bit_errors,
+            bus.stats.de_violations, bus.stats.overruns);
+  }
+  for (i = 0; i < links_num; i++) unlink(links[i]);
+  return 0;
+}
@@ -0,0 +1,99 @@
+/**
+*   @file:    rs485_link.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Strana cvora u protokolu rs485_link.h.
+*/
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "rs485_link.h"
+
+int Rs485LinkRaw(int fd)
+{
+  struct termios tio;
+
+  if (tcgetattr(fd, &tio) != 0) return -1;
+  cfmakeraw(&tio);
+  return tcsetattr(fd, TCSANOW, &tio);
+}
+
+int Rs485LinkWrite(int fd, const Rs485LinkRecord *rec)
+{
+  const char *p = (const char *)rec;
+  size_t left = sizeof(*rec);
+
+  while (left > 0) {
+    ssize_t n = write(fd, p, left);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return -1;
+    p += n;
+    left -= (size_t)n;
+  }
+  return 0;
+}
+
+int Rs485LinkRead(int fd, Rs485LinkRecord *rec)
+{
+  char *p = (char *)rec;
+  size_t left = sizeof(*rec);
+
+  while (left > 0) {
+    ssize_t n = read(fd, p, left);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return -1;
+    p += n;
+    left -= (size_t)n;
+  }
+  return 0;
+}
+
+int Rs485LinkSend(int fd, uint8_t type, uint8_t value, uint64_t t)
+{
+  Rs485LinkRecord rec;
+
+  memset(&rec, 0, sizeof(rec));
+  rec.t = t;
+  rec.type = type;
+  rec.value = value;
+  return Rs485LinkWrite(fd, &rec);
+}
+
+int Rs485LinkOpen(const char *path, uint64_t *byte_ns)
+{
+  Rs485LinkRecord rec;
+  int fd = open(path, O_RDWR | O_NOCTTY);
+
+  if (fd < 0) return -1;
+  if (Rs485LinkRaw(fd) != 0 || Rs485LinkSend(fd, LINK_HELLO, 0, 0) != 0) {
+    close(fd);
+    return -1;
+  }
+  do {
+    if (Rs485LinkRead(fd, &rec) != 0) {
+      close(fd);
+      return -1;
+    }
+  } while (rec.type != LINK_CONFIG);
+  if (byte_ns) *byte_ns = rec.t;
+  return fd;
+}
+
+uint64_t Rs485LinkSync(int fd, uint64_t reached, Rs485LinkRxCallback rx, void *ctx)
+{
+  Rs485LinkRecord rec;
+
+  if (Rs485LinkSend(fd, LINK_DONE, 0, reached) != 0) return 0;
+  for (;;) {
+    if (Rs485LinkRead(fd, &rec) != 0) return 0;
+    if (rec.type == LINK_GRANT) return rec.t;
+    if (rec.type == LINK_RX && rx) rx(&rec, ctx);
+  }
+}
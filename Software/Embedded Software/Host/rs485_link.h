@@ -0,0 +1,59 @@
+/**
+*   @file:    rs485_link.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Protokol izmedju rs485_bus_pty programa i host build-a jedne
+*             ploce. Preko pseudo-terminala idu zapisi fiksne duzine sa
+*             virtuelnim vremenom, tako da se preko iste veze prenose i bajtovi
+*             i stanje DE pina.
+*
+*             Sinhronizacija je konzervativna: magistrala daje svakom cvoru
+*             GRANT(t), cvor izvrsava firmware do t i prijavljuje sve upise u
+*             USART_DR (TX) i promene PC12 (DE), pa salje DONE(t). Kada svi
+*             cvorovi posalju DONE, magistrala razresava sudare, salje primljene
+*             bajtove (RX) i sledeci GRANT. Kvant je jedno trajanje bajta, pa
+*             je kasnjenje RXNE prekida najvise jedan bajt.
+*/
+
+#ifndef __RS485_LINK_H__
+#define __RS485_LINK_H__
+
+#include <stdint.h>
+
+/* Tipovi zapisa. */
+#define LINK_HELLO    1   // cvor -> magistrala, posle otvaranja veze.
+#define LINK_TX       2   // cvor -> magistrala, value = bajt.
+#define LINK_DE       3   // cvor -> magistrala, value = stanje DE pina.
+#define LINK_DONE     4   // cvor -> magistrala, firmware je stigao do t.
+#define LINK_CONFIG   5   // magistrala -> cvor, t = trajanje bajta u ns.
+#define LINK_RX       6   // magistrala -> cvor, value = bajt, flags = RS485_FLAG_*.
+#define LINK_GRANT    7   // magistrala -> cvor, firmware sme da radi do t.
+
+typedef struct {
+  uint64_t t;
+  uint8_t  type;
+  uint8_t  value;
+  uint8_t  flags;
+  uint8_t  reserved[5];
+} Rs485LinkRecord;
+
+typedef void (*Rs485LinkRxCallback)(const Rs485LinkRecord *rec, void *ctx);
+
+/* Otvara vezu (putanja pseudo-terminala), vraca fd ili -1. */
+int Rs485LinkOpen(const char *path, uint64_t *byte_ns);
+/* Postavlja terminal u raw mod. */
+int Rs485LinkRaw(int fd);
+/* Upis i citanje celog zapisa, vracaju 0 ako je uspesno. */
+int Rs485LinkWrite(int fd, const Rs485LinkRecord *rec);
+int Rs485LinkRead(int fd, Rs485LinkRecord *rec);
+/* Prijava zapisa sa strane cvora. */
+int Rs485LinkSend(int fd, uint8_t type, uint8_t value, uint64_t t);
+/**
+ * Javlja da je firmware stigao do reached i ceka sledeci GRANT. Za svaki
+ * primljeni bajt poziva rx. Vraca granicu sledeceg kvanta ili 0 ako je veza
+ * zatvorena.
+ */
+uint64_t Rs485LinkSync(int fd, uint64_t reached, Rs485LinkRxCallback rx, void *ctx);
+
+#endif
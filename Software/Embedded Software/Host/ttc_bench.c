@@ -0,0 +1,333 @@
+/**
+*   @file:    ttc_bench.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Reakcija na prepreku sa i bez brzine priblizavanja iz
+*             range_rate.c, na snimku echo signala jednog senzora u smeru
+*             kretanja. Merenja prolaze kroz filtar iz ultrasound_filter.c
+*             (Hampel 5), procenu brzine i obstacle_zone.c kao na ploci
+*             kretanja (zadatak svakih 10 ms). Bez brzine TTC se racuna iz
+*             sopstvene brzine kao ranije.
+*
+*             Snimak (-f) ima jedno merenje po liniji: "t_ms width_us
+*             brzina_mm_s preostali_put_mm [rastojanje_mm]", # je komentar.
+*             Bez snimka se generisu scenariji: prilaz zidu na cilju malom
+*             brzinom (ne treba stati pre OBST_RELEASE_MM), zid usred puta,
+*             protivnik koji prilazi, protivnik koji je prisao i stao na
+*             cilju i protivnik parkiran na cilju koji je misija oznacila kao
+*             zid (treba stati). Zid oznacava misija (ObstacleZoneWall), -w
+*             za snimak. Snimak
+*             je unapred zadat, reakcija ne menja kretanje, pa se isti snimak
+*             pusti kroz oba nacina. Ispisuje udeo pustanja sa
+*             zaustavljanjem, srednje rastojanje pri prvom zaustavljanju i
+*             kada ogranicenje brzine padne na pola, i gresku procenjene
+*             brzine priblizavanja.
+*
+*             gcc -std=c99 -O2 -I"../Motion Board" -o ttc_bench ttc_bench.c "../Motion Board/ultrasound_filter.c" "../Motion Board/range_rate.c" "../Motion Board/obstacle_zone.c" -lm
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ultrasound_filter.h"
+#include "range_rate.h"
+#include "obstacle_zone.h"
+
+#define US_PER_MM        5.8
+#define NOMINAL_SPEED    60
+#define NO_DATA          0xFFFF
+#define MISSED_MM        50       // Zaustavljanje blize od ovoga je promaseno.
+#define EARLY_MM         OBST_RELEASE_MM  // Zaustavljanje dalje od ovoga pred zidom je lazno.
+#define MAX_SCENARIO_MS  20000
+#define US_RATE_MAX_MS   200      // US_RATE_MAX_AGE ploce kretanja.
+
+typedef struct {
+  double t_ms;
+  unsigned int width;
+  unsigned int speed;             // Sopstvena brzina, mm/s.
+  unsigned int remaining;         // Preostali put do cilja, mm.
+  int gap;                        // Stvarno rastojanje, -1 ako nije poznato.
+  int closing;                    // Stvarna brzina priblizavanja, INT_MIN ako nije poznata.
+} Sample;
+
+typedef struct {
+  const char *name;
+  double cruise;                  // Brzina robota, mm/s.
+  double dock_speed;              // Brzina na poslednjih dock_start mm.
+  double dock_start;
+  double target;                  // Cilj, mm od pocetka.
+  double obj0;                    // Pocetni polozaj objekta.
+  double obj_speed;               // Brzina objekta prema robotu.
+  double obj_halt;                // Objekat staje na ovom polozaju.
+  int wall;                       // Misija je oznacila cilj kao zid.
+  int must_stop;                  // -1 nije poznato (snimak).
+} Scenario;
+
+static const Scenario scenarios[] = {
+  { "prilaz zidu 100 mm/s", 400.0, 100.0, 400.0, 1200.0, 1200.0, 0.0, 0.0, 1, 0 },
+  { "prilaz zidu 180 mm/s", 400.0, 180.0, 400.0, 1200.0, 1200.0, 0.0, 0.0, 1, 0 },
+  { "zid usred puta", 300.0, 300.0, 0.0, 2000.0, 900.0, 0.0, 0.0, 0, 1 },
+  { "zid usred puta sporo", 120.0, 120.0, 0.0, 2000.0, 900.0, 0.0, 0.0, 0, 1 },
+  { "protivnik prilazi", 150.0, 150.0, 0.0, 2000.0, 1600.0, 300.0, 0.0, 0, 1 },
+  { "protivnik stao na cilju", 300.0, 100.0, 400.0, 1200.0, 2200.0, 300.0, 1200.0, 1, 1 },
+  { "parkiran na cilju", 300.0, 100.0, 400.0, 1200.0, 1200.0, 0.0, 0.0, 1, 1 },
+};
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static Sample *samples;
+static size_t num_samples, cap_samples;
+
+static int runs = 200;
+static double period_ms = 60.0;
+static double noise_mm = 5.0;
+static double spike_prob = 0.02;     // Lazni echo sa slucajnim trajanjem.
+static double miss_prob = 0.03;      // Nema odjeka.
+static double accel = 1000.0;        // mm/s^2.
+
+typedef struct {
+  long plays, stopped, early, missed, slowed;
+  double gap_sum;                    // Rastojanje pri prvom zaustavljanju.
+  double slow_sum;                   // Rastojanje kada ogranicenje padne na pola.
+  double err_sum;                    // Kvadrat greske brzine priblizavanja.
+  long err_n;
+} Score;
+
+static void push(const Sample *s)
+{
+  if (num_samples == cap_samples) {
+    cap_samples = cap_samples ? 2 * cap_samples : 4096;
+    samples = realloc(samples, cap_samples * sizeof(Sample));
+    if (samples == NULL) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  samples[num_samples++] = *s;
+}
+
+static double uniform(void)
+{
+  return rand() / (RAND_MAX + 1.0);
+}
+
+static double gauss(void)
+{
+  double u = uniform() + 1e-12, v = uniform();
+  return sqrt(-2.0 * log(u)) * cos(6.283185307 * v);
+}
+
+/* Snimak jednog scenarija, korak 1 ms. Zavrsava se na cilju ili pri dodiru. */
+static void generate(const Scenario *sc)
+{
+  double pos = 0.0, v = 0.0, obj = sc->obj0, next = uniform() * period_ms;
+  double t;
+
+  num_samples = 0;
+  for (t = 0.0; t < MAX_SCENARIO_MS; t += 1.0) {
+    double remaining = sc->target - pos, gap = obj - pos, v_ref, obj_v = 0.0;
+
+    if (remaining <= 1.0 || gap <= 10.0) break;
+    v_ref = (remaining > sc->dock_start) ? sc->cruise : sc->dock_speed;
+    if (v < v_ref) v = (v + accel * 0.001 < v_ref) ? v + accel * 0.001 : v_ref;
+    else if (v > v_ref) v = (v - accel * 0.001 > v_ref) ? v - accel * 0.001 : v_ref;
+    if (sc->obj_speed > 0.0 && obj > sc->obj_halt) {
+      obj_v = sc->obj_speed;
+      obj -= obj_v * 0.001;
+      if (obj < sc->obj_halt) obj = sc->obj_halt;
+    }
+    pos += v * 0.001;
+
+    if (t >= next) {
+      Sample s;
+      double width = (gap + noise_mm * gauss()) * US_PER_MM, u = uniform();
+      if (gap > 4000.0 || u < miss_prob) width = 38000.0;
+      else if (u < miss_prob + spike_prob) width = US_MIN_US + uniform() * (US_MAX_US - US_MIN_US);
+      if (width < 0.0) width = 0.0;
+      s.t_ms = t;
+      s.width = (unsigned int)width;
+      s.speed = (unsigned int)v;
+      s.remaining = (unsigned int)(remaining > 0.0 ? remaining : 0.0);
+      s.gap = (int)gap;
+      s.closing = (int)(v + obj_v);
+      push(&s);
+      next += period_ms;
+    }
+  }
+}
+
+static int load(const char *path)
+{
+  char line[256];
+  FILE *f = fopen(path, "r");
+
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    Sample s;
+    if (line[0] == '#') continue;
+    s.gap = -1;
+    s.closing = INT_MIN;
+    if (sscanf(line, "%lf %u %u %u %d", &s.t_ms, &s.width, &s.speed, &s.remaining, &s.gap) < 4) continue;
+    if (s.width > 65535) s.width = 65535;
+    push(&s);
+  }
+  fclose(f);
+  return 0;
+}
+
+/* Pusta snimak kroz zadatak prepreke. rate = 0 bez brzine priblizavanja,
+   wall = 1 ako je misija oznacila cilj kao zid. */
+static void replay(int rate, int wall, Score *sc)
+{
+  ObstacleZoneType z;
+  UsFilterType f;
+  RangeRateType rr;
+  uint16_t distance = NO_DATA;
+  double tick, last_t = -1.0;
+  size_t i = 0;
+  int gap = -1, stopped = 0, slowed = 0;
+  unsigned int speed = 0, remaining = 0;
+
+  if (num_samples == 0) return;
+  ObstacleZoneInit(&z, NOMINAL_SPEED);
+  ObstacleZoneWall(&z, (uint8_t)wall);
+  UsFilterInit(&f, US_FILTER_N, US_FILTER_MODE);
+  RangeRateReset(&rr);
+
+  for (tick = samples[0].t_ms; tick <= samples[num_samples - 1].t_ms + 10.0; tick += 10.0) {
+    int16_t closing;
+    uint8_t limit;
+
+    for (; i < num_samples && samples[i].t_ms <= tick; i++) {
+      const Sample *s = &samples[i];
+      distance = (uint16_t)((uint32_t)UsFilterAdd(&f, (uint16_t)(s->width > 65535 ? 65535 : s->width)) * 10 / 58);
+      /* Kao UltrasoundAddSample(): merenje bez odjeka se preskace. */
+      if (f.status == US_ECHO_VALID) {
+        if (last_t >= 0.0 && s->t_ms - last_t > US_RATE_MAX_MS) RangeRateReset(&rr);
+        RangeRateUpdate(&rr, (uint16_t)(s->width * 10 / 58),
+                        (uint16_t)(last_t < 0.0 ? 0.0 : (s->t_ms - last_t) * 10.0));
+        last_t = s->t_ms;
+      }
+      speed = s->speed;
+      remaining = s->remaining;
+      gap = s->gap;
+      if (rate && s->closing != INT_MIN && RangeRateClosing(&rr) != RR_NO_RATE) {
+        double e = RangeRateClosing(&rr) - s->closing;
+        sc->err_sum += e * e;
+        sc->err_n++;
+      }
+    }
+
+    /* Kao slowDownIfObstacle(). */
+    closing = rate ? RangeRateClosing(&rr) : OBST_NO_RATE;
+    if (closing == RR_NO_RATE) closing = OBST_NO_RATE;
+    limit = ObstacleZoneUpdate(&z, (rate && RangeRateRange(&rr) < distance) ? RangeRateRange(&rr) : distance,
+                               (uint16_t)speed, closing, (uint16_t)remaining);
+    if (limit <= NOMINAL_SPEED / 2 && !slowed && gap >= 0) {
+      slowed = 1;
+      sc->slowed++;
+      sc->slow_sum += gap;
+    }
+    if (limit == 0 && !stopped) {
+      stopped = 1;
+      sc->stopped++;
+      if (gap >= 0) sc->gap_sum += gap;
+      if (gap > EARLY_MM) sc->early++;
+      if (gap >= 0 && gap < MISSED_MM) sc->missed++;
+    }
+  }
+  if (!stopped) sc->missed++;
+  sc->plays++;
+}
+
+static void print_row(const char *name, int must_stop, const Score *s)
+{
+  int p;
+
+  printf("%-24s %5s", name, must_stop < 0 ? "?" : must_stop ? "da" : "ne");
+  for (p = 0; p < 2; p++) {
+    printf(" %9.1f", 100.0 * s[p].stopped / (s[p].plays ? s[p].plays : 1));
+    if (s[p].stopped) printf(" %9.0f", s[p].gap_sum / s[p].stopped);
+    else printf(" %9s", "-");
+    if (s[p].slowed) printf(" %9.0f", s[p].slow_sum / s[p].slowed);
+    else printf(" %9s", "-");
+  }
+  if (s[1].err_n) printf(" %10.1f\n", sqrt(s[1].err_sum / s[1].err_n));
+  else printf(" %10s\n", "-");
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  unsigned int seed = 1;
+  long false_stops[2] = { 0, 0 }, missed[2] = { 0, 0 }, plays_free = 0, plays_stop = 0;
+  int opt, k, p, wall = 0;
+  size_t n;
+
+  while ((opt = getopt(argc, argv, "f:wr:p:e:s:m:x:")) != -1) {
+    switch (opt) {
+      case 'f': path = optarg; break;
+      case 'w': wall = 1; break;
+      case 'r': runs = atoi(optarg); break;
+      case 'p': period_ms = atof(optarg); break;
+      case 'e': noise_mm = atof(optarg); break;
+      case 's': spike_prob = atof(optarg); break;
+      case 'm': miss_prob = atof(optarg); break;
+      case 'x': seed = (unsigned int)atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-f snimak [-w]] [-r runs] [-p period_ms] [-e noise_mm] [-s spike_prob] "
+                "[-m miss_prob] [-x seed]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (runs < 1 || period_ms < 10.0) return 1;
+
+  printf("%-24s %5s %9s %9s %9s %9s %9s %9s %10s\n", "", "stati", "bez: [%]", "raz. [mm]", "uspor.", "TTC: [%]",
+         "raz. [mm]", "uspor.", "gr. [mm/s]");
+
+  if (path) {
+    Score s[2];
+    memset(s, 0, sizeof(s));
+    if (load(path) != 0) return 1;
+    for (p = 0; p < 2; p++) replay(p, wall, &s[p]);
+    print_row(path, -1, s);
+    free(samples);
+    return 0;
+  }
+
+  srand(seed);
+  for (n = 0; n < NUM_SCENARIOS; n++) {
+    const Scenario *sc = &scenarios[n];
+    Score s[2];
+
+    memset(s, 0, sizeof(s));
+    for (k = 0; k < runs; k++) {
+      generate(sc);
+      for (p = 0; p < 2; p++) replay(p, sc->wall, &s[p]);
+    }
+    print_row(sc->name, sc->must_stop, s);
+    for (p = 0; p < 2; p++) {
+      if (sc->must_stop) missed[p] += s[p].missed;
+      else false_stops[p] += s[p].early;
+    }
+    if (sc->must_stop) plays_stop += runs;
+    else plays_free += runs;
+  }
+
+  printf("\n%-24s %9s %9s\n", "", "bez", "TTC");
+  printf("%-24s %8.1f%% %8.1f%%\n", "lazna zaustavljanja", 100.0 * false_stops[0] / plays_free,
+         100.0 * false_stops[1] / plays_free);
+  printf("%-24s %8.1f%% %8.1f%%\n", "promasena zaustavljanja", 100.0 * missed[0] / plays_stop,
+         100.0 * missed[1] / plays_stop);
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,292 @@
+/**
+*   @file:    us_filter_bench.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Poredjenje filtara iz ultrasound_filter.c na snimljenim ili
+*             generisanim trajanjima echo signala. Za svaki filtar (srednja
+*             vrednost 5 merenja kao ranije, medijana i Hampel sa N = 3, 5,
+*             7) ispisuje:
+*               - lazna zaustavljanja: udeo merenja kada je put slobodan
+*                 (stvarno rastojanje vece od MAX_DISTANCE_MM + margina), a
+*                 filtar daje rastojanje do MAX_DISTANCE_MM,
+*               - promasene prepreke: udeo merenja kada je prepreka bliza od
+*                 MAX_DISTANCE_MM - margina, a filtar je ne vidi,
+*               - srednje kasnjenje detekcije u merenjima posle ulaska
+*                 prepreke u zonu zaustavljanja.
+*
+*             Snimak (-f) ima jedno merenje po liniji: "t_ms senzor width_us
+*             [rastojanje_mm]", # je komentar. Ako nema stvarnog rastojanja,
+*             kao referenca se uzima centrirana medijana 9 merenja istog
+*             senzora. Bez snimka se generise protivnik koji prilazi i
+*             odlazi, sa sumom, laznim dugim i kratkim echo signalima i
+*             izostalim odjecima (-s, -m, -x).
+*
+*             gcc -std=c99 -O2 -I"../Motion Board" -o us_filter_bench us_filter_bench.c "../Motion Board/ultrasound_filter.c" -lm
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ultrasound_filter.h"
+
+#define MAX_DISTANCE_MM  300      // Ranija granica zaustavljanja iz stm32f10x_it_stu.c.
+#define MARGIN_MM        30
+#define MAX_SENSORS      8
+#define REF_WINDOW       9
+#define PERIOD_MS        75       // Perioda trigger-a.
+#define US_PER_MM        5.8
+
+typedef struct {
+  unsigned int sensor;
+  unsigned int width;
+  int truth_mm;                   // -1 ako nije poznato.
+} Sample;
+
+typedef struct {
+  const char *name;
+  uint8_t n;
+  uint8_t mode;
+} FilterCfg;
+
+static const FilterCfg filters[] = {
+  { "srednja 5", 5, US_FILTER_MEAN },
+  { "medijana 3", 3, US_FILTER_MEDIAN },
+  { "medijana 5", 5, US_FILTER_MEDIAN },
+  { "medijana 7", 7, US_FILTER_MEDIAN },
+  { "hampel 3", 3, US_FILTER_HAMPEL },
+  { "hampel 5", 5, US_FILTER_HAMPEL },
+  { "hampel 7", 7, US_FILTER_HAMPEL },
+};
+#define NUM_FILTERS (sizeof(filters) / sizeof(filters[0]))
+
+static Sample *samples;
+static size_t num_samples, cap_samples;
+
+/* Parametri generatora. */
+static double spike_prob = 0.03;     // Lazni echo sa slucajnim trajanjem.
+static double miss_prob = 0.05;      // Nema odjeka, echo traje 38 ms.
+static double cross_prob = 0.02;     // Kratak echo od drugog senzora.
+static double noise_mm = 6.0;
+
+static void push(unsigned int sensor, unsigned int width, int truth_mm)
+{
+  if (num_samples == cap_samples) {
+    cap_samples = cap_samples ? 2 * cap_samples : 4096;
+    samples = realloc(samples, cap_samples * sizeof(Sample));
+    if (samples == NULL) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  samples[num_samples].sensor = sensor;
+  samples[num_samples].width = width;
+  samples[num_samples].truth_mm = truth_mm;
+  num_samples++;
+}
+
+static double uniform(void)
+{
+  return rand() / (RAND_MAX + 1.0);
+}
+
+static double gauss(void)
+{
+  double u = uniform() + 1e-12, v = uniform();
+  return sqrt(-2.0 * log(u)) * cos(6.283185307 * v);
+}
+
+/* Rastojanje protivnika u trenutku t_ms jednog ciklusa od 20 s: daleko,
+   prilazi do 150 mm, stoji, odlazi. */
+static double opponent_mm(double t_ms, unsigned int sensor)
+{
+  double t = fmod(t_ms + sensor * 3100.0, 20000.0) / 1000.0;
+  if (t < 5.0) return 2500.0;
+  if (t < 9.0) return 2500.0 - (t - 5.0) * 587.5;
+  if (t < 12.0) return 150.0;
+  if (t < 16.0) return 150.0 + (t - 12.0) * 587.5;
+  return 2500.0;
+}
+
+static void generate(unsigned int sensors, double seconds)
+{
+  double t;
+  unsigned int s;
+
+  for (t = 0.0; t < seconds * 1000.0; t += PERIOD_MS) {
+    for (s = 0; s < sensors; s++) {
+      int truth = (int)opponent_mm(t, s);
+      double width = (truth + noise_mm * gauss()) * US_PER_MM;
+      double u = uniform();
+      if (u < miss_prob) width = 38000.0;
+      else if (u < miss_prob + spike_prob) width = US_MIN_US + uniform() * (US_MAX_US - US_MIN_US);
+      else if (u < miss_prob + spike_prob + cross_prob) width *= 0.2 + 0.5 * uniform();
+      if (width < 0.0) width = 0.0;
+      if (width > 65535.0) width = 65535.0;
+      push(s, (unsigned int)width, truth);
+    }
+  }
+}
+
+static int load(const char *path)
+{
+  char line[256];
+  FILE *f = fopen(path, "r");
+
+  if (f == NULL) {
+    perror(path);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    double t;
+    unsigned int sensor, width;
+    int truth = -1;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%lf %u %u %d", &t, &sensor, &width, &truth) < 3) continue;
+    if (sensor >= MAX_SENSORS) continue;
+    push(sensor, width > 65535 ? 65535 : width, truth);
+  }
+  fclose(f);
+  return 0;
+}
+
+static int cmp_uint(const void *a, const void *b)
+{
+  unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+  return x < y ? -1 : x > y;
+}
+
+/* Centrirana medijana REF_WINDOW merenja istog senzora, za snimke bez
+   stvarnog rastojanja. */
+static void fill_reference(void)
+{
+  unsigned int s;
+
+  for (s = 0; s < MAX_SENSORS; s++) {
+    size_t *idx = malloc(num_samples * sizeof(size_t)), n = 0, i;
+    if (idx == NULL) exit(1);
+    for (i = 0; i < num_samples; i++)
+      if (samples[i].sensor == s) idx[n++] = i;
+    for (i = 0; i < n; i++) {
+      unsigned int w[REF_WINDOW], m = 0;
+      long j;
+      if (samples[idx[i]].truth_mm >= 0) continue;
+      for (j = (long)i - REF_WINDOW / 2; j <= (long)i + REF_WINDOW / 2; j++) {
+        unsigned int x;
+        if (j < 0 || j >= (long)n) continue;
+        x = samples[idx[j]].width;
+        if (x < US_MIN_US) x = US_MIN_US;
+        if (x > US_MAX_US) x = US_MAX_US;
+        w[m++] = x;
+      }
+      qsort(w, m, sizeof(w[0]), cmp_uint);
+      samples[idx[i]].truth_mm = (int)(w[m / 2] / US_PER_MM);
+    }
+    free(idx);
+  }
+}
+
+typedef struct {
+  long clear, false_stop;
+  long obstacle, missed;
+  long detections, delay_sum;
+  long rejected;
+} Score;
+
+static void evaluate(const FilterCfg *cfg, Score *sc)
+{
+  UsFilterType f[MAX_SENSORS];
+  int inside[MAX_SENSORS] = { 0 };
+  long waiting[MAX_SENSORS];
+  unsigned int s;
+  size_t i;
+
+  memset(sc, 0, sizeof(*sc));
+  for (s = 0; s < MAX_SENSORS; s++) {
+    UsFilterInit(&f[s], cfg->n, cfg->mode);
+    waiting[s] = -1;
+  }
+  for (i = 0; i < num_samples; i++) {
+    const Sample *x = &samples[i];
+    unsigned int mm = (unsigned int)(UsFilterAdd(&f[x->sensor], (uint16_t)x->width) / US_PER_MM);
+    int stop = mm <= MAX_DISTANCE_MM;
+    int truth_in = x->truth_mm <= MAX_DISTANCE_MM;
+
+    if (x->truth_mm > MAX_DISTANCE_MM + MARGIN_MM) {
+      sc->clear++;
+      if (stop) sc->false_stop++;
+    } else if (x->truth_mm < MAX_DISTANCE_MM - MARGIN_MM) {
+      sc->obstacle++;
+      if (!stop) sc->missed++;
+    }
+
+    /* Kasnjenje: od prvog merenja u zoni do prve detekcije. */
+    if (truth_in && !inside[x->sensor]) waiting[x->sensor] = 0;
+    inside[x->sensor] = truth_in;
+    if (waiting[x->sensor] >= 0) {
+      if (stop) {
+        sc->detections++;
+        sc->delay_sum += waiting[x->sensor];
+        waiting[x->sensor] = -1;
+      } else if (truth_in) {
+        waiting[x->sensor]++;
+      } else {
+        waiting[x->sensor] = -1;
+      }
+    }
+  }
+  for (s = 0; s < MAX_SENSORS; s++) sc->rejected += f[s].rejected;
+}
+
+int main(int argc, char **argv)
+{
+  const char *path = NULL;
+  unsigned int seed = 1, sensors = 4, k;
+  double seconds = 600.0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "f:t:r:s:m:x:n:")) != -1) {
+    switch (opt) {
+      case 'f': path = optarg; break;
+      case 't': seconds = atof(optarg); break;
+      case 'r': seed = (unsigned int)atoi(optarg); break;
+      case 's': spike_prob = atof(optarg); break;
+      case 'm': miss_prob = atof(optarg); break;
+      case 'x': cross_prob = atof(optarg); break;
+      case 'n': noise_mm = atof(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-f trace.txt] [-t seconds] [-r seed] [-s spike_prob] [-m miss_prob] "
+                "[-x crosstalk_prob] [-n noise_mm]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  srand(seed);
+  if (path) {
+    if (load(path) != 0) return 1;
+    fill_reference();
+    printf("%s: %zu merenja\n\n", path, num_samples);
+  } else {
+    generate(sensors, seconds);
+    printf("generisano %.0f s, %u senzora, %zu merenja: sum %.0f mm, lazni echo %.1f%%, "
+           "bez odjeka %.1f%%, preslusavanje %.1f%%\n\n", seconds, sensors, num_samples, noise_mm,
+           100.0 * spike_prob, 100.0 * miss_prob, 100.0 * cross_prob);
+  }
+  if (num_samples == 0) return 1;
+
+  printf("%-12s %12s %12s %12s %10s\n", "filtar", "lazno stani", "promaseno", "kasnjenje", "odbaceno");
+  for (k = 0; k < NUM_FILTERS; k++) {
+    Score sc;
+    evaluate(&filters[k], &sc);
+    printf("%-12s %11.2f%% %11.2f%% %8.2f mer %10ld\n", filters[k].name,
+           sc.clear ? 100.0 * sc.false_stop / sc.clear : 0.0,
+           sc.obstacle ? 100.0 * sc.missed / sc.obstacle : 0.0,
+           sc.detections ? (double)sc.delay_sum / sc.detections : 0.0, sc.rejected);
+  }
+  return 0;
+}
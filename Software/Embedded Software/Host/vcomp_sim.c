@@ -0,0 +1,183 @@
+/**
+*   @file:    vcomp_sim.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Model jednog tocka ploce kretanja na razlicitim naponima
+*             baterije, sa i bez kompenzacije iz voltage_comp.c. Petlja je
+*             ista kao u ControlLoop(): 100 Hz, brzina = greska pozicije / 12
+*             (PID_poz), PID1 (Kp=30, Ki=2, Kd=0, integral +-900, izlaz
+*             +-990), mrtva zona +-100. Referentna pozicija je trapezni
+*             profil kao iz tabela ubrzanja. Motor je prvog reda: brzina u
+*             ustaljenom stanju je srazmerna PWM-u puta naponu na motoru,
+*             napon pada na unutrasnjoj otpornosti baterije, a glavna ploca
+*             salje izmereni napon svakih 500 ms.
+*
+*             Za svaki napon ispisuje brzinu pri stalnom PWM-u od 600 (bez
+*             povratne sprege, tu se napon najvise vidi), a za pomeraj u
+*             zatvorenoj petlji trajanje, preskok, najvecu gresku pracenja i
+*             gresku na kraju.
+*
+*             gcc -std=c99 -O2 -I"../Motion Board" -o vcomp_sim vcomp_sim.c "../Motion Board/voltage_comp.c"
+*/
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "voltage_comp.h"
+
+#define DT_S            0.01     // SysTick ploce kretanja.
+#define LENGTH_CONST    120.48   // Impulsa enkodera po cm, kao na glavnoj ploci.
+#define SUPPLY_TICKS    50       // 500 ms izmedju poruka sa naponom.
+
+/* Motor i baterija. */
+static double counts_per_volt = 6.5;   // Impulsa po periodi po voltu na motoru.
+static double tau_s = 0.08;            // Vremenska konstanta motora.
+static double r_int = 0.15;            // Unutrasnja otpornost baterije i kablova.
+static double i_stall = 6.0;           // Struja pri punom PWM-u iz mirovanja, pri 11.1 V.
+
+/* Profil. */
+static double move_cm = 100.0;
+static double cruise = 45.0;           // Impulsa po periodi.
+static double accel = 1.5;             // Impulsa po periodi na kvadrat.
+
+typedef struct {
+  double Int;
+  int prev;
+} Pid;
+
+/* PID1 iz stm32f10x_it_stu.c. */
+static int pid1(Pid *p, int zeljena, int trenutna, int profile_speed)
+{
+  const double Kp = 30, Ki = 2, Kd = 0;
+  int greska = zeljena - trenutna, Reg;
+
+  p->Int += Ki * greska;
+  if (p->Int > 900) p->Int = 900;
+  if (p->Int < -900) p->Int = -900;
+  Reg = (int)(Kp * greska + Kd * (greska - p->prev) + p->Int);
+  if (Reg > 990) Reg = 990;
+  if (Reg < -990) Reg = -990;
+  if (greska < 1 && greska > -1 && profile_speed == 0) {
+    Reg = 0;
+    p->Int = 0;
+  }
+  p->prev = greska;
+  return Reg;
+}
+
+typedef struct {
+  double time_s;
+  double overshoot;
+  double max_lag;
+  double final_err;
+} Result;
+
+static void simulate(double v_open, int compensate, Result *r)
+{
+  const double target = move_cm * LENGTH_CONST;
+  double ref = 0.0, speed_ref = 0.0, pos = 0.0, omega = 0.0, v_bat = v_open;
+  double settled_at = -1.0;
+  long enc_old = 0;
+  int tick;
+  Pid pid = { 0, 0 };
+
+  vcomp_gain = VCOMP_UNITY;
+  r->overshoot = 0.0;
+  r->max_lag = 0.0;
+
+  for (tick = 0; tick < 2000; tick++) {
+    /* Trapezni profil reference. */
+    double remaining = target - ref;
+    if (remaining <= 0.0) speed_ref = 0.0;
+    else if (speed_ref * speed_ref / (2.0 * accel) >= remaining) speed_ref -= accel;
+    else if (speed_ref < cruise) speed_ref += accel;
+    if (speed_ref < 0.0) speed_ref = 0.0;
+    ref += speed_ref;
+    if (ref > target) ref = target;
+
+    if (compensate && tick % SUPPLY_TICKS == 0) VoltageCompSet((unsigned int)(v_bat * 1000.0));
+
+    long enc = (long)pos;
+    int brzina = (int)((ref - enc) / 12.0);
+    int pwm = pid1(&pid, brzina, (int)(enc - enc_old), (int)speed_ref);
+    enc_old = enc;
+    if (compensate) pwm = VoltageCompApply(pwm);
+
+    /* Mrtva zona: oba pina smera na nuli, motor koci. */
+    double duty = (pwm > 100 || pwm < -100) ? pwm / 1000.0 : 0.0;
+    double current = i_stall * duty * (1.0 - omega / (counts_per_volt * v_bat + 1e-9));
+    v_bat = v_open - r_int * (current < 0 ? -current : current);
+    double omega_target = counts_per_volt * v_bat * duty;
+    omega += (omega_target - omega) * (DT_S / tau_s);
+    pos += omega;
+
+    double lag = ref - pos;
+    if (lag > r->max_lag) r->max_lag = lag;
+    if (pos - target > r->overshoot) r->overshoot = pos - target;
+    double err = pos - target;
+    if (err < 0) err = -err;
+    if (err < 0.5 * LENGTH_CONST) {
+      if (settled_at < 0.0) settled_at = tick * DT_S;
+    } else {
+      settled_at = -1.0;
+    }
+  }
+  r->time_s = settled_at;
+  r->final_err = (pos - target) / LENGTH_CONST;
+}
+
+/* Brzina posle 1 s pri stalnom PWM-u, cm/s. */
+static double open_loop_speed(double v_open, int pwm_cmd, int compensate)
+{
+  double omega = 0.0, v_bat = v_open;
+  int tick;
+
+  vcomp_gain = VCOMP_UNITY;
+  if (compensate) VoltageCompSet((unsigned int)(v_open * 1000.0));
+  for (tick = 0; tick < 100; tick++) {
+    int pwm = compensate ? VoltageCompApply(pwm_cmd) : pwm_cmd;
+    double duty = pwm / 1000.0;
+    double current = i_stall * duty * (1.0 - omega / (counts_per_volt * v_bat + 1e-9));
+    v_bat = v_open - r_int * current;
+    omega += (counts_per_volt * v_bat * duty - omega) * (DT_S / tau_s);
+  }
+  return omega / DT_S / LENGTH_CONST;
+}
+
+int main(int argc, char **argv)
+{
+  double v, v_min = 10.2, v_max = 12.6, step = 0.4;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:c:r:")) != -1) {
+    switch (opt) {
+      case 'd': move_cm = atof(optarg); break;
+      case 'c': cruise = atof(optarg); break;
+      case 'r': r_int = atof(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-d cm] [-c cruise_counts_per_tick] [-r r_int_ohm]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  printf("pomeraj %.0f cm, krstarenje %.0f imp/10 ms, nominalni napon %.1f V\n\n", move_cm, cruise,
+         VCOMP_NOMINAL_MV / 1000.0);
+  printf("%6s | %35s | %35s\n", "", "bez kompenzacije", "sa kompenzacijom");
+  printf("%6s | %6s %6s %6s %6s %6s | %6s %6s %6s %6s %6s\n", "V", "v600", "t[s]", "pres.", "kasn.", "kraj",
+         "v600", "t[s]", "pres.", "kasn.", "kraj");
+  printf("%6s | %6s %6s %6s %6s %6s | %6s %6s %6s %6s %6s\n", "", "[cm/s]", "", "[cm]", "[cm]", "[cm]",
+         "[cm/s]", "", "[cm]", "[cm]", "[cm]");
+  for (v = v_min; v <= v_max + 1e-9; v += step) {
+    Result a, b;
+    simulate(v, 0, &a);
+    simulate(v, 1, &b);
+    printf("%6.1f | %6.1f %6.2f %6.2f %6.2f %6.2f | %6.1f %6.2f %6.2f %6.2f %6.2f\n", v,
+           open_loop_speed(v, 600, 0), a.time_s, a.overshoot / LENGTH_CONST, a.max_lag / LENGTH_CONST, a.final_err,
+           open_loop_speed(v, 600, 1), b.time_s, b.overshoot / LENGTH_CONST, b.max_lag / LENGTH_CONST, b.final_err);
+  }
+  return 0;
+}
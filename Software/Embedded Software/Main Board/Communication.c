@@ -3,6 +3,7 @@
 #include "stm32f10x_conf.h"
 #include "EUROBOT_Init.h"
 #include "Communication.h"
+#include "scheduler.h"
 
 /* Private define ------------------------------------------------------------*/
 
@@ -10,6 +11,16 @@
 #define MOTION_DEVICE_ADDRESS 0x0A
 #define LENGTH_CONST 120.48
 #define ANGLE_CONST 16.05
+#define COMMAND_RETRY_MS 25
+#define BUS_REPLY_MS 5
+
+/* Centar robota u levoj startnoj zoni, u mm od ugla stola, i ugao u
+   stepenima (0 gleda u +Y, 90 ka sredini stola). Desna zona je u ogledalu
+   preko X = TABLE_WIDTH_MM / 2. */
+#define TABLE_WIDTH_MM 3000
+#define START_X_MM 200
+#define START_Y_MM 1000
+#define START_THETA_DEG 90
 
 /* Private variables ---------------------------------------------------------*/
 
@@ -20,7 +31,14 @@ int sending_length = 0;
 char receive_array[ MAX_TRANS_SIZE ];
 bool FLAG_ackReceived = FALSE;
 bool FLAG_arriveOnDest = FALSE;
+bool FLAG_corridorReceived = FALSE;
+uint16_t corridor_free_cm = 0;
 uint16_t command_ID = 1;
+static CommandNameType pending_command;
+static uint16_t pending_data;
+static bool FLAG_commandPending = FALSE;
+static volatile bool FLAG_replyPending = FALSE;
+static volatile uint32_t reply_start;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -51,6 +69,9 @@ void issueCommand( CommandNameType command, int receiver_address, uint16_t data
     case ULTRASOUND_OFF:
       issueSimpleCommand( 0x12 );
       break;
+    case WALL_TARGET:
+      issueSimpleCommand( 0x13 );
+      break;
     case PRESCALER:
       issueComplexCommand( 0xFB, data );
       break;
@@ -69,6 +90,22 @@ void issueCommand( CommandNameType command, int receiver_address, uint16_t data
     case START_RUNNING:
       issueSimpleCommand( 0xFA );
       break;
+    case SUPPLY_VOLTAGE:
+      issueComplexCommand( 0xEE, data );
+      break;
+    case CORRIDOR_CHECK:
+      FLAG_corridorReceived = FALSE;
+      issueComplexCommand( 0xE3, data );
+      break;
+    case SET_POSITION:
+      /* Ploca kretanja racuna polozaj u impulsima trajektorije. */
+      if( data == START_POSE_RIGHT )
+        issuePositionCommand( 0x01, (long)( ( TABLE_WIDTH_MM - START_X_MM ) * LENGTH_CONST / 10 ),
+                              (long)( START_Y_MM * LENGTH_CONST / 10 ), 360 - START_THETA_DEG );
+      else
+        issuePositionCommand( 0x01, (long)( START_X_MM * LENGTH_CONST / 10 ),
+                              (long)( START_Y_MM * LENGTH_CONST / 10 ), START_THETA_DEG );
+      break;
     default:
       issueSimpleCommand( 0xFC );
       break;
@@ -114,6 +151,27 @@ void issueComplexCommand( char command, uint16_t data )
 /*----------------------------------------------------------------------------*/
 
 
+/**
+  * @brief  Izdavanje naredbe sa tri 32-bitna podatka, po osam nibl-ova od
+  *         najnizeg. Ploca kretanja ih cita sa ReadData32().
+  * @param  command predstavlja kod komande.
+  * @param  x, y predstavljaju polozaj u impulsima trajektorije.
+  * @param  theta predstavlja ugao u stepenima.
+  * @retval Nema.
+  */
+void issuePositionCommand( char command, long x, long y, long theta )
+{
+  long data[ 3 ] = { x, y, theta };
+
+  sending_array[ 2 ] = 26;
+  sending_array[ 3 ] = command;
+  for( int i = 0; i < 24; i++ )
+    sending_array[ 4 + i ] = ( char )( ( (unsigned long)data[ i / 8 ] >> ( 4 * ( i % 8 ) ) ) & 0x000F );
+  checkAndSend();
+}
+/*----------------------------------------------------------------------------*/
+
+
 /**
   * @brief  Generisanje check sume i zapocinjanje slanja poruke.
   * @param  Nema.
@@ -127,6 +185,10 @@ void checkAndSend( void )
   for( int i = 1; i < n; i++ ) check_sum += ( sending_array[ i ] & 0xFF );                                               
   sending_array[ n ] = ( check_sum & 0x7F );
   
+  /* Ploca kretanja odgovara na svaku poruku, do odgovora magistrala je zauzeta. */
+  reply_start = sched_ms;
+  FLAG_replyPending = TRUE;
+  
   /* Zapocni slanje poruke. */
   GPIO_SetBits( GPIOC, GPIO_Pin_12 ); // Otvaranje magistrale za slanje pomocu RS485.
   sending_iterator = 0;
@@ -217,6 +279,8 @@ void decodeMessage( void )
   /* Provera da li je podatak stigao sa ploce za kretanje. */
   if(receive_array[ 1 ] == MOTION_DEVICE_ADDRESS | 0x40 )
   {
+    FLAG_replyPending = FALSE;
+    
     /* Provera da li je pristigla poruka acknowledge signal. */
     if(receive_array[ 2 ] == 1)
     {
@@ -230,6 +294,14 @@ void decodeMessage( void )
       FLAG_arriveOnDest = (bool)temp_flag;
     }
     
+    /* Odgovor na CORRIDOR_CHECK, slobodan put u cm iz mreze zauzetosti ploce kretanja. */
+    else if( receive_array[ 2 ] == 5 )
+    {
+      corridor_free_cm = receive_array[ 3 ] | ( receive_array[ 4 ] << 4 ) | ( receive_array[ 5 ] << 8 ) |
+                         ( receive_array[ 6 ] << 12 );
+      FLAG_corridorReceived = TRUE;
+    }
+    
     /* Slucaj ako nije nijedna od vazecih poruka. Ovde ne bi trebao da ulazi. */
     else
     {
@@ -241,4 +313,75 @@ void decodeMessage( void )
   {
   }
     
-}
\ No newline at end of file
+}
+/*----------------------------------------------------------------------------*/
+
+
+/**
+  * @brief  Da li je magistrala slobodna. DE pin se gasi u USART3 prekidu
+  *         tek kada je poslednji bajt poruke poslat, a posle toga se ceka
+  *         odgovor ploce kretanja najvise BUS_REPLY_MS od pocetka slanja.
+  *         Tako commandThread i provera dolaska iz druge niti ne salju preko
+  *         odgovora.
+  * @param  Nema.
+  * @retval TRUE ako se nista ne salje i ne ceka se odgovor.
+  */
+bool busIdle( void )
+{
+  if( GPIO_ReadOutputDataBit( GPIOC, GPIO_Pin_12 ) != Bit_RESET ) return FALSE;
+  return !FLAG_replyPending || ( sched_ms - reply_start ) >= BUS_REPLY_MS;
+}
+/*----------------------------------------------------------------------------*/
+
+
+/**
+  * @brief  Zadaje komandu ploci kretanja. Nova komanda zamenjuje onu koja
+  *         jos nije potvrdjena.
+  * @param  command predstavlja komandu.
+  * @param  data predstavlja podatak koji se salje u sklopu komande.
+  * @retval Nema.
+  */
+void commandStart( CommandNameType command, uint16_t data )
+{
+  pending_command = command;
+  pending_data = data;
+  FLAG_commandPending = TRUE;
+}
+/*----------------------------------------------------------------------------*/
+
+
+bool commandDone( void )
+{
+  return !FLAG_commandPending;
+}
+/*----------------------------------------------------------------------------*/
+
+
+/**
+  * @brief  Salje zadatu komandu i ponavlja je svakih COMMAND_RETRY_MS dok ne
+  *         stigne acknowledge, kao ranije waitAck(), ali bez blokiranja.
+  * @param  pt predstavlja stanje niti.
+  * @retval Stanje niti.
+  */
+PT_THREAD( commandThread( struct pt *pt ) )
+{
+  static TimerType retry;
+
+  PT_BEGIN( pt );
+  while( TRUE )
+  {
+    PT_WAIT_UNTIL( pt, FLAG_commandPending && busIdle() );
+    FLAG_ackReceived = FALSE;
+    issueCommand( pending_command, MOTION_DEVICE_ADDRESS, pending_data );
+    timerSet( &retry, COMMAND_RETRY_MS );
+    PT_WAIT_UNTIL( pt, FLAG_ackReceived || timerExpired( &retry ) );
+    if( FLAG_ackReceived )
+    {
+      FLAG_ackReceived = FALSE;
+      FLAG_commandPending = FALSE;
+      command_ID++;
+    }
+  }
+  PT_END( pt );
+}
+/*----------------------------------------------------------------------------*/
@@ -1,6 +1,8 @@
 #ifndef __COMMUNICATION_H__
 #define __COMMUNICATION_H__
 
+#include "pt.h"
+
 /* Moguce komande. */
 typedef enum
 {
@@ -13,9 +15,19 @@ typedef enum
   ROTATE_RIGHT,
   CHECK_ARRIVE,
   STOP,
-  START_RUNNING
+  START_RUNNING,
+  SUPPLY_VOLTAGE,
+  CORRIDOR_CHECK,     // Podatak je duzina u cm, CORRIDOR_BACKWARD za hodnik iza robota.
+  SET_POSITION,       // Podatak je START_POSE_*, poza u koordinatama stola.
+  WALL_TARGET         // Cilj sledeceg pokreta je zid ili kucica.
 } CommandNameType;
 
+#define CORRIDOR_BACKWARD 0x8000
+
+/* Startne poze za SET_POSITION. */
+#define START_POSE_LEFT   0
+#define START_POSE_RIGHT  1
+
 typedef enum
 {
   FIRST_BYTE,
@@ -31,12 +43,22 @@ void issueCommand(CommandNameType command, int receiver_address, uint16_t data )
 void issueSimpleCommand( char command );
 /* Izdavanje naredbe u kojoj se, pored same komande, salje i neki podatak. */
 void issueComplexCommand( char command, uint16_t data );
+/* Izdavanje naredbe sa pozom robota (x, y, ugao), tri 32-bitna podatka. */
+void issuePositionCommand( char command, long x, long y, long theta );
 /* Generisanje check sume i zapocinjanje slanja poruke. */
 void checkAndSend( void );
 /* Prijem poruke. */
 void receiveByte( uint16_t received_byte );
 /* Dekodovanje primljene poruke. */
 void decodeMessage( void );
+/* Da li je magistrala slobodna (DE pin ugasen). */
+bool busIdle( void );
+/* Zadaje komandu koju commandThread salje dok ne stigne acknowledge. */
+void commandStart( CommandNameType command, uint16_t data );
+/* Da li je poslednja zadata komanda potvrdjena. */
+bool commandDone( void );
+/* Nit koja salje zadatu komandu i ponavlja je na COMMAND_RETRY_MS. */
+PT_THREAD( commandThread( struct pt *pt ) );
 
 
 #endif
\ No newline at end of file
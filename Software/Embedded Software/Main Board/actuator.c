@@ -0,0 +1,89 @@
+/**
+*   @file:    actuator.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kanali izvrsnih organa, videti actuator.h.
+*/
+
+#include "stm32f10x_conf.h"
+#include "Communication.h"
+#include "scheduler.h"
+#include "actuator.h"
+
+#define MOTION_DEVICE_ADDRESS ( 0x0A )
+
+extern bool FLAG_arriveOnDest;
+
+static bool FLAG_motionBusy = FALSE;
+static uint16_t motion_timeout;
+static uint16_t motion_settle;
+static TimerType settle_timer = { 0, 0 };
+static TimerType servo_timer = { 0, 0 };
+
+/*----------------------------------------------------------------------------*/
+void motionStart( uint16_t timeout_ms, uint16_t settle_ms )
+{
+  /* Odgovor na CHECK_ARRIVE od pre ove komande ne vazi. */
+  FLAG_arriveOnDest = FALSE;
+  motion_timeout = timeout_ms;
+  motion_settle = settle_ms;
+  FLAG_motionBusy = TRUE;
+}
+/*----------------------------------------------------------------------------*/
+bool motionReady( void )
+{
+  return !FLAG_motionBusy && timerExpired( &settle_timer );
+}
+/*----------------------------------------------------------------------------*/
+void servoStart( uint16_t ccr, uint16_t move_ms )
+{
+  TIM3->CCR3 = ccr;
+  timerSet( &servo_timer, move_ms );
+}
+/*----------------------------------------------------------------------------*/
+bool actuatorIdle( uint8_t channels )
+{
+  if ( ( channels & ACT_MOTION ) && FLAG_motionBusy ) return FALSE;
+  if ( ( channels & ACT_SERVO ) && !timerExpired( &servo_timer ) ) return FALSE;
+  return TRUE;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Dok je kretanje zadato, salje CHECK_ARRIVE svakih MOTION_POLL_MS.
+  *         Ako robot ne stigne za motion_timeout, salje STOP i oslobadja
+  *         kanal. STOP se zadaje tek kada commandThread zavrsi komandu neke
+  *         druge niti, da je ne bi zamenio.
+  * @param  pt predstavlja stanje niti.
+  * @retval Stanje niti.
+  */
+PT_THREAD( motionThread( struct pt *pt ) )
+{
+  static TimerType poll, timeout;
+
+  PT_BEGIN( pt );
+  while ( TRUE )
+  {
+    PT_WAIT_UNTIL( pt, FLAG_motionBusy );
+    timerSet( &timeout, motion_timeout );
+    while ( TRUE )
+    {
+      PT_WAIT_UNTIL( pt, busIdle() );
+      issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
+      timerSet( &poll, MOTION_POLL_MS );
+      PT_WAIT_UNTIL( pt, timerExpired( &poll ) );
+      if ( FLAG_arriveOnDest ) break;
+      if ( motion_timeout != MOTION_NO_TIMEOUT && timerExpired( &timeout ) )
+      {
+        /* Robot je zaglavljen, odustaje se od kretanja. */
+        PT_WAIT_UNTIL( pt, commandDone() );
+        commandStart( STOP, 1 );
+        PT_WAIT_UNTIL( pt, commandDone() );
+        break;
+      }
+    }
+    timerSet( &settle_timer, motion_settle );
+    FLAG_motionBusy = FALSE;
+  }
+  PT_END( pt );
+}
@@ -0,0 +1,40 @@
+/**
+*   @file:    actuator.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kanali izvrsnih organa glavne ploce: kretanje (ploca kretanja)
+*             i servo na TIM3 CCR3. Komanda kanalu se samo zada, a kanal je
+*             zauzet dok se pokret ne zavrsi, pa misija moze da radi druge
+*             korake za to vreme. Na dolazak u poziciju ceka motionThread,
+*             koji proverava CHECK_ARRIVE i salje STOP posle timeout-a.
+*             Ultrazvucni senzori i preskaler su samo poruke ploci kretanja
+*             i nemaju svoj kanal.
+*/
+
+#ifndef __ACTUATOR_H__
+#define __ACTUATOR_H__
+
+#include "stm32f10x.h"
+#include "pt.h"
+
+/* Kanali, maska za actuatorIdle(). */
+#define ACT_MOTION  0x01
+#define ACT_SERVO   0x02
+
+#define MOTION_POLL_MS      100   // Period slanja CHECK_ARRIVE.
+#define MOTION_NO_TIMEOUT   0
+
+/* Komanda kretanja je potvrdjena, kanal je zauzet do dolaska u poziciju.
+   Posle dolaska se jos settle_ms ne zadaje novo kretanje. */
+void motionStart( uint16_t timeout_ms, uint16_t settle_ms );
+/* Robot je stigao i smirio se, moze novo kretanje. */
+bool motionReady( void );
+/* Postavlja CCR3 servoa, kanal je zauzet move_ms. */
+void servoStart( uint16_t ccr, uint16_t move_ms );
+/* Da li su svi kanali iz maske slobodni. */
+bool actuatorIdle( uint8_t channels );
+/* Nit koja ceka dolazak u poziciju. */
+PT_THREAD( motionThread( struct pt *pt ) );
+
+#endif
@@ -0,0 +1,40 @@
+/**
+*   @file:    ir_lut.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Inverzna karakteristika IR senzora, ADC -> mm. Generise
+*             Host/ir_lut_gen.c iz merenja, ne menjati rucno.
+*             Tacke (mm: ADC):
+*               100: 3449, 120: 3023, 140: 2589, 160: 2202, 180: 1958,
+*               210: 1598, 240: 1465, 260: 1349, 300: 1174, 400: 1033,
+*               500: 934, 600: 889, 700: 865, 800: 852
+*             Najveca greska interpolacije 9.0 mm (ADC 865).
+*/
+
+#include "ir_sensor.h"
+
+#if IR_LUT_SHIFT != 4
+#error "ir_lut.c je generisan za IR_LUT_SHIFT 4"
+#endif
+
+const uint16_t ir_lut_raw_near = 3449;
+const uint16_t ir_lut_raw_far = 852;
+
+const uint16_t ir_lut[ 164 ] =
+{
+  800, 688, 621, 576, 540, 504, 486, 470, 454, 437, 421, 405,
+  392, 381, 370, 358, 347, 335, 324, 313, 301, 297, 293, 289,
+  286, 282, 279, 275, 271, 268, 264, 260, 257, 255, 252, 249,
+  246, 244, 241, 238, 234, 230, 227, 223, 220, 216, 212, 210,
+  208, 207, 206, 204, 203, 202, 200, 199, 198, 196, 195, 194,
+  192, 191, 190, 188, 187, 186, 184, 183, 182, 180, 179, 178,
+  176, 175, 174, 172, 171, 170, 168, 167, 166, 164, 163, 162,
+  160, 159, 159, 158, 157, 156, 155, 155, 154, 153, 152, 151,
+  150, 150, 149, 148, 147, 146, 145, 145, 144, 143, 142, 141,
+  140, 140, 139, 138, 137, 137, 136, 135, 135, 134, 133, 132,
+  132, 131, 130, 129, 129, 128, 127, 126, 126, 125, 124, 123,
+  123, 122, 121, 121, 120, 119, 118, 118, 117, 116, 115, 115,
+  114, 113, 112, 112, 111, 110, 109, 108, 108, 107, 106, 105,
+  105, 104, 103, 102, 102, 101, 100, 100
+};
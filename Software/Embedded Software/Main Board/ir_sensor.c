@@ -0,0 +1,71 @@
+/**
+*   @file:    ir_sensor.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   IR senzori rastojanja, videti ir_sensor.h.
+*/
+
+#include "ir_sensor.h"
+#include "power_monitor.h"
+
+/* Mesto senzora u jednom skeniranju ADC-a. */
+static const uint8_t ir_scan[ IR_NUM ] = { 0, 1 };
+
+volatile uint16_t ir_raw[ IR_NUM ];
+volatile uint16_t ir_distance_mm[ IR_NUM ] = { IR_FAR, IR_FAR };
+
+static uint32_t ir_sum[ IR_NUM ];
+static uint8_t ir_halves = 0;
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Pretvara ADC vrednost u rastojanje.
+  * @param  raw: 12-bitna ADC vrednost.
+  * @retval Rastojanje u mm, IR_NEAR_MM ili IR_FAR van opsega merenja.
+  */
+uint16_t irLookup( uint16_t raw )
+{
+  uint16_t k, frac;
+  int32_t lo, hi;
+
+  if ( raw >= ir_lut_raw_near ) return IR_NEAR_MM;
+  if ( raw < ir_lut_raw_far ) return IR_FAR;
+
+  k = ( raw - ir_lut_raw_far ) >> IR_LUT_SHIFT;
+  frac = ( raw - ir_lut_raw_far ) & ( ( 1 << IR_LUT_SHIFT ) - 1 );
+  lo = ir_lut[ k ];
+  hi = ir_lut[ k + 1 ];
+  return (uint16_t)( lo + ( hi - lo ) * frac / ( 1 << IR_LUT_SHIFT ) );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Sabira IR kanale jedne polovine DMA bafera, posle IR_DECIMATION
+  *         uzoraka objavljuje srednju vrednost i rastojanje.
+  * @param  scans: prvo skeniranje polovine.
+  * @retval Nema.
+  */
+void irSensorHalf( const vu16 *scans )
+{
+  uint8_t i, s;
+
+  for ( s = 0; s < IR_NUM; s++ )
+  {
+    const vu16 *p = scans + ir_scan[ s ];
+    uint32_t sum = 0;
+    for ( i = 0; i < PM_SCANS_HALF; i++, p += PM_SCAN_CHANNELS ) sum += *p;
+    ir_sum[ s ] += sum;
+  }
+
+  if ( ++ir_halves == IR_DECIMATION / PM_SCANS_HALF )
+  {
+    for ( s = 0; s < IR_NUM; s++ )
+    {
+      ir_raw[ s ] = (uint16_t)( ir_sum[ s ] / IR_DECIMATION );
+      ir_distance_mm[ s ] = irLookup( ir_raw[ s ] );
+      ir_sum[ s ] = 0;
+    }
+    ir_halves = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
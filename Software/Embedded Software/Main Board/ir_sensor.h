@@ -0,0 +1,52 @@
+/**
+*   @file:    ir_sensor.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   IR senzori rastojanja (10..80 cm). Izlazi senzora su kanali
+*             ADC-a koje vec skenira DMA iz power_monitor.h, pa se ovde samo
+*             sabira IR_DECIMATION uzoraka po senzoru u istom prekidu DMA-a
+*             (srednja vrednost, 12 bita kao u merenjima) i pretvara u mm
+*             tabelom ir_lut.c: indeks je ( ADC - ir_lut_raw_far ) >>
+*             IR_LUT_SHIFT, a izmedju dve vrednosti tabele se interpolira,
+*             bez pretrage i deljenja. Tabelu generise Host/ir_lut_gen.c iz
+*             Misc/IR-senzor/ZavisnostIr.m.
+*
+*             Novi senzor: kanal u skeniranju ADC-a (main_MainStateMachine.c,
+*             PM_SCAN_CHANNELS), red u enum-u i u tabeli ir_scan[] u
+*             ir_sensor.c.
+*/
+
+#ifndef __IR_SENSOR_H__
+#define __IR_SENSOR_H__
+
+#include "stm32f10x.h"
+
+/* Senzori, indeksi u ir_distance_mm[]. */
+enum
+{
+  IR_LEFT,            // ADC kanal 12 - PC2.
+  IR_RIGHT,           // ADC kanal 13 - PC3.
+  IR_NUM
+};
+
+#define IR_DECIMATION   256       // Uzoraka po rezultatu, 625 rezultata u sekundi.
+#define IR_LUT_SHIFT    4         // Korak tabele je 16 ADC kodova.
+#define IR_NEAR_MM      100       // Blize od opsega merenja.
+#define IR_FAR          0xFFFF    // Dalje od opsega merenja ili nema prepreke.
+
+/* Tabela iz ir_lut.c. */
+extern const uint16_t ir_lut_raw_near;    // ADC na najmanjem rastojanju.
+extern const uint16_t ir_lut_raw_far;     // ADC na najvecem rastojanju.
+extern const uint16_t ir_lut[];
+
+/* Poslednja filtrirana ADC vrednost i rastojanje po senzoru. */
+extern volatile uint16_t ir_raw[ IR_NUM ];
+extern volatile uint16_t ir_distance_mm[ IR_NUM ];
+
+/* Poziva se iz DMA1_Channel1_IRQHandler-a za popunjenu polovinu bafera. */
+void irSensorHalf( const vu16 *scans );
+/* ADC u mm. IR_NEAR_MM blize od opsega, IR_FAR dalje. */
+uint16_t irLookup( uint16_t raw );
+
+#endif
@@ -2,16 +2,18 @@
 #include "stm32f10x_conf.h"
 #include "EUROBOT_Init.h"
 #include "Communication.h"
+#include "scheduler.h"
+#include "actuator.h"
+#include "mission.h"
+#include "power_monitor.h"
 
 #define MOTION_DEVICE_ADDRESS ( 0x0A )
+#define BATTERY_PERIOD_MS     ( 100 )
+#define SUPPLY_PERIOD_MS      ( 500 )
 
 /* GLobal variables ----------------------------------------------------------*/
 
-extern bool FLAG_arriveOnDest;
-extern bool FLAG_ackReceived;
 bool FLAG_strategyLeft = TRUE;
-extern int global_tick;
-extern uint16_t command_ID;
 int state_robot = 0;
 
 bool flag_go_to_stop;
@@ -20,15 +22,23 @@ bool flag_go_to_stop;
 
 void initTimerServo( void );
 
-void waitAck( CommandNameType, int, uint16_t );
-void initTimer90( void );
-void initTimerSleep( void );
-void sleep( int );
 void checkStrategy( void );
+PT_THREAD( matchThread( struct pt *pt ) );
+PT_THREAD( batteryThread( struct pt *pt ) );
 void UsartInit ( void );
 
+/* Niti, redosled je redosled pozivanja u krugu. */
+enum { TASK_COMMAND, TASK_MOTION, TASK_MISSION, TASK_MATCH, TASK_BATTERY, TASK_NUM };
+static TaskType tasks[ TASK_NUM ] =
+{
+  { commandThread },
+  { motionThread },
+  { missionThread },
+  { matchThread },
+  { batteryThread }
+};
+
 #define ADC1_DR_Address    ((u32)0x4001244C) 
-  vu16 ADC_RegularConvertedValueTab[4];
   
   void DisplayBarGraph(unsigned char disp);//prototip funkcije, opseg 0-7
   void DisplayBarGraphBinary(unsigned char disp);//prototip funkcije, opseg 0-255
@@ -36,9 +46,6 @@ void UsartInit ( void );
   void BateryDisp (void);
   unsigned char test=0;
   
-  float baterija_Acc, servo_5V;
-  float baterija_Acc_const, servo_5V_const;
-  
   //Deklaracija struktura za razne periferije
   GPIO_InitTypeDef GPIO_InitStructure;
   TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
@@ -88,9 +95,9 @@ int main( void )
   /* DMA1 channel1 configuration ----------------------------------------------*/
   DMA_DeInit(DMA1_Channel1);
   DMA_InitStructure.DMA_PeripheralBaseAddr = ADC1_DR_Address;//adresa izvorista za dma prenos - DATA REGISTER ADC-a
-  DMA_InitStructure.DMA_MemoryBaseAddr = (u32)ADC_RegularConvertedValueTab;
+  DMA_InitStructure.DMA_MemoryBaseAddr = (u32)adc_dma_buffer;//vise skeniranja, filtrira ih power_monitor.c
   DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
-  DMA_InitStructure.DMA_BufferSize = 4;
+  DMA_InitStructure.DMA_BufferSize = PM_DMA_LENGTH;
   DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
   DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
   DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
@@ -99,6 +106,12 @@ int main( void )
   DMA_InitStructure.DMA_Priority = DMA_Priority_High;
   DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
   DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+  DMA_ITConfig(DMA1_Channel1, DMA_IT_HT | DMA_IT_TC, ENABLE);//prekid na pola i na kraju bafera
+  NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel1_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0x0F;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x0F;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
   /* Enable DMA1 channel1 */
   DMA_Cmd(DMA1_Channel1, ENABLE);
   
@@ -139,8 +152,6 @@ int main( void )
   TIM_Cmd(TIM1, ENABLE);//dozovla rada tajmera tek kada se konfigurisu i DMA i ADC
   TIM_CtrlPWMOutputs(TIM1, ENABLE);//generisanje PWM izlaza za tajmer 1
   
-  baterija_Acc_const=0.004032;
-  servo_5V_const=0.004032;
   
   
   
@@ -152,415 +163,76 @@ int main( void )
   UsartInit();
   
   /* Inicijalizacija glavnog tajmera. */
-  initTimerServo();//zbog ovoga se baterija meri i dok je prekidac uvucen
+  initTimerServo();
   
-  /* Glavna masina stanja. */
-  while(1)
-  {
-    switch (state_robot)
-    {
-      /* Pocetno stanje u kome se inicijalizaciju sistemi, podesava preskaler, ukljucuje UV. */ 
-      case 0:  // pocetno stanje, sve inicijalizujemo i krenemo napred
-        
-        if (GPIO_ReadInputDataBit(GPIOB, GPIO_Pin_11)) // ako je ocitano Vcc, tj. krene se sa izvrsavanjem, u suprotnom ostajemo u 
-                                                       // istom stanju
-        {
-          /* Inicijalizacija glavnog tajmera. */
-          initTimer90();
-          /* Inicijalizacija tajmera za proveru pozicije robota. */
-          SysTick_Config( SysTick_Config( SystemCoreClock / 1000 ) );
-          /* Provera koja je stategije. */
-          checkStrategy();
-          /* Zadavanje komandi. */
-          issueCommand( START_RUNNING, MOTION_DEVICE_ADDRESS, 30 );
-          waitAck( START_RUNNING, MOTION_DEVICE_ADDRESS, 30 );
-          issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 1000 );
-          waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 1000 );
-          issueCommand( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-          waitAck( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-          issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 30 );
-          waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 30 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 25 );            
-            if ( FLAG_arriveOnDest ) break;
-            sleep( 100 );
-          }
-          state_robot++;
-          sleep(100);
-        }
-        break;
-      
-      /* Blago okretanje da bi se izbegla ivica na sredini terena. */  
-      case 1:
-        
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 20 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 20 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 25 );
-            if ( FLAG_arriveOnDest ) break;
-            sleep( 100 );
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 20 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 20 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 25 );
-            if ( FLAG_arriveOnDest ) break;
-            sleep( 100 );
-          }
-        }
-        
-        state_robot++;
-        sleep(100);
-        break;
-       
-      /* Blago pomeranje napred, ka sredini terena. */
-      case 2:
-      {
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 50 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 50 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;          
-        }
-        state_robot++;
-        sleep(100);
-        break;       
-      }
-        
-      /* Blaga rotacija da bi se poravnali opet. */  
-      case 3:
-
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 25 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 25 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 25 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 25 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }          
-        }
-        state_robot++;
-        sleep(100);
-        break;
-
-      /* Blago pomeranje napred da bi pomerili kocke u sredinu terena.  */
-      case 4:
-        
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 10 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 10 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break;
-        
-      /* Vracanje unazad. */
-      case 5:
-        
-        issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        issueCommand( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 50 );
-        waitAck( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 50 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break;  
-        
-      /* Okretanje ka prvoj kucici, onoj daljoj od ivice terana i gasenje senzora. */
-      case 6:
-        
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 175 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 175 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 175 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 175 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }          
-        } 
-        
-        issueCommand( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        waitAck( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        
-        state_robot++;
-        sleep(100);
-        break;
-      
-      /* Zatvaranje prvih vrata. */
-      case 7:
-        
-        issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 700 );
-        waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 700 );
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 100 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 100 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break;        
-        
-      /* Vracanje unazad. */
-      case 8:
-        issueCommand( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-        waitAck( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-        issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        issueCommand( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 60 );
-        waitAck( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 60 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        
-        state_robot++;
-        sleep(100);
-        break;        
-       
-      /* Okretanje za 180 stepeni ka pocetnoj poziciji. */
-      case 9:
-
-        //issueCommand( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-        //waitAck( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-          
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 180 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 180 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 180 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 180 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }          
-        } 
-        
-        state_robot++;
-        sleep(100);
-        break; 
-      
-      /* Odlazak naspram druge kucice. */
-      case 10:
+  /* Tajmer za niti, 1ms. */
+  SysTick_Config( SystemCoreClock / 1000 );
+  
+  /* Niti se vrte dok traje mec i posle njega, procesor spava izmedju. */
+  schedulerRun( tasks, TASK_NUM );
+}
+/*----------------------------------------------------------------------------*/
 
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 15 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 15 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break;             
-       
-      /* Okretanje ka kucici. */
-      case 11:
 
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 175 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 175 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 175 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 175 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        
-        issueCommand( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        waitAck( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        
-        state_robot++;
-        sleep(100);
-        break;        
-        
-         
-      /* Zatvaranje druge kucice. */
-      case 12:
-        
-        issueCommand( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        waitAck( ULTRASOUND_OFF, MOTION_DEVICE_ADDRESS, 1 );
-        issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 700 );
-        waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 700 );
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 60 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 60 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break; 
-        
-      /* Vracanje unazad. */  
-      case 13:
-        
-        issueCommand( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-        waitAck( ULTRASOUND_ON, MOTION_DEVICE_ADDRESS, 1 );
-        issueCommand( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        waitAck( PRESCALER, MOTION_DEVICE_ADDRESS, 500 );
-        issueCommand( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 60 );
-        waitAck( MOVE_BACKWARD, MOTION_DEVICE_ADDRESS, 60 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break; 
-      
-      /* Okretanje ka centru naseg dela terena. */  
-      case 14:
-        
-        if( FLAG_strategyLeft )
-        {
-          issueCommand( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 270 );
-          waitAck( ROTATE_LEFT, MOTION_DEVICE_ADDRESS, 270 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        else
-        {
-          issueCommand( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 270 );
-          waitAck( ROTATE_RIGHT, MOTION_DEVICE_ADDRESS, 270 );
-          while( TRUE )
-          {
-            issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-            sleep( 100 );
-            if ( FLAG_arriveOnDest ) break;
-          }
-        }
-        state_robot++;
-        sleep(100);
-        break; 
-        
-      case 15:
-      
-        issueCommand( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 40 );
-        waitAck( MOVE_FORWARD, MOTION_DEVICE_ADDRESS, 40 );
-        while( TRUE )
-        {
-          issueCommand( CHECK_ARRIVE, MOTION_DEVICE_ADDRESS, 1 );
-          sleep( 100 );
-          if ( FLAG_arriveOnDest ) break;
-        }
-        state_robot++;
-        sleep(100);
-        break; 
-        
-      /* Podrazumevano stanje u kome se ne radi nista. */  
-      default:
-        break;
-    }
-  }
+/**
+  * @brief  Ceka start, zadaje misiju za izabranu strategiju i posle
+  *         MATCH_DURATION_MS zaustavlja misiju i robota.
+  * @param  pt predstavlja stanje niti.
+  * @retval Stanje niti.
+  */
+PT_THREAD( matchThread( struct pt *pt ) )
+{
+  static TimerType match_timer;
+  
+  PT_BEGIN( pt );
+  
+  /* Cekanje da se izvuce prekidac za start. */
+  PT_WAIT_UNTIL( pt, GPIO_ReadInputDataBit( GPIOB, GPIO_Pin_11 ) );
+  timerSet( &match_timer, MATCH_DURATION_MS );
+  /* Provera koja je stategije. */
+  checkStrategy();
+  /* Misija je opisana u missions.c, tabela za strategiju je napravljena pri prevodjenju.
+     Redosled akcija bira planer, akciju cije procenjeno trajanje ne staje
+     u preostalo vreme preskace. */
+  missionStart( FLAG_strategyLeft ? mission_main_left : mission_main_right,
+                mission_main_actions, mission_main_num_actions, match_timer.start );
+  
+  PT_WAIT_UNTIL( pt, timerExpired( &match_timer ) );
+  taskStop( &tasks[ TASK_MISSION ] );
+  taskStop( &tasks[ TASK_MOTION ] );
+  commandStart( STOP, 1 );
+  PT_WAIT_UNTIL( pt, commandDone() );
+  
+  PT_END( pt );
 }
 /*----------------------------------------------------------------------------*/
 
 
 /**
-  * @brief  Funkcija koja ceka na acknowledge signal od primaoca komande.
-  * @param  delay predstavlja broj milisekundi koliko zelimo da cekamo.
-  * @retval Nema.
-  * @author praetorian ( archmarko92@gmail.com )
+  * @brief  Osvezavanje prikaza baterije na bargraph-u i slanje napona
+  *         baterije ploci kretanja svakih SUPPLY_PERIOD_MS, za kompenzaciju
+  *         PWM-a. Napon se salje samo kada druga nit ne salje komandu.
+  * @param  pt predstavlja stanje niti.
+  * @retval Stanje niti.
   */
-void waitAck( CommandNameType command_name, int address, uint16_t data )
+PT_THREAD( batteryThread( struct pt *pt ) )
 {
+  static TimerType period, supply;
+  
+  PT_BEGIN( pt );
+  timerSet( &supply, 0 );
   while( TRUE )
   {
-    sleep( 25 );
-    if( FLAG_ackReceived )
+    BateryDisp();
+    if( timerExpired( &supply ) && battery_mv != 0 && commandDone() )
     {
-      FLAG_ackReceived = FALSE;
-      command_ID++;
-      break;
+      commandStart( SUPPLY_VOLTAGE, battery_mv );
+      timerSet( &supply, SUPPLY_PERIOD_MS );
     }
-    issueCommand( command_name, address, data );
+    timerSet( &period, BATTERY_PERIOD_MS );
+    PT_WAIT_UNTIL( pt, timerExpired( &period ) );
   }
+  PT_END( pt );
 }
 /*----------------------------------------------------------------------------*/
 
@@ -576,48 +248,11 @@ void initTimerServo( void )
   InitGPIO_Pin( GPIOB, GPIO_Pin_0, GPIO_Mode_AF_PP, GPIO_Speed_50MHz );
   InitTIM_TimeBase(TIM3, 240 - 1, 1000 - 1, TIM_CounterMode_Up, TIM_CKD_DIV1, 0);
   TIM_Cmd(TIM3, ENABLE);
-  TIM_ITConfig(TIM3, TIM_IT_Update, ENABLE);
-  InitNVICChannel(TIM3_IRQn, 0, 0, ENABLE);
   InitTIM_OC(TIM3, TIM_Channel_3, TIM_OutputState_Enable, TIM_OCMode_PWM1, 0, TIM_OCPolarity_High);
 }
 /*----------------------------------------------------------------------------*/
 
 
-/**
-  * @brief  Funkcija koja unosi zeljeno kasnjenje.
-  * @param  delay predstavlja broj milisekundi koliko zelimo da cekamo.
-  * @retval Nema.
-  * @author praetorian ( archmarko92@gmail.com )
-  */
-void sleep( int delay )
-{
-  global_tick = delay;
-  while( global_tick != 0 );
-}
-/*----------------------------------------------------------------------------*/
-
-
-/**
-  * @brief  Inicijalizacija tajmera za odredjivanje vremena cekanja.
-  * @param  Nema.
-  * @retval Nema.
-  * @author praetorian ( archmarko92@gmail.com )
-  */
-void initTimer90( void )
-{
-  /* Period je 1ms, korak je 1us. */
-  /* Inicijalizacija prostog tajmera 7. */ 
-  RCC_APB1PeriphClockCmd( RCC_APB1Periph_TIM7, ENABLE );
-  TIM7->ARR = 1000;
-  TIM7->PSC = 24000;
-  TIM7->CNT = 0;
-  TIM7->DIER = 1;
-  InitNVICChannel( TIM7_IRQn, 1, 1, ENABLE );
-  TIM7->CR1 = 1;
-};
-/*----------------------------------------------------------------------------*/
-
-
 /**
   * @brief  Odredjivanje koja je strategija igre u pitanju na osnovu prekidaca.
   * @param  Nema.
@@ -781,10 +416,9 @@ void DisplayBarGraphOneHot(unsigned char disp){
 
 
 void BateryDisp (void){
-    baterija_Acc=baterija_Acc_const*ADC_RegularConvertedValueTab[3];
-    servo_5V=servo_5V_const*ADC_RegularConvertedValueTab[2];//ovo se ne prikazuje sada....
-    float calculatedf=(baterija_Acc-10)*3.125;
-    unsigned char calculated=1+(unsigned char)calculatedf;
+    uint16_t mv = battery_mv;//filtrirano u power_monitor.c, servo_mv se ne prikazuje sada....
+    //jedan segment na 320 mV iznad 10 V
+    unsigned char calculated = mv > 10000 ? 1 + (mv - 10000) / 320 : 1;
     DisplayBarGraph(calculated);
 }
 /*----------------------------------------------------------------------------*/
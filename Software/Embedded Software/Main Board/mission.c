@@ -0,0 +1,127 @@
+/**
+*   @file:    mission.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Interpreter misije, videti mission.h.
+*/
+
+#include "stm32f10x_conf.h"
+#include "EUROBOT_Init.h"
+#include "Communication.h"
+#include "scheduler.h"
+#include "mission.h"
+
+/* Zadaje komandu i ceka acknowledge, ne blokira ostale niti. */
+#define MISSION_COMMAND( pt, command, arg )   \
+  do {                                        \
+    mission_command_sent = FALSE;             \
+    PT_WAIT_UNTIL( (pt), missionCommand( (command), (arg) ) ); \
+  } while( 0 )
+
+#define MISSION_IS_MOTION( c )  ( (c) == MOVE_FORWARD || (c) == MOVE_BACKWARD || \
+                                  (c) == ROTATE_LEFT || (c) == ROTATE_RIGHT )
+
+#define MISSION_SLEEP( pt, timer, ms )        \
+  do {                                        \
+    timerSet( (timer), (ms) );                \
+    PT_WAIT_UNTIL( (pt), timerExpired( (timer) ) ); \
+  } while( 0 )
+
+extern int state_robot;
+
+static const MissionStepType *mission_steps = 0;
+/* Indeks prvog koraka posle markera MISSION_ACTION za svaku akciju. */
+static uint8_t action_first[ PLANNER_MAX_ACTIONS ];
+static uint32_t mission_start_ms;
+static bool mission_command_sent;
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Zadaje komandu cim commandThread zavrsi komandu druge niti (STOP
+  *         iz motionThread), da je ne bi zamenila, pa ceka acknowledge.
+  * @retval TRUE kada je komanda potvrdjena.
+  */
+static bool missionCommand( CommandNameType command, uint16_t arg )
+{
+  if ( !commandDone() ) return FALSE;
+  if ( mission_command_sent ) return TRUE;
+  commandStart( command, arg );
+  mission_command_sent = TRUE;
+  return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+void missionStart( const MissionStepType *steps, const PlannerActionType *actions,
+                   uint8_t num_actions, uint32_t start_ms )
+{
+  uint8_t i;
+
+  for ( i = 0; steps[ i ].command != MISSION_END; i++ )
+  {
+    if ( steps[ i ].command == MISSION_ACTION && steps[ i ].arg < PLANNER_MAX_ACTIONS )
+      action_first[ steps[ i ].arg ] = i + 1;
+  }
+  plannerStart( actions, num_actions );
+  mission_start_ms = start_ms;
+  mission_steps = steps;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Izvrsava akcije koje planer izabere za preostalo vreme, a korake
+  *         akcije redom, kada missionStart() zada tabelu. Kretanje i servo
+  *         se samo zadaju, na dolazak u poziciju ceka motionThread, a
+  *         misija ceka kanal samo za MS_WAIT, MS_AFTER_* i novo kretanje.
+  *         state_robot je indeks koraka koji se zadaje.
+  * @param  pt predstavlja stanje niti.
+  * @retval Stanje niti.
+  */
+PT_THREAD( missionThread( struct pt *pt ) )
+{
+  static const MissionStepType *step;
+  static TimerType timer;
+  static int8_t action;
+  static uint32_t action_start;
+
+  PT_BEGIN( pt );
+  PT_WAIT_UNTIL( pt, mission_steps != 0 );
+
+  while ( ( action = plannerNext( sched_ms - mission_start_ms ) ) != PLANNER_NONE )
+  {
+    action_start = sched_ms;
+    for ( state_robot = action_first[ action ];
+          mission_steps[ state_robot ].command != MISSION_END &&
+          mission_steps[ state_robot ].command != MISSION_ACTION; state_robot++ )
+    {
+      step = &mission_steps[ state_robot ];
+      if ( step->flags & MS_AFTER_MOTION ) PT_WAIT_UNTIL( pt, actuatorIdle( ACT_MOTION ) );
+      if ( step->flags & MS_AFTER_SERVO ) PT_WAIT_UNTIL( pt, actuatorIdle( ACT_SERVO ) );
+      if ( step->flags & MS_US_ON ) MISSION_COMMAND( pt, ULTRASOUND_ON, 1 );
+      if ( step->flags & MS_US_OFF ) MISSION_COMMAND( pt, ULTRASOUND_OFF, 1 );
+      if ( step->flags & MS_WALL ) MISSION_COMMAND( pt, WALL_TARGET, 1 );
+
+      if ( step->command == MISSION_DELAY ) MISSION_SLEEP( pt, &timer, step->arg );
+      else if ( step->command == MISSION_SERVO )
+      {
+        PT_WAIT_UNTIL( pt, actuatorIdle( ACT_SERVO ) );
+        servoStart( step->arg, step->timeout );
+        if ( step->flags & MS_WAIT ) PT_WAIT_UNTIL( pt, actuatorIdle( ACT_SERVO ) );
+      }
+      else if ( MISSION_IS_MOTION( step->command ) )
+      {
+        PT_WAIT_UNTIL( pt, motionReady() );
+        MISSION_COMMAND( pt, (CommandNameType)step->command, step->arg );
+        /* Pauza posle kretanja je deo kanala, ne zadrzava ostale korake. */
+        motionStart( step->timeout, ( step->flags & MS_SETTLE ) ? MISSION_SETTLE_MS : 0 );
+        if ( step->flags & MS_WAIT ) PT_WAIT_UNTIL( pt, motionReady() );
+        continue;
+      }
+      else MISSION_COMMAND( pt, (CommandNameType)step->command, step->arg );
+
+      if ( step->flags & MS_SETTLE ) MISSION_SLEEP( pt, &timer, MISSION_SETTLE_MS );
+    }
+    PT_WAIT_UNTIL( pt, motionReady() && actuatorIdle( ACT_SERVO ) );
+    plannerDone( action, sched_ms - action_start );
+  }
+  PT_END( pt );
+}
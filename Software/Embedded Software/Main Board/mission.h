@@ -0,0 +1,94 @@
+/**
+*   @file:    mission.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Misija kao tabela koraka koju izvrsava mali interpreter.
+*             Korak je jedna komanda ploci kretanja sa argumentom i
+*             zastavicama: da li se okrece u ogledalu za desnu strategiju,
+*             da li se ceka dolazak u poziciju, paljenje ili gasenje
+*             ultrazvucnih senzora pre komande, da li je cilj pokreta zid i
+*             pauza posle koraka.
+*
+*             Misija se opisuje samo jednom, za levu strategiju, kao lista
+*             STEP(...) koraka. MISSION_TABLES od nje pravi dve const
+*             tabele u flash-u, levu i desnu, pa se ogledalo razresava pri
+*             prevodjenju i interpreter ne grana po strategiji.
+*
+*             Kretanje i servo su kanali iz actuator.h. Korak bez MS_WAIT
+*             samo zada pokret i misija odmah ide dalje, pa se npr. senzori
+*             gase ili servo pomera dok se robot krece. Korak sa
+*             MS_AFTER_MOTION ili MS_AFTER_SERVO pre pocetka ceka da se kanal
+*             oslobodi. Novo kretanje uvek ceka prethodno, a akcija je gotova
+*             tek kada su svi kanali slobodni.
+*/
+
+#ifndef __MISSION_H__
+#define __MISSION_H__
+
+#include "stm32f10x.h"
+#include "pt.h"
+#include "Communication.h"
+#include "actuator.h"
+#include "mission_actions.h"
+
+/* Komande koje ne idu ploci kretanja, nastavljaju se na CommandNameType. */
+#define MISSION_END       0xFF   // Kraj misije.
+#define MISSION_DELAY     0xFE   // Cekanje arg milisekundi.
+#define MISSION_ACTION    0xFD   // Pocetak akcije arg iz tabele akcija.
+#define MISSION_SERVO     0xFC   // CCR3 servoa = arg, pokret traje timeout ms.
+
+/* Zastavice koraka. */
+#define MS_MIRROR       0x01   // U desnoj tabeli ROTATE_LEFT i ROTATE_RIGHT menjaju mesta, SET_POSITION je START_POSE_RIGHT.
+#define MS_WAIT         0x02   // Posle komande se ceka da se kanal koraka oslobodi.
+#define MS_US_ON        0x04   // Pre komande se pale ultrazvucni senzori.
+#define MS_US_OFF       0x08   // Pre komande se gase ultrazvucni senzori.
+#define MS_SETTLE       0x10   // Posle koraka pauza od MISSION_SETTLE_MS.
+#define MS_AFTER_MOTION 0x20  // Pre koraka se ceka dolazak u poziciju.
+#define MS_AFTER_SERVO  0x40  // Pre koraka se ceka kraj pokreta servoa.
+#define MS_WALL         0x80  // Cilj pokreta je zid ili kucica, prepreka na cilju ne zaustavlja po TTC-u.
+
+#define MISSION_SETTLE_MS   100
+#define MISSION_NO_TIMEOUT  MOTION_NO_TIMEOUT
+
+typedef struct
+{
+  uint8_t  command;     // CommandNameType ili MISSION_*.
+  uint8_t  flags;       // MS_*.
+  uint16_t arg;         // cm, stepeni, preskaler ili ms za MISSION_DELAY.
+  uint16_t timeout;     // ms za kretanje, posle toga se salje STOP.
+} MissionStepType;
+
+/* Komanda u ogledalu, konstantan izraz. */
+#define MISSION_MIRROR_CMD(c) \
+  ( (c) == ROTATE_LEFT ? ROTATE_RIGHT : (c) == ROTATE_RIGHT ? ROTATE_LEFT : (c) )
+
+/* Argument u ogledalu, konstantan izraz. */
+#define MISSION_MIRROR_ARG(c, a) \
+  ( (c) == SET_POSITION ? START_POSE_RIGHT : (a) )
+
+#define MISSION_STEP_LEFT(c, f, a, t) \
+  { (c), (f) & ~MS_MIRROR, (a), (t) },
+#define MISSION_STEP_RIGHT(c, f, a, t) \
+  { ( (f) & MS_MIRROR ) ? MISSION_MIRROR_CMD(c) : (c), (f) & ~MS_MIRROR, \
+    ( (f) & MS_MIRROR ) ? MISSION_MIRROR_ARG(c, a) : (a), (t) },
+
+/* LIST(STEP) je makro koji za svaki korak poziva STEP(komanda, zastavice,
+   arg, timeout). Pravi name_left[] i name_right[]. */
+#define MISSION_TABLES(name, LIST) \
+  const MissionStepType name##_left[] = { LIST(MISSION_STEP_LEFT) }; \
+  const MissionStepType name##_right[] = { LIST(MISSION_STEP_RIGHT) };
+
+/* Misija za ovaj mec, za levu i desnu strategiju. */
+extern const MissionStepType mission_main_left[];
+extern const MissionStepType mission_main_right[];
+
+/* Zadaje tabelu koraka i tabelu akcija. Akcija pocinje korakom
+   MISSION_ACTION i traje do sledeceg MISSION_ACTION ili MISSION_END, a
+   redosled akcija bira planer. start_ms je trenutak starta meca. */
+void missionStart( const MissionStepType *steps, const PlannerActionType *actions,
+                   uint8_t num_actions, uint32_t start_ms );
+/* Nit koja izvrsava misiju. */
+PT_THREAD( missionThread( struct pt *pt ) );
+
+#endif
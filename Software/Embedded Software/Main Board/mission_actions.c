@@ -0,0 +1,25 @@
+/**
+*   @file:    mission_actions.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Poeni, zavisnosti i ocekivano trajanje akcija glavne misije.
+*             Svaka akcija pocinje tamo gde se prethodna zavrsila, pa zavise
+*             redom jedna od druge. Trajanja se osvezavaju iz izmerenih
+*             meceva sa Host/match_sim.c -l, koji ispisuje novu tabelu.
+*/
+
+#include "mission_actions.h"
+
+#define BIT(a)  ( 1u << (a) )
+
+const PlannerActionType mission_main_actions[ ACTION_NUM ] =
+{
+  /* score  partial  requires                expected_ms */
+  { 6,      0,       0,                      14000 },   // ACTION_CUBES
+  { 10,     0,       BIT( ACTION_CUBES ),    12000 },   // ACTION_DOOR_1
+  { 10,     0,       BIT( ACTION_DOOR_1 ),   14000 },   // ACTION_DOOR_2
+  { 2,      0,       BIT( ACTION_DOOR_2 ),   7000  }    // ACTION_CENTER
+};
+
+const uint8_t mission_main_num_actions = ACTION_NUM;
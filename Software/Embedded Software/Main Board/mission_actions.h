@@ -0,0 +1,27 @@
+/**
+*   @file:    mission_actions.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Akcije glavne misije. Indeks akcije je arg markera
+*             MISSION_ACTION u missions.c i indeks u mission_main_actions[].
+*/
+
+#ifndef __MISSION_ACTIONS_H__
+#define __MISSION_ACTIONS_H__
+
+#include "planner.h"
+
+enum
+{
+  ACTION_CUBES,     // Start i guranje kocki u sredinu terena.
+  ACTION_DOOR_1,    // Zatvaranje prvih vrata.
+  ACTION_DOOR_2,    // Zatvaranje drugih vrata.
+  ACTION_CENTER,    // Odlazak ka centru naseg dela terena.
+  ACTION_NUM
+};
+
+extern const PlannerActionType mission_main_actions[];
+extern const uint8_t mission_main_num_actions;
+
+#endif
@@ -0,0 +1,69 @@
+/**
+*   @file:    missions.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Misije, opisane za levu strategiju. Desna tabela se pravi
+*             pri prevodjenju, videti MISSION_TABLES u mission.h. Komentari
+*             prate stanja ranije masine stanja iz main_MainStateMachine.c.
+*             MISSION_ACTION deli misiju na akcije iz mission_actions.c.
+*/
+
+#include "mission.h"
+
+/* Servo spusta ruku za vrata kucica dok se robot okrece ka prvoj kucici.
+   Ruka ostaje spustena i za druga vrata. */
+#define SERVO_DOOR_CCR  950
+#define SERVO_MOVE_MS   600
+
+#define MISSION_MAIN(STEP) \
+  STEP( MISSION_ACTION, 0,                               ACTION_CUBES,  MISSION_NO_TIMEOUT ) \
+  /* 0: Startna poza za mrezu zauzetosti, start, preskaler, paljenje UV i polazak napred. */ \
+  STEP( SET_POSITION,   MS_MIRROR,                       START_POSE_LEFT, MISSION_NO_TIMEOUT ) \
+  STEP( START_RUNNING,  0,                               30,   MISSION_NO_TIMEOUT ) \
+  STEP( PRESCALER,      0,                               1000, MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_FORWARD,   MS_US_ON | MS_WAIT | MS_SETTLE,  30,   MISSION_NO_TIMEOUT ) \
+  /* 1: Blago okretanje da bi se izbegla ivica na sredini terena. */ \
+  STEP( ROTATE_LEFT,    MS_MIRROR | MS_WAIT | MS_SETTLE, 20,   MISSION_NO_TIMEOUT ) \
+  /* 2: Blago pomeranje napred, ka sredini terena. */ \
+  STEP( MOVE_FORWARD,   MS_WAIT | MS_SETTLE,             50,   MISSION_NO_TIMEOUT ) \
+  /* 3: Blaga rotacija da bi se poravnali opet. */ \
+  STEP( ROTATE_RIGHT,   MS_MIRROR | MS_WAIT | MS_SETTLE, 25,   MISSION_NO_TIMEOUT ) \
+  /* 4: Pomeranje kocki u sredinu terena. */ \
+  STEP( MOVE_FORWARD,   MS_SETTLE,                       10,   MISSION_NO_TIMEOUT ) \
+  /* 5: Vracanje unazad, preskaler dok se robot smiruje. */ \
+  STEP( PRESCALER,      MS_AFTER_MOTION,                 500,  MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_BACKWARD,  MS_WAIT | MS_SETTLE,             50,   MISSION_NO_TIMEOUT ) \
+  STEP( MISSION_ACTION, 0,                               ACTION_DOOR_1, MISSION_NO_TIMEOUT ) \
+  /* 6: Okretanje ka prvoj kucici, senzori se gase i ruka se spusta dok se robot okrece. */ \
+  STEP( ROTATE_RIGHT,   MS_MIRROR | MS_SETTLE,           175,  MISSION_NO_TIMEOUT ) \
+  STEP( ULTRASOUND_OFF, 0,                               1,    MISSION_NO_TIMEOUT ) \
+  STEP( MISSION_SERVO,  0,                               SERVO_DOOR_CCR, SERVO_MOVE_MS ) \
+  /* 7: Zatvaranje prvih vrata, preskaler tek kada se okret i ruka zavrse. */ \
+  STEP( PRESCALER,      MS_AFTER_MOTION | MS_AFTER_SERVO, 700, MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_FORWARD,   MS_SETTLE,                       100,  MISSION_NO_TIMEOUT ) \
+  /* 8: Vracanje unazad. */ \
+  STEP( PRESCALER,      MS_US_ON | MS_AFTER_MOTION,      500,  MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_BACKWARD,  MS_WAIT | MS_SETTLE,             60,   MISSION_NO_TIMEOUT ) \
+  STEP( MISSION_ACTION, 0,                               ACTION_DOOR_2, MISSION_NO_TIMEOUT ) \
+  /* 9: Okretanje za 180 stepeni ka pocetnoj poziciji. */ \
+  STEP( ROTATE_RIGHT,   MS_MIRROR | MS_WAIT | MS_SETTLE, 180,  MISSION_NO_TIMEOUT ) \
+  /* 10: Odlazak naspram druge kucice. */ \
+  STEP( MOVE_FORWARD,   MS_WAIT | MS_SETTLE,             15,   MISSION_NO_TIMEOUT ) \
+  /* 11: Okretanje ka kucici, senzori se gase dok se robot okrece. */ \
+  STEP( ROTATE_LEFT,    MS_MIRROR | MS_SETTLE,           175,  MISSION_NO_TIMEOUT ) \
+  STEP( ULTRASOUND_OFF, 0,                               1,    MISSION_NO_TIMEOUT ) \
+  /* 12: Zatvaranje druge kucice. */ \
+  STEP( PRESCALER,      MS_US_OFF | MS_AFTER_MOTION,     700,  MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_FORWARD,   MS_SETTLE,                       60,   MISSION_NO_TIMEOUT ) \
+  /* 13: Vracanje unazad. */ \
+  STEP( PRESCALER,      MS_US_ON | MS_AFTER_MOTION,      500,  MISSION_NO_TIMEOUT ) \
+  STEP( MOVE_BACKWARD,  MS_WAIT | MS_SETTLE,             60,   MISSION_NO_TIMEOUT ) \
+  STEP( MISSION_ACTION, 0,                               ACTION_CENTER, MISSION_NO_TIMEOUT ) \
+  /* 14: Okretanje ka centru naseg dela terena. */ \
+  STEP( ROTATE_LEFT,    MS_MIRROR | MS_WAIT | MS_SETTLE, 270,  MISSION_NO_TIMEOUT ) \
+  /* 15: Poslednji pomeraj napred. */ \
+  STEP( MOVE_FORWARD,   MS_WAIT | MS_SETTLE,             40,   MISSION_NO_TIMEOUT ) \
+  STEP( MISSION_END,    0,                               0,    MISSION_NO_TIMEOUT )
+
+MISSION_TABLES( mission_main, MISSION_MAIN )
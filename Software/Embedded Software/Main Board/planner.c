@@ -0,0 +1,121 @@
+/**
+*   @file:    planner.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Planer akcija, videti planner.h.
+*/
+
+#include "planner.h"
+
+uint16_t planner_measured_ms[ PLANNER_MAX_ACTIONS ];
+
+static const PlannerActionType *planner_actions = 0;
+static uint8_t planner_num = 0;
+static uint8_t planner_done = 0;
+static uint16_t planner_pace = PLANNER_PACE_NOMINAL;
+
+/*----------------------------------------------------------------------------*/
+void plannerStart( const PlannerActionType *actions, uint8_t num_actions )
+{
+  uint8_t i;
+
+  planner_actions = actions;
+  planner_num = num_actions > PLANNER_MAX_ACTIONS ? PLANNER_MAX_ACTIONS : num_actions;
+  planner_done = 0;
+  planner_pace = PLANNER_PACE_NOMINAL;
+  for ( i = 0; i < PLANNER_MAX_ACTIONS; i++ ) planner_measured_ms[ i ] = 0;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t plannerEstimate( int8_t action )
+{
+  return (uint32_t)planner_actions[ action ].expected_ms * planner_pace / 1000;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Pretrazuje sve podskupove nezavrsenih akcija (najvise 2^8) i bira
+  *         onaj sa najvise poena koji staje u preostalo vreme. Podskup je
+  *         dozvoljen ako su zavisnosti svake akcije u njemu zavrsene ili su
+  *         i same u podskupu. Trajanje se procenjuje bez rezerve. Kod
+  *         jednakih poena bira se kraci podskup, akcije bez poena se ne
+  *         biraju. Iz podskupa se prvo radi akcija sa najvise poena po
+  *         sekundi procene. Ako nijedna akcija ne staje u preostalo vreme,
+  *         pocinje se dostupna akcija sa najvise poena za prekinutu akciju.
+  * @param  elapsed_ms: vreme od starta meca.
+  * @retval Akcija ciji su preduslovi zavrseni, ili PLANNER_NONE kada
+  *         nijedna ne staje u preostalo vreme niti nosi poene prekinuta.
+  */
+int8_t plannerNext( uint32_t elapsed_ms )
+{
+  uint32_t remaining, time, best_time = 0;
+  uint16_t set, best_set = 0, sets;
+  int16_t score, best_score = 0;
+  int8_t best = PLANNER_NONE;
+  uint8_t i, ok;
+
+  if ( planner_actions == 0 || elapsed_ms >= MATCH_DURATION_MS ) return PLANNER_NONE;
+  remaining = MATCH_DURATION_MS - elapsed_ms;
+
+  sets = (uint16_t)( 1u << planner_num );
+  for ( set = 1; set < sets; set++ )
+  {
+    if ( set & planner_done ) continue;
+    time = 0;
+    score = 0;
+    ok = 1;
+    for ( i = 0; i < planner_num && ok; i++ )
+    {
+      if ( !( set & ( 1u << i ) ) ) continue;
+      if ( planner_actions[ i ].requires & ~( set | planner_done ) ) ok = 0;
+      time += plannerEstimate( i );
+      score += planner_actions[ i ].score;
+    }
+    if ( !ok || time > remaining ) continue;
+    if ( score > best_score || ( score == best_score && best_set && time < best_time ) )
+    {
+      best_score = score;
+      best_time = time;
+      best_set = set;
+    }
+  }
+
+  /* score_i / est_i > score_b / est_b, bez deljenja. */
+  for ( i = 0; i < planner_num; i++ )
+  {
+    if ( !( best_set & ( 1u << i ) ) || ( planner_actions[ i ].requires & ~planner_done ) ) continue;
+    if ( best == PLANNER_NONE ||
+         (uint32_t)planner_actions[ i ].score * plannerEstimate( best ) >
+         (uint32_t)planner_actions[ best ].score * plannerEstimate( i ) ) best = i;
+  }
+  if ( best != PLANNER_NONE ) return best;
+
+  for ( i = 0; i < planner_num; i++ )
+  {
+    if ( ( planner_done & ( 1u << i ) ) || ( planner_actions[ i ].requires & ~planner_done ) ) continue;
+    if ( planner_actions[ i ].partial > ( best == PLANNER_NONE ? 0 : planner_actions[ best ].partial ) ) best = i;
+  }
+  return best;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Belezi akciju kao zavrsenu i pomera tempo ka odnosu izmerenog i
+  *         ocekivanog trajanja (eksponencijalni prosek, tezina 1/4). Odnos
+  *         se ogranicava na PLANNER_PACE_STEP puta trenutni tempo, pa jedna
+  *         akcija u kojoj je protivnik blokirao put ne preskace ostale.
+  */
+void plannerDone( int8_t action, uint32_t duration_ms )
+{
+  int32_t ratio;
+
+  if ( action < 0 || action >= planner_num ) return;
+  planner_done |= 1u << action;
+  planner_measured_ms[ action ] = duration_ms > 0xFFFF ? 0xFFFF : (uint16_t)duration_ms;
+
+  if ( planner_actions[ action ].expected_ms == 0 ) return;
+  ratio = (int32_t)( duration_ms * 1000 / planner_actions[ action ].expected_ms );
+  if ( ratio > (int32_t)planner_pace * PLANNER_PACE_STEP / 1000 ) ratio = (int32_t)planner_pace * PLANNER_PACE_STEP / 1000;
+  ratio = planner_pace + ( ( ratio - planner_pace ) >> PLANNER_PACE_SHIFT );
+  if ( ratio < PLANNER_PACE_MIN ) ratio = PLANNER_PACE_MIN;
+  if ( ratio > PLANNER_PACE_MAX ) ratio = PLANNER_PACE_MAX;
+  planner_pace = (uint16_t)ratio;
+}
@@ -0,0 +1,61 @@
+/**
+*   @file:    planner.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Planer akcija u odnosu na preostalo vreme meca. Misija je
+*             podeljena na akcije (grupe koraka) koje nose poene. Pre svake
+*             akcije planer pretrazi sve podskupove preostalih akcija koji
+*             postuju zavisnosti i staju u preostalo vreme, izabere podskup
+*             sa najvise poena i iz njega vrati dostupnu akciju sa najvise
+*             poena po sekundi, pa kada procena omane ostaju jeftinije
+*             akcije. Akcija koja ne staje u preostalo vreme se preskace;
+*             kada ne staje nijedna, pocinje se samo akcija koja nosi poene
+*             i kada je prekinuta (partial).
+*
+*             Ocekivano trajanje akcije je izmereno na ranijim mecevima
+*             (planner_measured_ms[], Host/match_sim.c -l). Tokom meca se
+*             prati odnos izmerenog i ocekivanog trajanja (tempo) i njime se
+*             skaliraju procene za preostale akcije. Ne zavisi od hardvera,
+*             prevodi se i u Host/match_sim.c.
+*/
+
+#ifndef __PLANNER_H__
+#define __PLANNER_H__
+
+#include <stdint.h>
+
+#define MATCH_DURATION_MS       ( 90000 )
+
+#define PLANNER_MAX_ACTIONS     8
+#define PLANNER_NONE            ( -1 )
+/* Tempo: pocetni, granice, tezina novog merenja (2^-PLANNER_PACE_SHIFT) i
+   najveci odnos merenja i trenutnog tempa, u promilima. */
+#define PLANNER_PACE_NOMINAL    1000
+#define PLANNER_PACE_MIN        500
+#define PLANNER_PACE_MAX        3000
+#define PLANNER_PACE_SHIFT      2
+#define PLANNER_PACE_STEP       1250
+
+typedef struct
+{
+  uint8_t  score;         // Poeni za zavrsenu akciju.
+  uint8_t  partial;       // Poeni za akciju prekinutu krajem meca.
+  uint8_t  requires;      // Maska akcija koje moraju biti zavrsene pre ove.
+  uint16_t expected_ms;   // Ocekivano trajanje sa ranijih meceva.
+} PlannerActionType;
+
+/* Izmereno trajanje akcija u poslednjem mecu, 0 ako akcija nije izvrsena.
+   Cita se debugger-om posle meca za Host/match_sim.c -l. */
+extern uint16_t planner_measured_ms[ PLANNER_MAX_ACTIONS ];
+
+/* Zadaje tabelu akcija, najvise PLANNER_MAX_ACTIONS. */
+void plannerStart( const PlannerActionType *actions, uint8_t num_actions );
+/* Sledeca akcija za preostalo vreme ili PLANNER_NONE. */
+int8_t plannerNext( uint32_t elapsed_ms );
+/* Akcija je zavrsena za duration_ms. */
+void plannerDone( int8_t action, uint32_t duration_ms );
+/* Procena trajanja akcije sa trenutnim tempom. */
+uint32_t plannerEstimate( int8_t action );
+
+#endif
@@ -0,0 +1,58 @@
+/**
+*   @file:    power_monitor.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Filtriranje napona baterije i servo napajanja, videti
+*             power_monitor.h.
+*/
+
+#include "power_monitor.h"
+
+vu16 adc_dma_buffer[ PM_DMA_LENGTH ];
+
+volatile uint16_t battery_mv = 0;
+volatile uint16_t servo_mv = 0;
+volatile uint16_t battery_raw16 = 0;
+volatile uint16_t servo_raw16 = 0;
+
+static uint32_t battery_sum = 0;
+static uint32_t servo_sum = 0;
+static uint8_t halves = 0;
+
+/*----------------------------------------------------------------------------*/
+static uint16_t toMillivolts( uint16_t raw16 )
+{
+  return (uint16_t)( ( (uint32_t)raw16 * PM_MV_PER_LSB16_Q16 + 0x8000 ) >> 16 );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Sabira jednu polovinu DMA bafera. DMA za to vreme puni drugu
+  *         polovinu, a prekid ima 400 us pre nego sto se ova prepise.
+  * @param  scans: prvo skeniranje polovine.
+  * @retval Nema.
+  */
+void powerMonitorHalf( const vu16 *scans )
+{
+  uint32_t battery = 0, servo = 0;
+  uint8_t i;
+
+  for ( i = 0; i < PM_SCANS_HALF; i++, scans += PM_SCAN_CHANNELS )
+  {
+    servo += scans[ PM_SCAN_SERVO ];
+    battery += scans[ PM_SCAN_BATTERY ];
+  }
+  battery_sum += battery;
+  servo_sum += servo;
+
+  if ( ++halves == PM_DECIMATION / PM_SCANS_HALF )
+  {
+    battery_raw16 = (uint16_t)( battery_sum >> PM_SUM_SHIFT );
+    servo_raw16 = (uint16_t)( servo_sum >> PM_SUM_SHIFT );
+    battery_mv = toMillivolts( battery_raw16 );
+    servo_mv = toMillivolts( servo_raw16 );
+    battery_sum = 0;
+    servo_sum = 0;
+    halves = 0;
+  }
+}
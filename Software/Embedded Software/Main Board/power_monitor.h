@@ -0,0 +1,48 @@
+/**
+*   @file:    power_monitor.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Napon baterije i servo napajanja sa oversampling-om. TIM1
+*             okida skeniranje cetiri ADC kanala na 160 kHz, a DMA ih u
+*             krugu upisuje u bafer od 2 x PM_SCANS_HALF skeniranja. Prekid
+*             na pola i na kraju bafera sabira polovinu koja je upravo
+*             popunjena, a posle PM_DECIMATION uzoraka zbir (CIC prvog reda,
+*             tj. srednja vrednost sa decimacijom) daje 16-bitni rezultat:
+*             256 = 4^4 uzoraka, 4 bita vise od 12-bitnog ADC-a kada je sum
+*             bar jedan LSB. Izlaz se osvezava 625 puta u sekundi i
+*             objavljuje u milivoltima.
+*/
+
+#ifndef __POWER_MONITOR_H__
+#define __POWER_MONITOR_H__
+
+#include "stm32f10x.h"
+
+/* Redosled u skeniranju ADC-a: kanali 12, 13 (IR senzori, ir_sensor.h), 0, 1. */
+#define PM_SCAN_CHANNELS    4
+#define PM_SCAN_SERVO       2
+#define PM_SCAN_BATTERY     3
+
+#define PM_SCANS_HALF       64
+#define PM_DMA_LENGTH       ( 2 * PM_SCANS_HALF * PM_SCAN_CHANNELS )
+#define PM_DECIMATION       256
+/* Zbir od PM_DECIMATION 12-bitnih uzoraka se pomera na 16 bita. */
+#define PM_SUM_SHIFT        4
+/* 4.032 mV po 12-bitnom LSB-u (razdelnik), po 16-bitnom u Q16. */
+#define PM_MV_PER_LSB16_Q16 16515
+
+/* DMA bafer za ADC, DMA1 Channel1 u kruznom modu. */
+extern vu16 adc_dma_buffer[ PM_DMA_LENGTH ];
+
+/* Poslednji filtrirani naponi. */
+extern volatile uint16_t battery_mv;
+extern volatile uint16_t servo_mv;
+/* Poslednji filtrirani 16-bitni rezultati, pre preracunavanja u mV. */
+extern volatile uint16_t battery_raw16;
+extern volatile uint16_t servo_raw16;
+
+/* Poziva se iz DMA1_Channel1_IRQHandler-a za popunjenu polovinu bafera. */
+void powerMonitorHalf( const vu16 *scans );
+
+#endif
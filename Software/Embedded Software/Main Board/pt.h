@@ -0,0 +1,65 @@
+/**
+*   @file:    pt.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Protothreads, niti bez sopstvenog steka (po uzoru na
+*             A. Dunkels). Nit je funkcija koja pamti samo broj linije na
+*             kojoj je stala, pa se pri sledecem pozivu switch-om vraca
+*             tamo. Lokalne promenljive se ne cuvaju izmedju poziva, sve
+*             sto treba da prezivi cekanje mora biti static. U telu niti se
+*             ne sme koristiti switch koji obuhvata PT_WAIT_* ili PT_YIELD.
+*/
+
+#ifndef __PT_H__
+#define __PT_H__
+
+struct pt
+{
+  unsigned short lc;
+};
+
+#define PT_WAITING  0
+#define PT_YIELDED  1
+#define PT_EXITED   2
+#define PT_ENDED    3
+
+#define PT_THREAD(name_args)  char name_args
+
+#define PT_INIT(pt)           ( (pt)->lc = 0 )
+
+#define PT_BEGIN(pt)          { char PT_YIELD_FLAG = 1; (void)PT_YIELD_FLAG; switch( (pt)->lc ) { case 0:
+
+#define PT_END(pt)            } PT_YIELD_FLAG = 0; (pt)->lc = 0; return PT_ENDED; }
+
+/* Nit ceka dok uslov ne postane tacan. */
+#define PT_WAIT_UNTIL(pt, condition)            \
+  do {                                          \
+    (pt)->lc = __LINE__; case __LINE__:         \
+    if( !(condition) ) return PT_WAITING;       \
+  } while( 0 )
+
+#define PT_WAIT_WHILE(pt, cond)   PT_WAIT_UNTIL( (pt), !(cond) )
+
+/* Pokrece podnit i ceka da se zavrsi. */
+#define PT_SPAWN(pt, child, thread)             \
+  do {                                          \
+    PT_INIT( (child) );                         \
+    PT_WAIT_WHILE( (pt), (thread) < PT_EXITED );\
+  } while( 0 )
+
+/* Ustupa procesor ostalim nitima jednom. */
+#define PT_YIELD(pt)                            \
+  do {                                          \
+    PT_YIELD_FLAG = 0;                          \
+    (pt)->lc = __LINE__; case __LINE__:         \
+    if( PT_YIELD_FLAG == 0 ) return PT_YIELDED; \
+  } while( 0 )
+
+#define PT_EXIT(pt)                             \
+  do {                                          \
+    (pt)->lc = 0;                               \
+    return PT_EXITED;                           \
+  } while( 0 )
+
+#endif
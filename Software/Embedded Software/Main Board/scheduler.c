@@ -0,0 +1,62 @@
+/**
+*   @file:    scheduler.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kooperativni rasporedjivac, videti scheduler.h.
+*/
+
+#include "stm32f10x.h"
+#include "scheduler.h"
+
+volatile uint32_t sched_ms = 0;
+
+/*----------------------------------------------------------------------------*/
+void schedulerTick( void )
+{
+  sched_ms++;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Poziva aktivne niti u krug. Nit koja se zavrsi (PT_EXIT, PT_END)
+  *         se gasi. Posle kruga procesor ceka prekid. Ako prekid stigne
+  *         posle provere uslova a pre WFI, nit ga vidi na sledecem SysTick-u.
+  * @param  tasks: tabela niti.
+  * @param  num_tasks: broj niti u tabeli.
+  * @retval Nema, funkcija se ne vraca.
+  */
+void schedulerRun( TaskType *tasks, uint8_t num_tasks )
+{
+  uint8_t i;
+
+  for ( i = 0; i < num_tasks; i++ )
+  {
+    PT_INIT( &tasks[ i ].pt );
+    tasks[ i ].active = 1;
+  }
+
+  while ( 1 )
+  {
+    for ( i = 0; i < num_tasks; i++ )
+    {
+      if ( tasks[ i ].active && tasks[ i ].run( &tasks[ i ].pt ) >= PT_EXITED ) tasks[ i ].active = 0;
+    }
+    __WFI();
+  }
+}
+/*----------------------------------------------------------------------------*/
+void taskStop( TaskType *task )
+{
+  task->active = 0;
+}
+/*----------------------------------------------------------------------------*/
+void timerSet( TimerType *timer, uint32_t interval )
+{
+  timer->start = sched_ms;
+  timer->interval = interval;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t timerExpired( const TimerType *timer )
+{
+  return ( sched_ms - timer->start ) >= timer->interval;
+}
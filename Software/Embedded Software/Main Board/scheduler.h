@@ -0,0 +1,48 @@
+/**
+*   @file:    scheduler.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kooperativni rasporedjivac za protothread niti. Sve niti se
+*             pozivaju redom u krug, a posle svakog kruga procesor spava
+*             (WFI) do sledeceg prekida. SysTick budi procesor svake
+*             milisekunde i odbrojava sched_ms, pa nit koja ceka tajmer
+*             kasni najvise 1 ms. Nit nikada ne sme da ceka u petlji, vec
+*             preko PT_WAIT_UNTIL.
+*/
+
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include "stm32f10x.h"
+#include "pt.h"
+
+typedef char ( *TaskFunctionType )( struct pt *pt );
+
+typedef struct
+{
+  TaskFunctionType run;
+  struct pt pt;
+  uint8_t active;
+} TaskType;
+
+typedef struct
+{
+  uint32_t start;
+  uint32_t interval;
+} TimerType;
+
+/* Milisekunde od ukljucenja, odbrojava SysTick. */
+extern volatile uint32_t sched_ms;
+
+/* Poziva se iz SysTick_Handler-a. */
+void schedulerTick( void );
+/* Vrti niti iz tabele zauvek. */
+void schedulerRun( TaskType *tasks, uint8_t num_tasks );
+/* Zaustavlja nit, vise se ne poziva. */
+void taskStop( TaskType *task );
+
+void timerSet( TimerType *timer, uint32_t interval );
+uint8_t timerExpired( const TimerType *timer );
+
+#endif
@@ -24,6 +24,9 @@
 #include "stm32f10x_it.h"
 #include "STM32vldiscovery.h"
 #include "Communication.h"
+#include "scheduler.h"
+#include "power_monitor.h"
+#include "ir_sensor.h"
   
 
 /** @addtogroup Examples
@@ -38,8 +41,6 @@
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
     
-int global_tick = 0;
-int cnt_90 = 0;
 bool FLAG_stop = FALSE;
 
 /* GLobal variables ---------------------------------------------------------*/
@@ -52,8 +53,6 @@ uint16_t received_byte;
 extern bool flag_go_to_stop;
 /* Private function prototypes -----------------------------------------------*/
 
-void sleep(int);
-void BateryDisp (void);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -156,19 +155,24 @@ void PendSV_Handler(void)
 /******************************************************************************/
 
 /**
-  * @brief  This function handles External line0 interrupt request.
+  * @brief  DMA ADC-a je popunio pola ili ceo bafer, sabira se polovina koju
+  *         DMA vise ne pise, za napone i za IR senzore.
   * @param  None
   * @retval None
   */
-
-void TIM7_IRQHandler(void)
+void DMA1_Channel1_IRQHandler( void )
 {
-  if( TIM_GetITStatus( TIM7, TIM_IT_Update ) == SET )
+  if( DMA_GetITStatus( DMA1_IT_HT1 ) == SET )
+  {
+    DMA_ClearITPendingBit( DMA1_IT_HT1 );
+    powerMonitorHalf( &adc_dma_buffer[ 0 ] );
+    irSensorHalf( &adc_dma_buffer[ 0 ] );
+  }
+  if( DMA_GetITStatus( DMA1_IT_TC1 ) == SET )
   {
-    TIM_ClearITPendingBit(TIM7, TIM_IT_Update);
-    if( cnt_90 == 10 )
-      TIM3->CCR3 = 950;
-    else cnt_90++;
+    DMA_ClearITPendingBit( DMA1_IT_TC1 );
+    powerMonitorHalf( &adc_dma_buffer[ PM_DMA_LENGTH / 2 ] );
+    irSensorHalf( &adc_dma_buffer[ PM_DMA_LENGTH / 2 ] );
   }
 }
 
@@ -178,24 +182,9 @@ void TIM7_IRQHandler(void)
   * @retval None
   */
 
-void SysTick_Handler(void) // tajmer koji nam broji 100 
+void SysTick_Handler(void) // takt za niti, 1ms
 { 
-  if (global_tick>0) global_tick--;
-}
-
-/**
-  * @brief  Obradjuje prekide pristigle od nekog kanala tajmera 3.
-  * @param  None
-  * @retval None
-  */
-
-void TIM3_IRQHandler(void) // tajmer koji nam broji 90s 
-{ 
-  if( TIM_GetITStatus( TIM3, TIM_IT_Update ) == SET )
-  {
-    TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
-    BateryDisp();
-  }
+  schedulerTick();
 }
 
 void USART3_IRQHandler( void )
@@ -0,0 +1,59 @@
+/**
+*   @file:    command_table.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kodovi komandi koje ploca kretanja prima preko RS485 i tip
+*             tabele skokova koja se indeksira direktno kodom komande.
+*/
+
+#ifndef __COMMAND_TABLE_H__
+#define __COMMAND_TABLE_H__
+
+/* Kodovi komandi (received_array[0]). */
+#define CMD_SET_POSITION      0x01  // Setovanje pozicije robota(x, y, ugao).
+#define CMD_MOVE_FORWARD      0x04  // Kretanje napred.
+#define CMD_MOVE_BACKWARD     0x05  // Kretanje nazad.
+#define CMD_ROTATE_RIGHT      0x06  // Rotacija desno.
+#define CMD_ROTATE_LEFT       0x07  // Rotacija levo.
+#define CMD_STOP              0x0A  // Emergency stop.
+#define CMD_ULTRASOUND_ON     0x11  // Paljenje senzora.
+#define CMD_ULTRASOUND_OFF    0x12  // Gasenje senzora.
+#define CMD_WALL_TARGET       0x13  // Cilj sledeceg pokreta je zid ili kucica.
+#define CMD_ANGULAR_CONST     0xE0  // Podesavanje uglovne konstante.
+#define CMD_RESET_POSITION    0xE2  // Reset pozicije na nulu.
+#define CMD_CORRIDOR          0xE3  // Slobodan put u cm (bit 15 unazad), odgovor u cm.
+#define CMD_LOG_READ          0xE8  // Citanje data_log-a (offset, broj).
+#define CMD_TRACE_CONFIG      0xE9  // Kanali, dogadjaji, decimacija i zapisi pre dogadjaja.
+#define CMD_TRACE_ARM         0xEA  // Pocetak snimanja.
+#define CMD_TRACE_TRIGGER     0xEB  // Rucni dogadjaj za snimanje.
+#define CMD_TRACE_STATUS      0xEC  // Stanje snimanja.
+#define CMD_ISR_PROFILE       0xED  // Statistika prekidne rutine (id), 0xFF brise.
+#define CMD_SUPPLY_VOLTAGE    0xEE  // Napon baterije u mV, salje glavna ploca.
+#define CMD_START_RUNNING     0xFA  // Start meca.
+#define CMD_PRESCALER         0xFB  // Podesavanje preskalera za brzinu.
+#define CMD_CHECK_ARRIVE      0xFC  // Da li je robot stigao u zadatu poziciju.
+#define CMD_STATUS            0xF7  // Pozicija, rotacija i ready flag.
+
+/* Broj nibl-ova u svakom od kodiranih polja. */
+#define PAYLOAD_DATA8         2     // 8-bitni podatak.
+#define PAYLOAD_DATA16        4     // 16-bitni podatak.
+#define PAYLOAD_DATA16_ID     6     // 16-bitni podatak i ID komande.
+#define PAYLOAD_POSITION      24    // Tri 32-bitna podatka.
+#define PAYLOAD_TRACE_CONFIG  12    // Dva 8-bitna i dva 16-bitna podatka.
+
+/* Obrada jedne komande. Podaci su u received_array[1..]. */
+typedef void (*CommandHandler)( void );
+
+typedef struct {
+  CommandHandler handler;       // NULL - komanda nije definisana.
+  unsigned char payload_len;    // Minimalan broj bajtova iza koda komande.
+} CommandEntry;
+
+/* Trajanje poslednjeg i najduzeg dispecovanja komande, u ciklusima. */
+extern unsigned long dispatch_cycles_last;
+extern unsigned long dispatch_cycles_max;
+/* Broj odbacenih poruka zbog prekratkog sadrzaja. */
+extern unsigned int command_rejected;
+
+#endif
@@ -0,0 +1,35 @@
+/**
+*   @file:    cycle_counter.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Merenje trajanja koda u ciklusima procesora preko DWT CYCCNT
+*             brojaca. CMSIS 1.30 nema DWT strukturu pa se koriste apsolutne
+*             adrese registara. Za host build se CYCLE_COUNTER_READ moze
+*             predefinisati pre ukljucivanja ovog fajla.
+*/
+
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#include "stm32f10x.h"
+
+#define DWT_CTRL_REG      (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT_REG    (*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA 0x00000001
+#define DEMCR_TRCENA       0x01000000
+
+#ifndef CYCLE_COUNTER_READ
+/* Ukljucuje trace blok i pokrece brojac ciklusa. Poziva se jednom iz main-a. */
+#define CYCLE_COUNTER_INIT()  do { CoreDebug->DEMCR |= DEMCR_TRCENA; \
+                                   DWT_CYCCNT_REG = 0;               \
+                                   DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA; } while (0)
+/* Trenutna vrednost brojaca, 24 MHz -> 1 ciklus = 41.67 ns. */
+#define CYCLE_COUNTER_READ()  (DWT_CYCCNT_REG)
+#endif
+
+#ifndef CYCLE_COUNTER_INIT
+#define CYCLE_COUNTER_INIT()
+#endif
+
+#endif
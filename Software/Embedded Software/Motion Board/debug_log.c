@@ -0,0 +1,170 @@
+/**
+*   @file:    debug_log.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kruzni bafer debug poruka i slanje preko DMA, videti debug_log.h.
+*/
+
+#include <stdarg.h>
+
+#include "stm32f10x.h"
+#include "stm32f10x_dma.h"
+#include "stm32f10x_usart.h"
+#include "EUROBOT_Init.h"
+#include "print.h"
+#include "debug_log.h"
+#include "isr_profiler.h"
+
+volatile uint32_t log_dropped = 0;
+
+static char log_slot[LOG_SLOTS][LOG_SLOT_SIZE];
+/* Duzina spremne poruke, 0 dok je slot slobodan ili se u njega upisuje. */
+static volatile uint8_t log_len[LOG_SLOTS];
+/* Broj rezervisanih slotova, pisu ga svi koji loguju. */
+static volatile uint32_t log_head = 0;
+/* Broj poslatih slotova, pise ga samo DMA prekid. */
+static volatile uint32_t log_tail = 0;
+/* Odbacene poruke koje jos nisu prijavljene. */
+static volatile uint32_t log_dropped_pending = 0;
+static volatile uint8_t log_busy = 0;
+
+static const char log_prefix[] = "?EWID";
+
+/*----------------------------------------------------------------------------*/
+static void AtomicAdd( volatile uint32_t *value, uint32_t add )
+{
+  uint32_t old;
+
+  do
+  {
+    old = __LDREXW( (uint32_t *)value );
+  } while ( __STREXW( old + add, (uint32_t *)value ) );
+}
+/*----------------------------------------------------------------------------*/
+static uint32_t AtomicTake( volatile uint32_t *value )
+{
+  uint32_t old;
+
+  do
+  {
+    old = __LDREXW( (uint32_t *)value );
+  } while ( __STREXW( 0, (uint32_t *)value ) );
+  return old;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  USART2 samo TX na PA2, DMA1 kanal 7 iz memorije u USART2->DR.
+  *         Prekid kanala ima najnizi prioritet (15, kao SysTick), ispis ne
+  *         sme da kasni regulaciju ni RS485 komunikaciju.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void LogInit( void )
+{
+  DMA_InitTypeDef DMA_InitStructure;
+
+  /* Ukljucuje i takt za USART2 i pinove PA2/PA3. */
+  InitDefaultUSART( USART2, USART_Mode_Tx, 115200 );
+  RCC_AHBPeriphClockCmd( RCC_AHBPeriph_DMA1, ENABLE );
+
+  DMA_DeInit( DMA1_Channel7 );
+  DMA_StructInit( &DMA_InitStructure );
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)(uintptr_t)&USART2->DR;
+  DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)(uintptr_t)log_slot[0];
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+  DMA_InitStructure.DMA_BufferSize = 1;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+  DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+  DMA_Init( DMA1_Channel7, &DMA_InitStructure );
+  DMA_ITConfig( DMA1_Channel7, DMA_IT_TC, ENABLE );
+  USART_DMACmd( USART2, USART_DMAReq_Tx, ENABLE );
+
+  InitNVICChannel( DMA1_Channel7_IRQn, 0x0F, 0x0F, ENABLE );
+  /* Firmware ne poziva NVIC_PriorityGroupConfig, pa NVIC_Init upisuje
+     prioritet 0. Najnizi prioritet se upisuje direktno, kao u SysTick_Config. */
+  NVIC_SetPriority( DMA1_Channel7_IRQn, 0x0F );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Rezervise slot pomeranjem log_head-a, formatira poruku u njega i
+  *         javlja DMA prekidu da ima posla. Slotovi se salju redom, pa slot
+  *         koji je kasnije rezervisan ceka dok se prethodni ne popuni.
+  * @param  level: LOG_LEVEL_*, ispisuje se kao prvo slovo poruke.
+  * @param  format: format kao za printf.
+  * @retval 1 ako je poruka upisana, 0 ako je bafer bio pun.
+  */
+int LogPrintf( uint8_t level, const char *format, ... )
+{
+  uint32_t head, dropped;
+  char *slot;
+  int len;
+  va_list args;
+
+  do
+  {
+    head = __LDREXW( (uint32_t *)&log_head );
+    if ( head - log_tail >= LOG_SLOTS )
+    {
+      __CLREX();
+      AtomicAdd( &log_dropped, 1 );
+      AtomicAdd( &log_dropped_pending, 1 );
+      return 0;
+    }
+  } while ( __STREXW( head + 1, (uint32_t *)&log_head ) );
+
+  slot = log_slot[ head & ( LOG_SLOTS - 1 ) ];
+  slot[0] = log_prefix[ level < sizeof( log_prefix ) - 1 ? level : 0 ];
+  slot[1] = ' ';
+  len = 2;
+  dropped = AtomicTake( &log_dropped_pending );
+  if ( dropped ) len += sprintf( slot + len, "(-%d) ", (int)dropped );
+
+  va_start( args, format );
+  len += vsnprint( slot + len, LOG_SLOT_SIZE - 2 - len, format, args );
+  va_end( args );
+  if ( len > LOG_SLOT_SIZE - 3 ) len = LOG_SLOT_SIZE - 3;
+  slot[ len++ ] = '\r';
+  slot[ len++ ] = '\n';
+
+  log_len[ head & ( LOG_SLOTS - 1 ) ] = len;
+  NVIC_SetPendingIRQ( DMA1_Channel7_IRQn );
+  return 1;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Jedini citalac bafera. Na kraju prenosa oslobadja poslat slot i
+  *         pokrece prenos sledeceg ako je spreman. Poziva se i softverski iz
+  *         LogPrintf() preko pending bita.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void DMA1_Channel7_IRQHandler( void )
+{
+  uint32_t slot;
+  ISR_PROFILE_ENTER();
+
+  if ( DMA_GetITStatus( DMA1_IT_TC7 ) )
+  {
+    DMA_ClearITPendingBit( DMA1_IT_GL7 );
+    DMA_Cmd( DMA1_Channel7, DISABLE );
+    log_len[ log_tail & ( LOG_SLOTS - 1 ) ] = 0;
+    log_tail++;
+    log_busy = 0;
+  }
+
+  slot = log_tail & ( LOG_SLOTS - 1 );
+  if ( !log_busy && log_tail != log_head && log_len[ slot ] )
+  {
+    DMA1_Channel7->CMAR = (uint32_t)(uintptr_t)log_slot[ slot ];
+    DMA1_Channel7->CNDTR = log_len[ slot ];
+    log_busy = 1;
+    DMA_Cmd( DMA1_Channel7, ENABLE );
+  }
+  ISR_PROFILE_EXIT( ISR_ID_DMA1_CH7 );
+}
@@ -0,0 +1,72 @@
+/**
+*   @file:    debug_log.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Debug ispis koji ne blokira. Poruka se formatira direktno u
+*             slobodan slot kruznog bafera, a slotove salje DMA na USART2 TX
+*             (PA2, 115200). Upis je bez zakljucavanja (LDREX/STREX), pa se
+*             LOG_* moze zvati i iz prekida. Kada je bafer pun poruka se
+*             odbacuje i broji, a sledeca poruka koja prodje nosi broj
+*             izgubljenih. USART3 ostaje samo za RS485 komande.
+*
+*             U log idu assert_failed, odbacene komande, zaustavljanje zbog
+*             prepreke, prvi ping grupe bez kraja i, na LOG_LEVEL_DEBUG,
+*             greska brzine iz ControlLoop-a (ranije zakomentarisan
+*             USART_SendData na RS485 magistralu).
+*
+*             Nivo se bira sa LOG_LEVEL u opcijama projekta. Pozivi iznad
+*             nivoa ne generisu kod, a LOG_LEVEL=0 iskljucuje sav ispis.
+*/
+
+#ifndef __DEBUG_LOG_H__
+#define __DEBUG_LOG_H__
+
+#include "stm32f10x.h"
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_SLOTS       8     // Mora biti stepen dvojke.
+#define LOG_SLOT_SIZE   64    // Duze poruke se skracuju.
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)  LogPrintf( LOG_LEVEL_ERROR, __VA_ARGS__ )
+#else
+#define LOG_ERROR(...)  ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)   LogPrintf( LOG_LEVEL_WARN, __VA_ARGS__ )
+#else
+#define LOG_WARN(...)   ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)   LogPrintf( LOG_LEVEL_INFO, __VA_ARGS__ )
+#else
+#define LOG_INFO(...)   ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)  LogPrintf( LOG_LEVEL_DEBUG, __VA_ARGS__ )
+#else
+#define LOG_DEBUG(...)  ((void)0)
+#endif
+
+/* Ukupan broj odbacenih poruka od LogInit(). */
+extern volatile uint32_t log_dropped;
+
+/* USART2 TX, DMA1 kanal 7 i njegov prekid. */
+void LogInit( void );
+/* Formatira poruku u slobodan slot, vraca 0 ako je poruka odbacena. */
+int LogPrintf( uint8_t level, const char *format, ... );
+
+#endif
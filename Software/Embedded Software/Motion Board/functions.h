@@ -2,4 +2,5 @@ void PositionControllerInit(void);
 void position_controler_X (void);
 void position_controler_Y (void);
 int Speed_profile_X (int, int);
-int Speed_profile_Y (int, int);
\ No newline at end of file
+int Speed_profile_Y (int, int);
+void ObstacleTaskInit(void);
\ No newline at end of file
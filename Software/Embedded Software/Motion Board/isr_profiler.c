@@ -0,0 +1,151 @@
+/**
+*   @file:    isr_profiler.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Statistika trajanja prekidnih rutina, videti isr_profiler.h.
+*/
+
+#include <string.h>
+
+#include "stm32f10x.h"
+#include "cycle_counter.h"
+#include "isr_profiler.h"
+
+IsrProfileStats isr_profile[ISR_ID_NUM];
+uint8_t isr_profile_max_depth = 0;
+
+static uint8_t isr_depth = 0;
+/* Ciklusi koje su na datom nivou potrosile ugnjezdene rutine. */
+static uint32_t isr_child[ISR_PROFILE_MAX_DEPTH + 1];
+static uint32_t isr_overhead = 0;
+static uint32_t load_window_start = 0;
+static uint64_t load_busy = 0;
+static volatile uint8_t isr_reset_request = 0;
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Brise statistiku. Cena para Enter/Exit se meri na praznom pozivu i
+  *         posle se oduzima od svakog merenja.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void IsrProfileInit( void )
+{
+  uint32_t start;
+  uint8_t id;
+
+  isr_overhead = 0;
+  start = IsrProfileEnter();
+  IsrProfileExit( ISR_ID_SYSTICK, start );
+  isr_overhead = isr_profile[ ISR_ID_SYSTICK ].max;
+
+  memset( isr_profile, 0, sizeof( isr_profile ) );
+  for ( id = 0; id < ISR_ID_NUM; id++ ) isr_profile[ id ].min = 0xFFFFFFFF;
+  isr_profile_max_depth = 0;
+  load_busy = 0;
+  load_window_start = CYCLE_COUNTER_READ();
+}
+/*----------------------------------------------------------------------------*/
+void IsrProfileRequestReset( void )
+{
+  isr_reset_request = 1;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Brisanje koje je zahtevala prekidna rutina. Iz glavne petlje nema
+  *         otvorenog merenja, a prekidi su zabranjeni dok se meri cena
+  *         merenja i brise statistika.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void IsrProfileService( void )
+{
+  uint32_t primask;
+
+  if ( !isr_reset_request ) return;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  IsrProfileInit();
+  isr_reset_request = 0;
+  __set_PRIMASK( primask );
+}
+/*----------------------------------------------------------------------------*/
+uint32_t IsrProfileEnter( void )
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now;
+
+  __disable_irq();
+  if ( isr_depth < ISR_PROFILE_MAX_DEPTH ) isr_depth++;
+  if ( isr_depth > isr_profile_max_depth ) isr_profile_max_depth = isr_depth;
+  isr_child[ isr_depth ] = 0;
+  now = CYCLE_COUNTER_READ();
+  __set_PRIMASK( primask );
+  return now;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Racuna sopstveno vreme rutine (ukupno minus ugnjezdene rutine) i
+  *         dodaje ukupno vreme roditelju, ako postoji.
+  * @param  id: ISR_ID_* rutine koja se zavrsava.
+  * @param  start: vrednost koju je vratio IsrProfileEnter().
+  * @retval Nema povratnih vrednosti.
+  */
+void IsrProfileExit( uint8_t id, uint32_t start )
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t elapsed, self, bucket;
+  IsrProfileStats *s = &isr_profile[ id ];
+
+  __disable_irq();
+  elapsed = CYCLE_COUNTER_READ() - start;
+  elapsed = elapsed > isr_overhead ? elapsed - isr_overhead : 0;
+  self = elapsed > isr_child[ isr_depth ] ? elapsed - isr_child[ isr_depth ] : 0;
+  if ( isr_depth > 1 )
+  {
+    isr_child[ isr_depth - 1 ] += elapsed;
+    s->nested++;
+  }
+  if ( isr_depth > 0 ) isr_depth--;
+
+  s->count++;
+  s->sum += self;
+  load_busy += self;
+  if ( self < s->min ) s->min = self;
+  if ( self > s->max ) s->max = self;
+  for ( bucket = 0; ( self >> ( bucket + 1 ) ) && bucket < ISR_PROFILE_BUCKETS - 1; bucket++ );
+  if ( s->hist[ bucket ] < 0xFFFF ) s->hist[ bucket ]++;
+  __set_PRIMASK( primask );
+}
+/*----------------------------------------------------------------------------*/
+void IsrProfileLatency( uint8_t id, uint32_t cycles )
+{
+  if ( cycles > isr_profile[ id ].latency_max ) isr_profile[ id ].latency_max = cycles;
+}
+/*----------------------------------------------------------------------------*/
+uint32_t IsrProfileAverage( uint8_t id )
+{
+  if ( isr_profile[ id ].count == 0 ) return 0;
+  return (uint32_t)( isr_profile[ id ].sum / isr_profile[ id ].count );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Deo vremena od prethodnog poziva koji je proveden u merenim
+  *         rutinama. Poziv ujedno brise load_busy i pomera pocetak prozora,
+  *         pa dva citaoca jedan drugom skracuju prozor. CYCCNT se prelije
+  *         posle 179 s na 24 MHz, pa prozor mora biti kraci od toga.
+  * @param  Nema ulaznih argumenata.
+  * @retval Opterecenje u promilima.
+  */
+uint16_t IsrProfileLoad( void )
+{
+  uint32_t now = CYCLE_COUNTER_READ();
+  uint32_t window = now - load_window_start;
+  uint64_t busy = load_busy;
+
+  load_busy = 0;
+  load_window_start = now;
+  if ( window == 0 ) return 0;
+  return (uint16_t)( busy * 1000 / window );
+}
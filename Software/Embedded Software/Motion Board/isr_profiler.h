@@ -0,0 +1,81 @@
+/**
+*   @file:    isr_profiler.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Merenje trajanja prekidnih rutina pomocu DWT CYCCNT brojaca.
+*             Ukljucuje se definisanjem ISR_PROFILE u opcijama projekta, bez
+*             toga makroi ISR_PROFILE_ENTER/EXIT ne generisu kod. Meri se
+*             sopstveno vreme rutine (bez prekida koji su je prekinuli), pa se
+*             zbir svih rutina moze direktno uporediti sa ukupnim vremenom.
+*             Na host build-u izvor ciklusa je CYCLE_COUNTER_READ iz
+*             cycle_counter.h, a statistika se cita direktno iz isr_profile[].
+*/
+
+#ifndef __ISR_PROFILER_H__
+#define __ISR_PROFILER_H__
+
+#include "stm32f10x.h"
+
+/* Identifikatori rutina koje se mere. */
+#define ISR_ID_SYSTICK     0
+#define ISR_ID_EXTI2       1
+#define ISR_ID_EXTI9_5     2
+#define ISR_ID_EXTI15_10   3
+#define ISR_ID_TIM4        4
+#define ISR_ID_USART3      5
+#define ISR_ID_TIM2        6
+#define ISR_ID_TIM7        7
+#define ISR_ID_TIM15       8
+#define ISR_ID_TIM3        9
+#define ISR_ID_DMA1_CH7    10
+#define ISR_ID_TIM6        11
+#define ISR_ID_NUM         12
+
+#define ISR_PROFILE_BUCKETS   16  // Histogram po stepenima dvojke: [2^k, 2^(k+1)) ciklusa.
+#define ISR_PROFILE_MAX_DEPTH 8
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t nested;                        // Koliko puta je rutina prekinula drugu rutinu.
+  uint32_t latency_max;                   // Najvece kasnjenje od dogadjaja do ulaska u rutinu.
+  uint16_t hist[ISR_PROFILE_BUCKETS];
+} IsrProfileStats;
+
+extern IsrProfileStats isr_profile[ISR_ID_NUM];
+extern uint8_t isr_profile_max_depth;
+
+#ifdef ISR_PROFILE
+#define ISR_PROFILE_ENTER()     uint32_t isr_profile_start = IsrProfileEnter()
+#define ISR_PROFILE_EXIT(id)    IsrProfileExit( (id), isr_profile_start )
+#define ISR_PROFILE_LATENCY(id, cycles)  IsrProfileLatency( (id), (cycles) )
+#else
+#define ISR_PROFILE_ENTER()
+#define ISR_PROFILE_EXIT(id)
+#define ISR_PROFILE_LATENCY(id, cycles)
+#endif
+
+/* Brise statistiku i meri cenu samog merenja. Ne poziva se iz prekida. */
+void IsrProfileInit( void );
+/* Zahtev za brisanje iz prekidne rutine, izvrsava ga IsrProfileService(). */
+void IsrProfileRequestReset( void );
+/* Poziva se iz glavne petlje. */
+void IsrProfileService( void );
+/* Pocetak merenja, vraca trenutnu vrednost brojaca. */
+uint32_t IsrProfileEnter( void );
+/* Kraj merenja rutine id. */
+void IsrProfileExit( uint8_t id, uint32_t start );
+/* Kasnjenje rutine id u ciklusima, za rutine ciji izvor ima vremensku oznaku
+   dogadjaja (SysTick->VAL). */
+void IsrProfileLatency( uint8_t id, uint32_t cycles );
+/* Prosecno trajanje rutine u ciklusima. */
+uint32_t IsrProfileAverage( uint8_t id );
+/* Opterecenje procesora prekidima od poslednjeg poziva, u promilima. Svaki
+   poziv brise akumulirano vreme i zapocinje novi prozor, pa sme da postoji
+   samo jedan citalac (CMD_ISR_PROFILE). */
+uint16_t IsrProfileLoad( void );
+
+#endif
@@ -27,6 +27,18 @@
 
 #include "functions.h"
 #include "variables.h"
+#include "cycle_counter.h"
+#include "trace_recorder.h"
+#include "isr_profiler.h"
+#include "debug_log.h"
+#include "ultrasound.h"
+#include "occupancy_grid.h"
+
+/* Cekanje u glavnoj petlji. Na ploci je prazno (petlja se vrti), a host build
+   (Host/hal) ga predefinise da pomeri virtuelno vreme do sledeceg prekida. */
+#ifndef MAIN_IDLE
+#define MAIN_IDLE()
+#endif
 
 /** @addtogroup Examples
   * @{
@@ -81,6 +93,9 @@ int main(void)
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
     TIM_OCInitTypeDef TIM_OCInitStruct;
     
+    /* Zone usporavanja pre prvog SysTick-a, ObstacleTask() ih koristi od prvog poziva. */
+    ObstacleTaskInit();
+    
     /* Pokretanje SysTick prekida u kome se prsi PID kontrola. */
     SysTick_Config(SystemCoreClock / 100);
     
@@ -362,9 +377,13 @@ int main(void)
     GPIO_Init( GPIOA, &GPIO_InitStructure );
     GPIO_StructInit(&GPIO_InitStructure);     
 
+    CYCLE_COUNTER_INIT();
+    IsrProfileInit();
+    LogInit();
     UsartInit();    
     PositionControllerInit();
     InitUltrasoundHCSR04();
+    TraceInit();
     
     /*dakle plan jesledeci:
     glavni kontroler salje komandu start counting cim se pokrene tj. u nultom stanju
@@ -376,6 +395,9 @@ int main(void)
   */
   while (!running)//ovde ceka dadobije running od glavnog kontrolera
   {
+    TraceService();
+    IsrProfileService();
+    MAIN_IDLE();
   } 
   
   //ovde inicijalizauje TIMER6
@@ -384,6 +406,9 @@ int main(void)
   while (running)
   {
     //odje vozimo
+    TraceService();
+    IsrProfileService();
+    MAIN_IDLE();
   }
   //odje gasimo sve jer je timer 6 rekid opet oborio running na FALSE
     
@@ -393,7 +418,7 @@ int main(void)
     GPIO_ResetBits(GPIOC,GPIO_Pin_9);
     GPIO_ResetBits(GPIOC,GPIO_Pin_8);
   
-  while(1);
+  while(1) MAIN_IDLE();
 }
 
 void InitTimer6(void){
@@ -427,12 +452,9 @@ void InitUltrasoundHCSR04( void )
   InitGPIO_Pin( GPIOB, GPIO_Pin_1, GPIO_Mode_AF_PP, GPIO_Speed_50MHz ); // channel 4 tim3 - B1
   
   
-  /* Perioda trigger signala je 75 ms sa korakom 5us. Jedan je edge-aligned a drugi centre-aligned
-     da ne bi smetali jedan drugom. Maksimalno trajanja signala echo je 2.5 ms tako da je trenutna
-     razlika od ~37ms izmedju signala sasvim dovoljna. */
-  InitTIM_TimeBase( TIM3, 120 - 1, 15000 - 1, TIM_CounterMode_Up, TIM_CKD_DIV1, 0x00 );
-  InitTIM_OC( TIM3, TIM_Channel_3, TIM_OutputState_Enable, TIM_OCMode_PWM1, 2, TIM_OCPolarity_High );  // edge-aligned
-  InitTIM_OC( TIM3, TIM_Channel_4, TIM_OutputState_Enable, TIM_OCMode_PWM2, 2, TIM_OCPolarity_High );  // centre-aligned
+  /* Tajmer trigger-a broji slobodno sa korakom 5 us (perioda 327 ms). Trenutak svakog trigger
+     impulsa zadaje raspored iz ultrasound.c preko poredjenja na kanalima 3 i 4. */
+  InitTIM_TimeBase( TIM3, 120 - 1, 0xFFFF, TIM_CounterMode_Up, TIM_CKD_DIV1, 0x00 );
   
   
   /* Inicijalizacija pinvoa za prijem echo-a. */
@@ -445,25 +467,23 @@ void InitUltrasoundHCSR04( void )
   /* Perioda tajmera koji prima echo signal je 50 ms sa korakom 1 us. Svaki kanal meri signal
      sa jednog ultrazvucnog senzora. */ 
   InitTIM_TimeBase( TIM4, 24 - 1, 50000 - 1, TIM_CounterMode_Up, TIM_CKD_DIV1, 0x00 );
-  InitTIM_IC( TIM4, TIM_Channel_1, TIM_ICSelection_DirectTI, TIM_ICPSC_DIV1, 0x00, TIM_ICPolarity_Rising );
-  InitTIM_IC( TIM4, TIM_Channel_2, TIM_ICSelection_DirectTI, TIM_ICPSC_DIV1, 0x00, TIM_ICPolarity_Rising );
-  InitTIM_IC( TIM4, TIM_Channel_3, TIM_ICSelection_DirectTI, TIM_ICPSC_DIV1, 0x00, TIM_ICPolarity_Rising );
-  InitTIM_IC( TIM4, TIM_Channel_4, TIM_ICSelection_DirectTI, TIM_ICPSC_DIV1, 0x00, TIM_ICPolarity_Rising );
   
   
   /* Trigger za interrupt nam dolazi od prvog ulaza u tajmer. */
   TIM_SelectInputTrigger( TIM4, TIM_TS_TI1FP1 ); // TIM_TS_TI1FP1 znaci Filtered Timer Input 1
   
  
-  /* Osposabljavanje prekida za belezenje trenutne vrednosti u brojacu tajmera radi racunanja udaljenosti objekta. */
-  TIM_ITConfig( TIM4, TIM_IT_CC1, ENABLE );
-  TIM_ITConfig( TIM4, TIM_IT_CC2, ENABLE );
-  TIM_ITConfig( TIM4, TIM_IT_CC3, ENABLE );
-  TIM_ITConfig( TIM4, TIM_IT_CC4, ENABLE );
+  /* Kanali za hvatanje echo signala iz tabele u ultrasound.c i njihovi prekidi za belezenje
+     trenutne vrednosti u brojacu tajmera radi racunanja udaljenosti objekta, trigger kanali
+     i prvi ping. */
+  UltrasoundInit();
+  OgInit();
   
   
-  /* Inicijalizacija NVIC kanala. */
+  /* Inicijalizacija NVIC kanala. Trigger i echo prekidi su istog prioriteta jer dele stanje
+     rasporeda pingova. */
   InitNVICChannel( TIM4_IRQn, 0, 0, ENABLE );
+  InitNVICChannel( TIM3_IRQn, 0, 0, ENABLE );
   
 }
 
@@ -477,8 +497,8 @@ void InitUltrasoundHCSR04( void )
   */
 void assert_failed(uint8_t* file, uint32_t line)
 { 
-  /* User can add his own implementation to report the file name and line number,
-     ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
+  /* Ispis ide kroz DMA log, ne blokira ni kada je assert u prekidu. */
+  LOG_ERROR( "assert %s:%u", (char *)file, (int)line );
 
   /* Infinite loop */
   while (1)
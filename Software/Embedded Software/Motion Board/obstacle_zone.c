@@ -0,0 +1,121 @@
+/**
+*   @file:    obstacle_zone.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Usporavanje ispred prepreke, videti obstacle_zone.h.
+*/
+
+#include "obstacle_zone.h"
+
+/*----------------------------------------------------------------------------*/
+void ObstacleZoneInit( ObstacleZoneType *z, uint8_t nominal )
+{
+  z->nominal = nominal;
+  z->limit = nominal;
+  z->hold = 0;
+  z->ttc_ms = OBST_NO_TTC;
+  z->holds = 0;
+  z->wall = 0;
+  z->docking = 0;
+  z->moved = 0;
+  z->travel = 0;
+  z->object_min = z->object_max = 0;
+}
+/*----------------------------------------------------------------------------*/
+void ObstacleZoneWall( ObstacleZoneType *z, uint8_t wall )
+{
+  z->wall = wall;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Polozaj vrednosti x izmedju lo i hi u Q8.
+  * @param  x predstavlja vrednost.
+  * @param  lo predstavlja donju granicu, daje 0.
+  * @param  hi predstavlja gornju granicu, daje 256.
+  * @retval Polozaj, 0..256.
+  */
+static uint16_t ObstacleFraction( uint32_t x, uint32_t lo, uint32_t hi )
+{
+  if ( x <= lo ) return 0;
+  if ( x >= hi ) return 256;
+  return (uint16_t)( ( ( x - lo ) << 8 ) / ( hi - lo ) );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Racuna ogranicenje brzine. Poziva se svakih 10 ms.
+  * @param  z predstavlja stanje zone.
+  * @param  distance_mm predstavlja udaljenost najblize prepreke u smeru
+  *         kretanja, US_NO_DATA ako je nema.
+  * @param  speed_mm_s predstavlja sopstvenu brzinu.
+  * @param  closing_mm_s predstavlja brzinu priblizavanja prepreke,
+  *         OBST_NO_RATE ako nije poznata.
+  * @param  remaining_mm predstavlja preostali put do cilja.
+  * @retval Ogranicenje brzine, 0 kada treba stajati.
+  */
+uint8_t ObstacleZoneUpdate( ObstacleZoneType *z, uint16_t distance_mm, uint16_t speed_mm_s,
+                            int16_t closing_mm_s, uint16_t remaining_mm )
+{
+  uint32_t ttc = OBST_NO_TTC, stop_mm;
+  int32_t closing = speed_mm_s, object;
+  uint16_t f_distance, f_ttc;
+  uint8_t target;
+
+  /* Prepreka koja se nije pomerila od kada je vidjena, na cilju koji je
+     misija oznacila kao zid, kome se prilazi polako. Protivnik koji je
+     prisao pa stao nije zid. */
+  z->docking = 0;
+  z->travel += speed_mm_s;
+  object = z->travel / 100 + distance_mm;
+  if ( closing_mm_s == OBST_NO_RATE )
+  {
+    z->moved = 0;
+    z->object_min = z->object_max = object;
+  }
+  else
+  {
+    closing = closing_mm_s > 0 ? closing_mm_s : 0;
+    if ( object < z->object_min ) z->object_min = object;
+    if ( object > z->object_max ) z->object_max = object;
+    if ( z->object_max - z->object_min > OBST_MOVED_MM ) z->moved = 1;
+    if ( z->wall && !z->moved && speed_mm_s <= OBST_DOCK_MM_S &&
+         (uint32_t)remaining_mm + OBST_DOCK_BEYOND_MM >= distance_mm &&
+         (uint32_t)distance_mm + OBST_DOCK_SHORT_MM >= remaining_mm )
+      z->docking = 1;
+  }
+
+  if ( closing && !z->docking )
+  {
+    ttc = (uint32_t)distance_mm * 1000 / (uint32_t)closing;
+    if ( ttc >= OBST_NO_TTC ) ttc = OBST_NO_TTC - 1;
+  }
+  z->ttc_ms = (uint16_t)ttc;
+
+  /* Unutrasnja zona, sa histerezom na izlasku. Pri prilazu zidu ne
+     zaustavlja TTC, ali prag vazi uvek. Prag raste sa brzinom
+     priblizavanja jer se do sledeceg merenja i kocenja jos prilazi. */
+  stop_mm = OBST_STOP_MM + OBST_NOISE_MM + (uint32_t)closing * OBST_REACTION_MS / 1000;
+  if ( distance_mm <= stop_mm || z->ttc_ms <= OBST_TTC_STOP_MS ||
+       ( z->hold && distance_mm <= stop_mm + OBST_RELEASE_MM - OBST_STOP_MM ) )
+  {
+    if ( !z->hold ) z->holds++;
+    z->hold = 1;
+    z->limit = OBST_MIN_SPEED;
+    return 0;
+  }
+  z->hold = 0;
+
+  /* Zona usporavanja: odlucuje blizi od dva uslova. */
+  f_distance = ObstacleFraction( distance_mm, OBST_STOP_MM, OBST_SLOW_MM );
+  f_ttc = ObstacleFraction( z->ttc_ms, OBST_TTC_STOP_MS, OBST_TTC_SLOW_MS );
+  if ( f_ttc < f_distance ) f_distance = f_ttc;
+  target = OBST_MIN_SPEED;
+  if ( z->nominal > OBST_MIN_SPEED )
+    target += (uint8_t)( ( (uint16_t)( z->nominal - OBST_MIN_SPEED ) * f_distance ) >> 8 );
+
+  if ( target < z->limit ) z->limit = target;
+  else if ( z->limit + OBST_RAMP_UP < target ) z->limit += OBST_RAMP_UP;
+  else z->limit = target;
+  return z->limit;
+}
+/*----------------------------------------------------------------------------*/
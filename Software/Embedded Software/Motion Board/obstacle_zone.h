@@ -0,0 +1,80 @@
+/**
+*   @file:    obstacle_zone.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Usporavanje ispred prepreke. Umesto zaustavljanja cim je
+*             prepreka blize od 300 mm, ogranicenje brzine (maximum_speed_X/Y,
+*             1..60) se smanjuje u zoni usporavanja srazmerno udaljenosti i
+*             vremenu do sudara (TTC, udaljenost / sopstvena brzina), a staje
+*             se samo u unutrasnjoj zoni. Prag unutrasnje zone je
+*             OBST_STOP_MM uvecan za sum senzora i put koji se predje za
+*             OBST_REACTION_MS brzinom priblizavanja, pa robot sam ne prilazi
+*             blize od OBST_STOP_MM (Host/obstacle_sim.c, kolona u voznji).
+*             Ogranicenje se smanjuje odmah, a povecava za OBST_RAMP_UP po
+*             pozivu, pa se posle prepreke ubrzava postepeno. Zaustavljanje
+*             se drzi dok prepreka ne ode OBST_RELEASE_MM - OBST_STOP_MM
+*             dalje od praga.
+*             Kada je poznata brzina priblizavanja iz range_rate.c, TTC se
+*             racuna iz nje, pa protivnik koji prilazi daje raniji TTC. Dok je
+*             procena brzine ispravna (isti objekat u snopu), prati se i
+*             polozaj objekta, predjeni put plus udaljenost. Kada misija
+*             oznaci cilj pokreta kao zid ili kucicu (ObstacleZoneWall),
+*             objekat koji se nije pomerio vise od OBST_MOVED_MM, a nalazi se
+*             na cilju kome se prilazi polako, je taj zid: TTC tada ne
+*             zaustavlja niti usporava, usporava se samo po udaljenosti. Bez
+*             oznake misije to vazi za protivnika parkiranog na cilju, pa se
+*             prilaz ne pogadja iz geometrije. Ispod praga se staje uvek, i
+*             pri prilazu zidu; poslednji deo puta do zida misija
+*             vozi sa ugasenim senzorima. Polozaj se ne procenjuje iz
+*             razlike brzina jer procena kasni dok robot usporava.
+*             Ne zavisi od hardvera, prevodi se i u Host/obstacle_sim.c i
+*             Host/ttc_bench.c.
+*/
+
+#ifndef __OBSTACLE_ZONE_H__
+#define __OBSTACLE_ZONE_H__
+
+#include <stdint.h>
+
+#define OBST_STOP_MM       150     // Najmanje rastojanje na koje robot sam prilazi.
+#define OBST_RELEASE_MM    220     // Izlazak iz zaustavljanja, u odnosu na OBST_STOP_MM.
+#define OBST_REACTION_MS   60      // Perioda senzora, zadatak i kocenje.
+#define OBST_NOISE_MM      30      // Sum senzora (3 sigma).
+#define OBST_SLOW_MM       600     // Pocetak zone usporavanja.
+#define OBST_TTC_STOP_MS   250
+#define OBST_TTC_SLOW_MS   1500    // Iznad ovoga TTC ne ogranicava brzinu.
+#define OBST_MIN_SPEED     6       // Najmanje ogranicenje van unutrasnje zone.
+#define OBST_RAMP_UP       1       // Povecanje ogranicenja po pozivu (10 ms).
+#define OBST_NO_TTC        0xFFFF  // Robot stoji ili nema prepreke.
+#define OBST_NO_RATE       INT16_MIN  // Brzina priblizavanja nije poznata, kao RR_NO_RATE.
+#define OBST_MOVED_MM      100     // Pomeraj objekta od kada je vidjen koji nije sum.
+#define OBST_DOCK_MM_S     200     // Najveca sopstvena brzina pri prilazu zidu.
+#define OBST_DOCK_BEYOND_MM 80     // Zid je najvise ovoliko iza cilja,
+#define OBST_DOCK_SHORT_MM 30      // i najvise ovoliko ispred cilja (gura se).
+
+typedef struct
+{
+  uint8_t nominal;                 // Ogranicenje bez prepreke.
+  uint8_t limit;                   // Trenutno ogranicenje.
+  uint8_t hold;                    // 1 dok je prepreka u unutrasnjoj zoni.
+  uint16_t ttc_ms;                 // Poslednje vreme do sudara.
+  uint16_t holds;                  // Broj zaustavljanja.
+  uint8_t wall;                    // 1 ako je misija oznacila cilj kao zid ili kucicu.
+  uint8_t docking;                 // 1 pri prilazu nepokretnom objektu na cilju.
+  uint8_t moved;                   // 1 ako se prepreka pomerila od kada je vidjena.
+  int32_t travel;                  // Predjeni put, 0.01 mm.
+  int32_t object_min, object_max;  // Polozaj prepreke od kada je vidjena, mm.
+} ObstacleZoneType;
+
+/* Pocetno stanje, ogranicenje je nominal. */
+void ObstacleZoneInit( ObstacleZoneType *z, uint8_t nominal );
+/* Cilj sledeceg pokreta je zid ili kucica (wall = 1) ili nije (0). */
+void ObstacleZoneWall( ObstacleZoneType *z, uint8_t wall );
+/* Nova udaljenost najblize prepreke u smeru kretanja, sopstvena brzina i
+   brzina priblizavanja prepreke u mm/s (OBST_NO_RATE ako nije poznata) i
+   preostali put do cilja. Vraca ogranicenje brzine, 0 kada treba stajati. */
+uint8_t ObstacleZoneUpdate( ObstacleZoneType *z, uint16_t distance_mm, uint16_t speed_mm_s,
+                            int16_t closing_mm_s, uint16_t remaining_mm );
+
+#endif
@@ -0,0 +1,215 @@
+/**
+*   @file:    occupancy_grid.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Mreza zauzetosti stola, videti occupancy_grid.h.
+*/
+
+#include "occupancy_grid.h"
+
+#define OG_OFFSET_MM  3000          // Da deljenje sa OG_CELL_MM zaokruzuje nadole i van stola.
+
+OgType og_grid;
+
+/* Provera budzeta memorije pri prevodjenju. */
+typedef char OgRamBudgetCheck[ ( sizeof( OgType ) <= OG_RAM_BUDGET ) ? 1 : -1 ];
+
+/*----------------------------------------------------------------------------*/
+void OgInit( void )
+{
+  uint16_t i;
+
+  for ( i = 0; i < OG_CELLS / 2; i++ )
+    og_grid.cells[ i ] = OG_PRIOR | ( OG_PRIOR << 4 );
+  for ( i = 0; i < OG_RAYS; i++ )
+    og_grid.ray[ i ].active = 0;
+  og_grid.x_mm = 0;
+  og_grid.y_mm = 0;
+  og_grid.sin_q14 = 0;
+  og_grid.cos_q14 = OG_Q14;
+  og_grid.decay_next = 0;
+  og_grid.ray_next = 0;
+}
+/*----------------------------------------------------------------------------*/
+void OgSetPose( int16_t x_mm, int16_t y_mm, int16_t sin_q14, int16_t cos_q14 )
+{
+  og_grid.x_mm = x_mm;
+  og_grid.y_mm = y_mm;
+  og_grid.sin_q14 = sin_q14;
+  og_grid.cos_q14 = cos_q14;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t OgCell( int16_t cx, int16_t cy )
+{
+  uint16_t i;
+
+  if ( cx < 0 || cx >= OG_COLS || cy < 0 || cy >= OG_ROWS ) return OG_PRIOR;
+  i = (uint16_t)cy * OG_COLS + cx;
+  return ( i & 1 ) ? ( og_grid.cells[ i >> 1 ] >> 4 ) : ( og_grid.cells[ i >> 1 ] & 0x0F );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Menja log-odds celije za delta, u granicama 0..OG_MAX.
+  * @param  cx, cy predstavljaju celiju, van stola se ne upisuje.
+  * @param  delta predstavlja promenu.
+  * @retval None
+  */
+static void OgCellAdd( int16_t cx, int16_t cy, int8_t delta )
+{
+  uint16_t i;
+  int8_t v;
+
+  if ( cx < 0 || cx >= OG_COLS || cy < 0 || cy >= OG_ROWS ) return;
+  i = (uint16_t)cy * OG_COLS + cx;
+  v = (int8_t)( ( i & 1 ) ? ( og_grid.cells[ i >> 1 ] >> 4 ) : ( og_grid.cells[ i >> 1 ] & 0x0F ) );
+  v += delta;
+  if ( v < 0 ) v = 0;
+  if ( v > OG_MAX ) v = OG_MAX;
+  if ( i & 1 ) og_grid.cells[ i >> 1 ] = ( og_grid.cells[ i >> 1 ] & 0x0F ) | ( (uint8_t)v << 4 );
+  else og_grid.cells[ i >> 1 ] = ( og_grid.cells[ i >> 1 ] & 0xF0 ) | (uint8_t)v;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Tacka na robotu u koordinatama stola.
+  * @param  forward_mm predstavlja pomeraj napred.
+  * @param  side_mm predstavlja pomeraj desno.
+  * @param  x, y predstavljaju rezultat u mm.
+  * @retval None
+  */
+static void OgRobotToTable( int32_t forward_mm, int32_t side_mm, int32_t *x, int32_t *y )
+{
+  *x = og_grid.x_mm + ( forward_mm * og_grid.sin_q14 + side_mm * og_grid.cos_q14 ) / OG_Q14;
+  *y = og_grid.y_mm + ( forward_mm * og_grid.cos_q14 - side_mm * og_grid.sin_q14 ) / OG_Q14;
+}
+/*----------------------------------------------------------------------------*/
+static int8_t OgCellOf( int32_t mm )
+{
+  return (int8_t)( ( mm + OG_OFFSET_MM ) / OG_CELL_MM - OG_OFFSET_MM / OG_CELL_MM );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Novo merenje senzora. Celija prepreke se upisuje odmah, a slobodne
+  *         celije do nje postepeno iz OgStep().
+  * @param  slot predstavlja zrak senzora, 0..OG_RAYS-1.
+  * @param  mount predstavlja polozaj senzora na robotu.
+  * @param  range_mm predstavlja izmereno rastojanje.
+  * @param  hit je 1 ako je na range_mm prepreka.
+  * @retval None
+  */
+void OgAddReading( uint8_t slot, const OgMountType *mount, uint16_t range_mm, uint8_t hit )
+{
+  OgRayType *r;
+  int32_t sx, sy, ex, ey, dx, dy;
+
+  if ( slot >= OG_RAYS ) return;
+  r = &og_grid.ray[ slot ];
+  if ( range_mm > OG_MAX_RANGE_MM )
+  {
+    range_mm = OG_MAX_RANGE_MM;
+    hit = 0;
+  }
+
+  OgRobotToTable( mount->forward_mm, mount->side_mm, &sx, &sy );
+  OgRobotToTable( mount->forward_mm + mount->facing * (int32_t)range_mm, mount->side_mm, &ex, &ey );
+
+  r->x = OgCellOf( sx );
+  r->y = OgCellOf( sy );
+  r->x_end = OgCellOf( ex );
+  r->y_end = OgCellOf( ey );
+  if ( hit ) OgCellAdd( r->x_end, r->y_end, OG_HIT );
+
+  dx = r->x_end - r->x;
+  dy = r->y_end - r->y;
+  r->step_x = ( dx < 0 ) ? -1 : 1;
+  r->step_y = ( dy < 0 ) ? -1 : 1;
+  r->dx = (int8_t)( ( dx < 0 ) ? -dx : dx );
+  r->dy = (int8_t)( ( dy < 0 ) ? dy : -dy );
+  r->err = r->dx + r->dy;
+  r->active = ( dx != 0 || dy != 0 );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Nastavlja zrake (Bresenham, najvise OG_STEPS_PER_CALL celija) i
+  *         vraca OG_DECAY_PER_CALL celija za korak ka OG_PRIOR.
+  * @param  None
+  * @retval None
+  */
+void OgStep( void )
+{
+  uint8_t steps = 0, idle = 0;
+  uint8_t i, v;
+  int16_t e2;
+
+  while ( steps < OG_STEPS_PER_CALL && idle < OG_RAYS )
+  {
+    OgRayType *r = &og_grid.ray[ og_grid.ray_next ];
+
+    if ( !r->active )
+    {
+      og_grid.ray_next = ( og_grid.ray_next + 1 ) % OG_RAYS;
+      idle++;
+      continue;
+    }
+    idle = 0;
+    OgCellAdd( r->x, r->y, -OG_MISS );
+    steps++;
+    e2 = 2 * r->err;
+    if ( e2 >= r->dy )
+    {
+      r->err += r->dy;
+      r->x += r->step_x;
+    }
+    if ( e2 <= r->dx )
+    {
+      r->err += r->dx;
+      r->y += r->step_y;
+    }
+    if ( r->x == r->x_end && r->y == r->y_end )
+    {
+      r->active = 0;
+      og_grid.ray_next = ( og_grid.ray_next + 1 ) % OG_RAYS;
+    }
+  }
+
+  for ( i = 0; i < OG_DECAY_PER_CALL; i++ )
+  {
+    int16_t cx = og_grid.decay_next % OG_COLS, cy = og_grid.decay_next / OG_COLS;
+
+    v = OgCell( cx, cy );
+    if ( v > OG_PRIOR ) OgCellAdd( cx, cy, -1 );
+    else if ( v < OG_PRIOR ) OgCellAdd( cx, cy, 1 );
+    if ( ++og_grid.decay_next >= OG_CELLS ) og_grid.decay_next = 0;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Slobodan put u hodniku ispred ili iza robota. Hodnik se proverava
+  *         u tackama na pola celije, pa ni jedna celija ne moze da se preskoci.
+  *         Tacka van stola je ivica stola i zatvara hodnik.
+  * @param  facing predstavlja smer, 1 napred, -1 nazad.
+  * @param  length_mm predstavlja duzinu hodnika.
+  * @param  width_mm predstavlja sirinu hodnika.
+  * @retval Rastojanje do prve zauzete celije, length_mm ako je hodnik slobodan.
+  */
+uint16_t OgCorridorFree( int8_t facing, uint16_t length_mm, uint16_t width_mm )
+{
+  int32_t d, s, x, y, half = width_mm / 2;
+  int16_t cx, cy;
+
+  for ( d = 0; d <= length_mm; d += OG_CELL_MM / 2 )
+  {
+    for ( s = -half; ; s += OG_CELL_MM / 2 )
+    {
+      if ( s > half ) s = half;
+      OgRobotToTable( facing * d, s, &x, &y );
+      cx = OgCellOf( x );
+      cy = OgCellOf( y );
+      if ( cx < 0 || cx >= OG_COLS || cy < 0 || cy >= OG_ROWS ) return (uint16_t)d;
+      if ( OgCell( cx, cy ) >= OG_OCCUPIED ) return (uint16_t)d;
+      if ( s == half ) break;
+    }
+  }
+  return length_mm;
+}
+/*----------------------------------------------------------------------------*/
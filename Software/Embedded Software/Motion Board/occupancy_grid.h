@@ -0,0 +1,99 @@
+/**
+*   @file:    occupancy_grid.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Mreza zauzetosti stola 3 x 2 m sa celijama od 100 mm. Svaka
+*             celija je 4-bitni log-odds (0 slobodno .. 15 zauzeto,
+*             OG_PRIOR nepoznato), dve celije u bajtu, pa je cela mreza
+*             300 B. Sva memorija je u og_grid, a OG_RAM_BUDGET se proverava
+*             pri prevodjenju.
+*
+*             Merenje senzora se preko poze robota (abs_X, abs_Y, abs_Theta
+*             iz calculatePosition()) pretvara u zrak: krajnja celija se
+*             odmah povecava za OG_HIT, a celije izmedju senzora i prepreke
+*             se smanjuju za OG_MISS postepeno, najvise OG_STEPS_PER_CALL po
+*             pozivu OgStep(). Novo merenje istog senzora zamenjuje zrak koji
+*             jos nije zavrsen. OgStep() vraca i OG_DECAY_PER_CALL celija za
+*             jedan korak ka OG_PRIOR, pa prepreka koja ode nestaje iz mreze.
+*             Vreme po pozivu je ograniceno bez obzira na broj merenja.
+*
+*             Koordinate su kao u calculatePosition(): ugao 0 gleda u +Y, a
+*             pravac napred je ( sin, cos ). Pocetak je ugao stola, a startnu
+*             pozu zadaje glavna ploca komandom SET_POSITION pre starta meca.
+*             Ne zavisi od hardvera.
+*/
+
+#ifndef __OCCUPANCY_GRID_H__
+#define __OCCUPANCY_GRID_H__
+
+#include <stdint.h>
+
+#define OG_CELL_MM         100
+#define OG_COLS            30       // X, 3000 mm.
+#define OG_ROWS            20       // Y, 2000 mm.
+#define OG_CELLS           ( OG_COLS * OG_ROWS )
+#define OG_RAM_BUDGET      384      // Bajtova za og_grid.
+
+/* Log-odds celije. */
+#define OG_PRIOR           4        // Nepoznato.
+#define OG_OCCUPIED        9        // Od ove vrednosti celija je zauzeta.
+#define OG_MAX             15
+#define OG_HIT             4
+#define OG_MISS            1
+
+#define OG_MAX_RANGE_MM    1500     // Dalje merenje upisuje samo slobodan prostor do ove granice.
+#define OG_RAYS            4        // Zraci u toku, jedan po senzoru.
+#define OG_STEPS_PER_CALL  12       // Celija zraka po OgStep().
+#define OG_DECAY_PER_CALL  6        // Celija po OgStep(), cela mreza za 100 poziva (1 s).
+
+#define OG_Q14             16384    // sin i cos u Q14.
+
+/* Polozaj senzora na robotu. */
+typedef struct
+{
+  int16_t forward_mm;               // Ispred centra robota, negativno iza.
+  int16_t side_mm;                  // Desno od centra, negativno levo.
+  int8_t facing;                    // 1 gleda napred, -1 nazad.
+} OgMountType;
+
+/* Zrak koji se upisuje postepeno, u celijama. */
+typedef struct
+{
+  int8_t x, y;                      // Sledeca slobodna celija.
+  int8_t x_end, y_end;              // Celija prepreke ili kraj zraka (ne upisuje se).
+  int8_t step_x, step_y;
+  int8_t dx, dy;                    // |x_end - x|, -|y_end - y| na pocetku.
+  int16_t err;
+  uint8_t active;
+} OgRayType;
+
+typedef struct
+{
+  uint8_t cells[ OG_CELLS / 2 ];
+  OgRayType ray[ OG_RAYS ];
+  int16_t x_mm, y_mm;               // Poza robota.
+  int16_t sin_q14, cos_q14;
+  uint16_t decay_next;
+  uint8_t ray_next;
+} OgType;
+
+extern OgType og_grid;
+
+/* Sve celije na OG_PRIOR, bez zraka. */
+void OgInit( void );
+/* Poza robota u mm i pravac napred ( sin, cos ) u Q14. */
+void OgSetPose( int16_t x_mm, int16_t y_mm, int16_t sin_q14, int16_t cos_q14 );
+/* Novo merenje senzora (slot 0..OG_RAYS-1). hit je 0 kada nema odjeka,
+   tada je range_mm samo granica slobodnog prostora. */
+void OgAddReading( uint8_t slot, const OgMountType *mount, uint16_t range_mm, uint8_t hit );
+/* Nastavlja zrake i starenje celija, poziva se svakih 10 ms. */
+void OgStep( void );
+/* Log-odds celije, OG_PRIOR van stola. */
+uint8_t OgCell( int16_t cx, int16_t cy );
+/* Slobodan put ispred (facing 1) ili iza (facing -1) robota, u hodniku
+   sirine width_mm. Vraca rastojanje do prve zauzete celije ili ivice
+   stola, najvise length_mm. */
+uint16_t OgCorridorFree( int8_t facing, uint16_t length_mm, uint16_t width_mm );
+
+#endif
@@ -1,6 +1,7 @@
 #include "variables.h"
 #include "functions.h"
 #include "stm32f10x.h"
+#include "isr_profiler.h"
 
 
 void PositionControllerInit(void){
@@ -61,13 +62,16 @@ void PositionControllerInit(void){
 
 void TIM2_IRQHandler(void)
 {
+  ISR_PROFILE_ENTER();
   greska_pracenja_X=abs(zadata_pozicija_X-ENC1);
   position_controler_X();  
   TIM_ClearFlag(TIM2, TIM_FLAG_Update); 
+  ISR_PROFILE_EXIT( ISR_ID_TIM2 );
 }
 
 void TIM7_IRQHandler(void)
 {  
+  ISR_PROFILE_ENTER();
   greska_pracenja_Y=abs(zadata_pozicija_Y-ENC2);
   if (greska_pracenja_Y>(greska_pracenja_X+10)) {
     speed_correction_Y=-1;
@@ -79,6 +83,7 @@ void TIM7_IRQHandler(void)
   speed_correction_Y=0;
   position_controler_Y();
   TIM_ClearFlag(TIM7, TIM_FLAG_Update); 
+  ISR_PROFILE_EXIT( ISR_ID_TIM7 );
 }
 
 //pracenje
@@ -115,6 +120,11 @@ switch(task_pid_X.status){
                           motion_type_X=1;
 		};break; 
 		case 2: {	
+		   if (motion_hold) {//prepreka u zoni zaustavljanja, posle nje se krece iz pocetka tabele ubrzanja
+		     task_pid_X.state=1;
+		     TIM2->ARR=1;
+		     break;
+		   }
 		   if (zadata_pozicija_X>trenutna_pozicija_X) {
  			    temp1=zadata_pozicija_X-trenutna_pozicija_X;
 				//command_servoX_forward;
@@ -206,6 +216,11 @@ switch(task_pid_Y.status){
                           motion_type_Y=1;
 		};break; 
 		case 2: {	
+		   if (motion_hold) {//prepreka u zoni zaustavljanja, posle nje se krece iz pocetka tabele ubrzanja
+		     task_pid_Y.state=1;
+		     TIM7->ARR=1;
+		     break;
+		   }
 		   if (zadata_pozicija_Y>trenutna_pozicija_Y) {
  			    temp1=zadata_pozicija_Y-trenutna_pozicija_Y;
 				//command_servoX_forward;
@@ -462,38 +477,3 @@ switch(task_pid_Y.status){
     };
 }
 
-
-
-void LogerInit(void){
-  
-    NVIC_InitTypeDef NVIC_InitStructure;
-    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct;
-    
-    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
-    
-    //  Konfiguracija Timera 3 za implementaciju logera
-    //  Period = 1ms
-    TIM_TimeBaseInitStruct.TIM_Period = 100;
-    TIM_TimeBaseInitStruct.TIM_Prescaler = 600;
-    TIM_TimeBaseInitStruct.TIM_ClockDivision = 0;
-    TIM_TimeBaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInit(TIM3, &TIM_TimeBaseInitStruct);
-    TIM_ITConfig(TIM3,TIM_IT_Update, ENABLE);
-    TIM_Cmd(TIM3, ENABLE);  //Startovanje TIMER4 periferije
-    
-    //DOZVOLA GENERISANJA PREKIDA
-    //Dozvola generisanja prekida od strane TIM4 periferije
-    NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 2;
-    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-    //Inicijalizacija NVIC periferije
-    NVIC_Init(&NVIC_InitStructure);   
-}
-
-
-void TIM3_IRQHandler(void)
-{
-  //funkcija za logovanje
-  TIM_ClearFlag(TIM3, TIM_FLAG_Update); 
-}
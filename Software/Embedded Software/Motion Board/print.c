@@ -1,4 +1,7 @@
+#include <stdarg.h>
+
 #include "UartDebug.h"
+#include "print.h"
 
 
 //static int *UART_DATA 	= (int *) (UART_BASE + UART_DR_OFFSET);
@@ -12,12 +15,20 @@ void putc(char c)
 		UsartPut('\r');
 }
 
-static void printchar(char **str, int c)
+/* Odrediste ispisa: bafer [p, end) ili UART ako je p == 0. Bafer bez
+   granice ima end == 0. */
+typedef struct
+{
+	char *p;
+	char *end;
+} PrintTarget;
+
+static void printchar(PrintTarget *out, int c)
 {	
-	if (str) 
+	if (out->p) 
 	{
-		**str = c;
-		++(*str);
+		if (!out->end || out->p < out->end)
+			*out->p++ = c;
 	}
 	else 
 		putc(c);
@@ -26,7 +37,7 @@ static void printchar(char **str, int c)
 #define PAD_RIGHT 1
 #define PAD_ZERO 2
 
-static int prints(char **out, const char *string, int width, int pad)
+static int prints(PrintTarget *out, const char *string, int width, int pad)
 {
 	register int pc = 0, padchar = ' ';
 
@@ -64,38 +75,43 @@ static int prints(char **out, const char *string, int width, int pad)
 // the following should be enough for 32 bit int
 #define PRINT_BUF_LEN 12
 
-static int mod(int a, int b)
+/* u / 10 bez deljenja: 0xCCCCCCCD / 2^35 je 1/10 zaokruzeno navise, greska
+   je dovoljno mala da je rezultat tacan za ceo 32-bitni opseg (jedan UMULL). */
+static unsigned int div10(unsigned int u)
 {
-	while (a >= b)
-		a = a - b;
-	return a;
+	return (unsigned int)(((unsigned long long)u * 0xCCCCCCCDu) >> 35);
 }
 
-/*static*/ int div(int a, int b)
+/* Upisuje cifre unazad, pocevsi od s, i vraca pokazivac na prvu cifru. */
+static char *format_dec(unsigned int u, char *s)
 {
-	unsigned int result = 0;
-	while (a >= b)
+	do 
 	{
-		a = a - b;
-		result++;
-	}
-	return result;
+		register unsigned int q = div10(u);
+		*--s = '0' + (u - q * 10);
+		u = q;
+	} while (u);
+	return s;
+}
+
+static char *format_hex(unsigned int u, char *s, int letbase)
+{
+	do 
+	{
+		register int t = u & 0x0F;
+		*--s = t < 10 ? t + '0' : t - 10 + letbase;
+		u >>= 4;
+	} while (u);
+	return s;
 }
 
-static int printi(char **out, int i, int b, int sg, int width, int pad, int letbase)
+static int printi(PrintTarget *out, int i, int b, int sg, int width, int pad, int letbase)
 {
 	char print_buf[PRINT_BUF_LEN];
 	register char *s;
-	register int t, neg = 0, pc = 0;
+	register int neg = 0, pc = 0;
 	register unsigned int u = i;
 
-	if (i == 0) 
-	{
-		print_buf[0] = '0';
-		print_buf[1] = '\0';
-		return prints (out, print_buf, width, pad);
-	}
-
 	if (sg && b == 10 && i < 0) 
 	{
 		neg = 1;
@@ -104,15 +120,7 @@ static int printi(char **out, int i, int b, int sg, int width, int pad, int letb
 
 	s = print_buf + PRINT_BUF_LEN-1;
 	*s = '\0';
-
-	while (u) 
-	{
-		t = u % b;  // t = mod(u, b); 		// t = u % b;
-		if( t >= 10 )
-			t += letbase - '0' - 10;
-		*--s = t + '0';
-		u /= b;     // u = div(u, b);		// u /= b;
-	}
+	s = (b == 16) ? format_hex(u, s, letbase) : format_dec(u, s);
 
 	if (neg) 
 	{
@@ -131,11 +139,10 @@ static int printi(char **out, int i, int b, int sg, int width, int pad, int letb
 	return pc + prints (out, s, width, pad);
 }
 
-static int print(char **out, int *varg)
+static int print(PrintTarget *out, const char *format, va_list args)
 {
 	register int width, pad;
 	register int pc = 0;
-	register char *format = (char *)(*varg++);
 	char scr[2];
 
 	for (; *format != 0; ++format) 
@@ -163,34 +170,34 @@ static int print(char **out, int *varg)
 			}
 			if( *format == 's' ) 
 			{
-				register char *s = *((char **)varg++);
+				register char *s = va_arg(args, char *);
 				pc += prints (out, s?s:"(null)", width, pad);
 				continue;
 			}
 			if( *format == 'd' ) 
 			{
-				pc += printi (out, *varg++, 10, 1, width, pad, 'a');
+				pc += printi (out, va_arg(args, int), 10, 1, width, pad, 'a');
 				continue;
 			}
 			if( *format == 'x' ) 
 			{
-				pc += printi (out, *varg++, 16, 0, width, pad, 'a');
+				pc += printi (out, va_arg(args, int), 16, 0, width, pad, 'a');
 				continue;
 			}
 			if( *format == 'X' ) 
 			{
-				pc += printi (out, *varg++, 16, 0, width, pad, 'A');
+				pc += printi (out, va_arg(args, int), 16, 0, width, pad, 'A');
 				continue;
 			}
 			if( *format == 'u' ) 
 			{
-				pc += printi (out, *varg++, 10, 0, width, pad, 'a');
+				pc += printi (out, va_arg(args, int), 10, 0, width, pad, 'a');
 				continue;
 			}
 			if( *format == 'c' ) 
 			{
 				// char are converted to int then pushed on the stack 
-				scr[0] = *varg++;
+				scr[0] = va_arg(args, int);
 				scr[1] = '\0';
 				pc += prints (out, scr, width, pad);
 				continue;
@@ -203,23 +210,43 @@ static int print(char **out, int *varg)
 			++pc;
 		}
 	}
-	if (out) 
-		**out = '\0';
+	if (out->p) 
+		*out->p = '\0';
 	return pc;
 }
 
-// assuming sizeof(void *) == sizeof(int) 
-
 int printf(const char *format, ...)
 {
-	register int *varg = (int *)(&format);
-	return print(0, varg);
+	PrintTarget out = { 0, 0 };
+	va_list args;
+	int pc;
+
+	va_start(args, format);
+	pc = print(&out, format, args);
+	va_end(args);
+	return pc;
 }
 
-int sprintf(char *out, const char *format, ...)
+int sprintf(char *buf, const char *format, ...)
 {
-	register int *varg = (int *)(&format);
-	return print(&out, varg);
+	PrintTarget out = { buf, 0 };
+	va_list args;
+	int pc;
+
+	va_start(args, format);
+	pc = print(&out, format, args);
+	va_end(args);
+	return pc;
+}
+
+// Upisuje najvise size-1 znakova i uvek zavrsava string nulom.
+int vsnprint(char *buf, unsigned size, const char *format, va_list args)
+{
+	PrintTarget out = { buf, buf + size - 1 };
+
+	if (size == 0)
+		return 0;
+	return print(&out, format, args);
 }
 
 char getc()
@@ -242,176 +269,70 @@ char getc()
 
 char* itoa(unsigned int i, char* arr)           // integer to array of characters
 {
-    int temp = i;
-    int num = 0;    
-    if(i == 0)
-    {   
-        arr[0] = '0';
-        arr[1] = '\0';
-        return arr;
-    }
-    while(temp != 0)
-    {
-        temp = temp / 10;
-        num++;
-    }
-    arr[num] = '\0';
-    while(num--)
-    {
-        arr[num] = '0' + i % 10;
-        i = i / 10;
-    }
-    return arr;    
+	char print_buf[PRINT_BUF_LEN];
+	register char *s = format_dec(i, print_buf + PRINT_BUF_LEN - 1);
+	register char *d = arr;
+
+	while (s < print_buf + PRINT_BUF_LEN - 1)
+		*d++ = *s++;
+	*d = '\0';
+	return arr;
 }
 
+/*
+ * ftoa - float u string sa decimals decimala (0..4), zaokruzeno na najblize.
+ * Vrednost se jednom pomnozi sa 10^decimals i dalje se radi samo sa celim
+ * brojem, pa nema deljenja u pokretnom zarezu ni %f iz biblioteke. Float ima
+ * 24 bita mantise, pa su za |Value| > 2^24 / 10^decimals poslednje cifre
+ * netacne. Ako proizvod ne staje u 32 bita upisuje se "inf". Buffer mora
+ * imati mesta za najmanje 16 znakova.
+ */
+char* ftoa(float Value, char* Buffer, int decimals)
+{
+	static const unsigned int scale[] = { 1, 10, 100, 1000, 10000 };
+	char print_buf[16];
+	register char *s = print_buf + sizeof(print_buf) - 1;
+	register char *d = Buffer;
+	register unsigned int fixed, q;
+	int neg = 0, n;
 
-/**************************************************
- *
- *  ** ADDED BY VLADIMIR, copied from internet **
- *
- *    ftoa - converts float to string  
- *
- ***************************************************
- *
- *    This is a simple implemetation with rigid
- *    parameters:
- *            - Buffer must be 8 chars long
- *            - 3 digits precision max
- *            - absolute range is -524,287 to 524,287 
- *            - resolution (epsilon) is 0.125 and
- *              always rounds down
- **************************************************/
- /*void ftoa(float Value, char* Buffer)
- {
-
-    sprintf(Buffer, "%f", Value);
- /*    union
-     {
-         float f;
-     
-         struct
-         {
-             unsigned int    mantissa_lo : 16;
-             unsigned int    mantissa_hi : 7;    
-             unsigned int     exponent : 8;
-             unsigned int     sign : 1;
-         };
-     } helper;
-     
-     unsigned long mantissa;
-     signed char exponent;
-     unsigned int int_part;
-     char frac_part[3];
-     int i, count = 0;
-     
-     helper.f = Value;
-     //mantissa is LS 23 bits
-     mantissa = helper.mantissa_lo;
-     mantissa += ((unsigned long) helper.mantissa_hi << 16);
-     //add the 24th bit to get 1.mmmm^eeee format
-     mantissa += 0x00800000;
-     //exponent is biased by 127
-     exponent = (signed char) helper.exponent - 127;
-     
-     //too big to shove into 8 chars
-     if (exponent > 18)
-     {
-         Buffer[0] = 'I';
-         Buffer[1] = 'n';
-         Buffer[2] = 'f';
-         Buffer[3] = '\0';
-         return;
-     }
-     
-     //too small to resolve (resolution of 1/8)
-     if (exponent < -3)
-     {
-         Buffer[0] = '0';
-         Buffer[1] = '\0';
-         return;
-     }
-     
-     count = 0;
-     
-     //add negative sign (if applicable)
-     if (helper.sign)
-     {
-         Buffer[0] = '-';
-         count++;
-     }
-     
-     //get the integer part
-     int_part = mantissa >> (23 - exponent);    
-     //convert to string
-     itoa(int_part, &Buffer[count]);
-     
-     //find the end of the integer
-     for (i = 0; i < 8; i++)
-         if (Buffer[i] == '\0')
-         {
-             count = i;
-             break;
-         }        
- 
-     //not enough room in the buffer for the frac part    
-     if (count > 5)
-         return;
-     
-     //add the decimal point    
-     Buffer[count++] = '.';
-     
-     //use switch to resolve the fractional part
-     switch (0x7 & (mantissa  >> (20 - exponent)))
-     {
-         case 0:
-             frac_part[0] = '0';
-             frac_part[1] = '0';
-             frac_part[2] = '0';
-             break;
-         case 1:
-             frac_part[0] = '1';
-             frac_part[1] = '2';
-             frac_part[2] = '5';            
-             break;
-         case 2:
-             frac_part[0] = '2';
-             frac_part[1] = '5';
-             frac_part[2] = '0';            
-             break;
-         case 3:
-             frac_part[0] = '3';
-             frac_part[1] = '7';
-             frac_part[2] = '5';            
-             break;
-         case 4:
-             frac_part[0] = '5';
-             frac_part[1] = '0';
-             frac_part[2] = '0';            
-             break;
-         case 5:
-             frac_part[0] = '6';
-             frac_part[1] = '2';
-             frac_part[2] = '5';            
-             break;
-         case 6:
-             frac_part[0] = '7';
-             frac_part[1] = '5';
-             frac_part[2] = '0';            
-             break;
-         case 7:
-             frac_part[0] = '8';
-             frac_part[1] = '7';
-             frac_part[2] = '5';                    
-             break;
-     }
-     
-     //add the fractional part to the output string
-     for (i = 0; i < 3; i++)
-         if (count < 7)
-             Buffer[count++] = frac_part[i];
-     
-     //make sure the output is terminated
-     Buffer[count] = '\0';*//*
- }
-
-*/
+	if (Value != Value)
+	{
+		Buffer[0] = 'n'; Buffer[1] = 'a'; Buffer[2] = 'n'; Buffer[3] = '\0';
+		return Buffer;
+	}
+	if (Value < 0)
+	{
+		neg = 1;
+		Value = -Value;
+	}
+	if (decimals < 0) decimals = 0;
+	if (decimals > 4) decimals = 4;
+	Value *= scale[decimals];
+	if (Value >= 4294967296.0f)
+	{
+		if (neg) *d++ = '-';
+		d[0] = 'i'; d[1] = 'n'; d[2] = 'f'; d[3] = '\0';
+		return Buffer;
+	}
+	fixed = (unsigned int)(Value + 0.5f);
+	// Bez "-0.00" kada se mala negativna vrednost zaokruzi na nulu.
+	if (neg && fixed)
+		*d++ = '-';
+
+	*s = '\0';
+	for (n = 0; n < decimals; n++)
+	{
+		q = div10(fixed);
+		*--s = '0' + (fixed - q * 10);
+		fixed = q;
+	}
+	if (decimals)
+		*--s = '.';
+	s = format_dec(fixed, s);
+
+	while (*s)
+		*d++ = *s++;
+	*d = '\0';
+	return Buffer;
+}
@@ -1,11 +1,15 @@
 #ifndef _PRINT_H_
 #define _PRINT_H_
 
+#include <stdarg.h>
+
 extern int printf(const char *format, ...);
+extern int sprintf(char *out, const char *format, ...);
+extern int vsnprint(char *buf, unsigned size, const char *format, va_list args);
 extern char getc();
 extern void putc(char c);
 extern char* itoa(unsigned int i, char* a);
 
- //void ftoa(float Value, char* Buffer); //added by Vladimir
+extern char* ftoa(float Value, char* Buffer, int decimals);
 
 #endif /* _PRINT_H_ */
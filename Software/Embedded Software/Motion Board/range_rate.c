@@ -0,0 +1,109 @@
+/**
+*   @file:    range_rate.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Alpha-beta procena brzine priblizavanja, videti range_rate.h.
+*/
+
+#include "range_rate.h"
+
+/*----------------------------------------------------------------------------*/
+void RangeRateReset( RangeRateType *r )
+{
+  r->range_q4 = 0;
+  r->rate_q4 = 0;
+  r->samples = 0;
+  r->gated = 0;
+}
+/*----------------------------------------------------------------------------*/
+/* Ogranicava brzinu na RR_MAX_RATE_MM_S, da predikcija ne prekoraci opseg. */
+static void RangeRateClamp( RangeRateType *r )
+{
+  if ( r->rate_q4 > ( RR_MAX_RATE_MM_S << 4 ) ) r->rate_q4 = RR_MAX_RATE_MM_S << 4;
+  if ( r->rate_q4 < -( RR_MAX_RATE_MM_S << 4 ) ) r->rate_q4 = -( RR_MAX_RATE_MM_S << 4 );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Dodaje merenje rastojanja.
+  * @param  r predstavlja procenu.
+  * @param  distance_mm predstavlja filtrirano rastojanje.
+  * @param  dt_100us predstavlja vreme od prethodnog merenja, u 100 us.
+  * @retval Nema povratnih vrednosti.
+  */
+void RangeRateUpdate( RangeRateType *r, uint16_t distance_mm, uint16_t dt_100us )
+{
+  int32_t z = (int32_t)distance_mm << 4;
+  int32_t predicted, residual;
+
+  if ( dt_100us < RR_MIN_DT ) dt_100us = RR_MIN_DT;
+  if ( dt_100us > RR_MAX_DT ) dt_100us = RR_MAX_DT;
+
+  if ( r->samples == 0 )
+  {
+    r->range_q4 = z;
+    r->rate_q4 = 0;
+    r->samples = 1;
+    return;
+  }
+  if ( r->samples == 1 )
+  {
+    r->rate_q4 = ( z - r->range_q4 ) * 10000 / dt_100us;
+    RangeRateClamp( r );
+    r->range_q4 = z;
+    r->samples = 2;
+    return;
+  }
+
+  predicted = r->range_q4 + r->rate_q4 * dt_100us / 10000;
+  residual = z - predicted;
+  if ( residual > ( RR_GATE_MM << 4 ) || residual < -( RR_GATE_MM << 4 ) )
+  {
+    /* Pojedinacni lazni odjek se preskace, a posle RR_GATE_RESET uzastopnih
+       u snopu je nov objekat. */
+    if ( ++r->gated < RR_GATE_RESET )
+    {
+      r->range_q4 = predicted;
+      return;
+    }
+    r->range_q4 = z;
+    r->rate_q4 = 0;
+    r->samples = 1;
+    r->gated = 0;
+    return;
+  }
+  r->gated = 0;
+  r->range_q4 = predicted + residual * RR_ALPHA_Q8 / 256;
+  r->rate_q4 += residual * RR_BETA_Q8 / 256 * 10000 / dt_100us;
+  RangeRateClamp( r );
+  if ( r->samples < 255 ) r->samples++;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t RangeRateRange( const RangeRateType *r )
+{
+  if ( r->samples < RR_MIN_SAMPLES ) return RR_NO_RANGE;
+  if ( r->range_q4 <= 0 ) return 0;
+  return ( r->range_q4 >> 4 ) >= RR_NO_RANGE ? RR_NO_RANGE - 1 : (uint16_t)( r->range_q4 >> 4 );
+}
+/*----------------------------------------------------------------------------*/
+int16_t RangeRateClosing( const RangeRateType *r )
+{
+  int32_t closing;
+
+  if ( r->samples < RR_MIN_SAMPLES ) return RR_NO_RATE;
+  closing = -( r->rate_q4 >> 4 );
+  if ( closing > INT16_MAX ) closing = INT16_MAX;
+  if ( closing <= RR_NO_RATE ) closing = RR_NO_RATE + 1;
+  return (int16_t)closing;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t RangeRateTtc( const RangeRateType *r )
+{
+  int16_t closing = RangeRateClosing( r );
+  uint32_t ttc;
+
+  if ( closing == RR_NO_RATE || closing < RR_MIN_CLOSING_MM_S || r->range_q4 <= 0 ) return RR_NO_TTC;
+  ttc = (uint32_t)( r->range_q4 >> 4 ) * 1000 / (uint32_t)closing;
+  return ttc >= RR_NO_TTC ? RR_NO_TTC - 1 : (uint16_t)ttc;
+}
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,57 @@
+/**
+*   @file:    range_rate.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Procena rastojanja i brzine priblizavanja (alpha-beta filtar)
+*             iz niza merenja jednog ultrazvucnog senzora i vreme do sudara.
+*             Predikcija je r + v * dt, pa se rastojanje ispravlja za
+*             RR_ALPHA, a brzina za RR_BETA greske predikcije po dt. Prva
+*             dva merenja postavljaju rastojanje i brzinu direktno. Merenje
+*             koje odstupa od predikcije vise od RR_GATE_MM se preskace, a
+*             posle RR_GATE_RESET takvih zaredom (nov objekat u snopu) procena
+*             pocinje iz pocetka. Brzina vazi tek posle RR_MIN_SAMPLES
+*             merenja. Ulaz su pojedinacna ispravna merenja, ne izlaz filtra
+*             prozora, jer bi srednja vrednost prozora dodala kasnjenje.
+*             Ne zavisi od hardvera, prevodi se i u Host/ttc_bench.c.
+*/
+
+#ifndef __RANGE_RATE_H__
+#define __RANGE_RATE_H__
+
+#include <stdint.h>
+
+#define RR_ALPHA_Q8          102      // 0.4
+#define RR_BETA_Q8           26       // 0.1
+#define RR_GATE_MM           250      // Veca greska predikcije je lazni odjek ili nov objekat.
+#define RR_GATE_RESET        3        // Uzastopnih merenja van praga za nov objekat.
+#define RR_MIN_SAMPLES       8
+#define RR_MIN_DT            50       // 5 ms, u koracima od 100 us.
+#define RR_MAX_DT            3000     // 300 ms.
+#define RR_MAX_RATE_MM_S     4000
+#define RR_MIN_CLOSING_MM_S  20       // Sporije priblizavanje nema TTC.
+#define RR_NO_RATE           INT16_MIN
+#define RR_NO_TTC            0xFFFF
+#define RR_NO_RANGE          0xFFFF
+
+typedef struct
+{
+  int32_t range_q4;                   // mm * 16.
+  int32_t rate_q4;                    // mm/s * 16, negativno pri priblizavanju.
+  uint8_t samples;                    // Merenja od pocetka procene, do 255.
+  uint8_t gated;                      // Uzastopna merenja van RR_GATE_MM.
+} RangeRateType;
+
+/* Brise procenu, na primer posle merenja bez odjeka. */
+void RangeRateReset( RangeRateType *r );
+/* Novo rastojanje, dt_100us od prethodnog merenja u koracima od 100 us. */
+void RangeRateUpdate( RangeRateType *r, uint16_t distance_mm, uint16_t dt_100us );
+/* Procenjeno rastojanje u mm, RR_NO_RANGE ako procena jos ne vazi. */
+uint16_t RangeRateRange( const RangeRateType *r );
+/* Brzina priblizavanja u mm/s (pozitivno kada se priblizava), RR_NO_RATE
+   ako procena jos ne vazi. */
+int16_t RangeRateClosing( const RangeRateType *r );
+/* Vreme do sudara u ms, RR_NO_TTC ako se objekat ne priblizava. */
+uint16_t RangeRateTtc( const RangeRateType *r );
+
+#endif
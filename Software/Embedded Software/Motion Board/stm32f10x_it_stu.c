@@ -28,9 +28,19 @@
 #include "continous_movement.h"
 
 #include "variables.h"
+#include "command_table.h"
+#include "cycle_counter.h"
+#include "trace_recorder.h"
+#include "isr_profiler.h"
+#include "debug_log.h"
+#include "voltage_comp.h"
+#include "ultrasound.h"
+#include "obstacle_zone.h"
+#include "occupancy_grid.h"
 
 
 #include <math.h>
+#include <stddef.h>
 #define PI 3.14159265
 #define CTM 1
 #define MTC 1
@@ -41,12 +51,11 @@
 #define MAX_TRANSX_LEN 200
 #define ADDR 0x0A
 #define SCALE 1
-#define MEASUREMENT_NUM 5          // Broj merenja, nakon cega se racuna srednja vrednost.
-#define ECHO_TIMER_PERIOD 50000    // Period tajmera koji meri echo.
-#define CONST_MICRO_SEC_TO_MM 5.8  // Konstanta za pretvaranje us u mm.
-#define MAX_DISTANCE_MM 300        // Rastojanje koje se detektuje kada treba da se zaustavimo. 
-#define STOP_DISTANCE 0
+#define COUNTS_PER_100MM 1205      // Impulsi trajektorije na 100 mm, LENGTH_CONST glavne ploce puta 10.
 #define PROXIMITY_CONSTANT 10   
+#define LOG_CHUNK_ENTRIES 64       // Broj podataka iz data_log-a u jednom frejmu.
+#define CORRIDOR_WIDTH_MM 300      // Sirina hodnika za CMD_CORRIDOR, sirina robota.
+#define CORRIDOR_MAX_MM   3600     // Dijagonala stola.
 
 //#define angularConstant 0.00798226//0.01538461538//0.01891769144// ovo se dobija kao 180/broj impulsa za rotaciju
 
@@ -80,8 +89,6 @@ extern int prethodna_greska_poz;
 extern int speed_ref_pos[10];
 int byte_counter = 0;
 int message_size = -1;
-int znak = 1;
-char komanda;
 int enkoder1=0;
 int enkoder2=0;
 bool pocetak_prijema = 0;
@@ -89,7 +96,7 @@ bool stigao, stigao1 = 0;
 int cnt_90 = 0;
 
 static int neki_brojac=0;
-static int sending_array[260];
+static unsigned char sending_array[260];
 static int sending_length=0;
 static int sending_iterator=0;
 
@@ -111,6 +118,8 @@ Coordinates polyline_path[50];
 int polyline_length=0;
 extern int flag_first_step_continous;
 int MAX_DIFF_SPEED=24;
+/* Pojacanja PID_continous, van funkcije da bi host (motion_host -g) mogao da ih menja. */
+float Kpc=0.03, Kic=0, Kdc=0.7, Kac=0.5;
 int MAX_SPEED=75;
 int MAX_SPEED_TOTAL=99;
 
@@ -142,62 +151,37 @@ extern volatile unsigned int Pos2;
 int zapamcena_pozicija_X = 32767;
 int zapamcena_pozicija_Y = 32767;
 
-/*TIM4CH1 - senzor nazad, levo. */
-unsigned long index_ch1 = 0;         		      // Predstavlja index poslednjeg merenja u nizu merenja.
-bool bad_measurement_end_ch1 = FALSE;                 // Jedinica signalizira da nema vise pocetnih, losih merenja.
-float distance_bl_ch1 = 0;       		      // Predstavlja izracunatu udaljenost od objekta.
-uint16_t measured_distance_bl_ch1[MEASUREMENT_NUM];   // Niz u koji se smestaju izmerene udaljenosti za MEASUREMENT_NUM impulsa.
-uint16_t measured_time_bl_rising_ch1 = 0;             // Trenutak kada se desila uzlazna ivica.
-uint16_t measured_time_bl_falling_ch1 = 0;            // Trenutak kada se desila silazna ivica.
-uint16_t measured_time_bl_ch1 = 0;                    // Vreme trajanje echo signala.
-uint8_t state_bl_ch1 = 0;    			      // 0 ako se hvata uzlazna ivica, 1 ako se hvata silazna ivica.
-  
-/*TIM4CH2 - senzor nazad, desno. */
-unsigned long index_ch2 = 0;         		      // Predstavlja index poslednjeg merenja u nizu merenja.
-bool bad_measurement_end_ch2 = FALSE;                 // Jedinica signalizira da nema vise pocetnih, losih merenja.
-float distance_br_ch2 = 0;       		      // Predstavlja izracunatu udaljenost od objekta.
-uint16_t measured_distance_br_ch2[MEASUREMENT_NUM];   // Niz u koji se smestaju izmerene udaljenosti za MEASUREMENT_NUM impulsa.
-uint16_t measured_time_br_rising_ch2 = 0;             // Trenutak kada se desila uzlazna ivica.
-uint16_t measured_time_br_falling_ch2 = 0;            // Trenutak kada se desila silazna ivica.
-uint16_t measured_time_br_ch2 = 0;                    // Vreme trajanje echo signala.
-uint8_t state_br_ch2 = 0;    			      // 0 ako se hvata uzlazna ivica, 1 ako se hvata silazna ivica.
-  
-/*TIM4CH3 - senzor napred desno. */
-unsigned long index_ch3 = 0;         		      // Predstavlja index poslednjeg merenja u nizu merenja.
-bool bad_measurement_end_ch3 = FALSE;                 // Jedinica signalizira da nema vise pocetnih, losih merenja.
-float distance_fr_ch3 = 0;       		      // Predstavlja izracunatu udaljenost od objekta.
-uint16_t measured_distance_fr_ch3[MEASUREMENT_NUM];   // Niz u koji se smestaju izmerene udaljenosti za MEASUREMENT_NUM impulsa.
-uint16_t measured_time_fr_rising_ch3 = 0;             // Trenutak kada se desila uzlazna ivica.
-uint16_t measured_time_fr_falling_ch3 = 0;            // Trenutak kada se desila silazna ivica.
-uint16_t measured_time_fr_ch3 = 0;                    // Vreme trajanje echo signala.
-uint8_t state_fr_ch3 = 0;    			      // 0 ako se hvata uzlazna ivica, 1 ako se hvata silazna ivica.
-  
-/* TIM4CH4 - senzor napred levo. */
-unsigned long index_ch4 = 0;         		      // Predstavlja index poslednjeg merenja u nizu merenja.
-bool bad_measurement_end_ch4 = FALSE;                 // Jedinica signalizira da nema vise pocetnih, losih merenja.
-float distance_fl_ch4 = 0;       		      // Predstavlja izracunatu udaljenost od objekta.
-uint16_t measured_distance_fl_ch4[MEASUREMENT_NUM];   // Niz u koji se smestaju izmerene udaljenosti za MEASUREMENT_NUM impulsa.
-uint16_t measured_time_fl_rising_ch4 = 0;             // Trenutak kada se desila uzlazna ivica.
-uint16_t measured_time_fl_falling_ch4 = 0;            // Trenutak kada se desila silazna ivica.
-uint16_t measured_time_fl_ch4 = 0;                    // Vreme trajanje echo signala.
-uint8_t state_fl_ch4 = 0;                             // 0 ako se hvata uzlazna ivica, 1 ako se hvata silazna ivica.
-
 /* Flag-ovi senzora. */
 bool FLAG_sensorEnable = FALSE;                      // Flag koji postavlja glavna ploca i definise da li gledamo senzore ili ne.
 bool FLAG_sensorFrontEnable = FALSE;                 // Flag koji se postavlja ili brise na osnovu zadate instrukcije i definise da li gledamo prednje senzore.
 bool FLAG_sensorBackEnable = FALSE;                  // Flag koji se postavlja ili brise na osnovu zadate instrukcije i definise da li gledamo zadnje senzore.
-bool FLAG_obstacleDetected = FALSE;                 // Flag koji signalizira da je prepreka detektovana. Postavlja se samo prvi put kad je odredjena prepreka detektovana.
+bool FLAG_obstacleDetected = FALSE;                 // Flag koji signalizira da se stoji zbog prepreke u unutrasnjoj zoni.
+
+/* Zone usporavanja ispred prepreke, postavlja ih ObstacleTaskInit(). */
+static ObstacleZoneType obstacle_zone;
+/* CMD_WALL_TARGET je stigao, vazi za sledeci pokret. */
+static bool wall_target = FALSE;
+
+/* Polozaj ultrazvucnih senzora na robotu, redom kao u enum-u iz ultrasound.h. */
+static const OgMountType us_mount[ US_NUM ] =
+{
+  { -150, -80, -1 },    // US_BACK_LEFT
+  { -150,  80, -1 },    // US_BACK_RIGHT
+  {  150,  80,  1 },    // US_FRONT_RIGHT
+  {  150, -80,  1 },    // US_FRONT_LEFT
+};
 
 void InitTimer6(void);
+static void ControlLoop(void);
+static void ObstacleTask(void);
+static void GridTask(void);
 
 
 /* Private function prototypes -----------------------------------------------*/
 /* Proverava da li je robot stigao na cilj. */
 _Bool checkIfAtDest( void );
-/* Provera flag-ova senzora i zakljucivanje da li ima prepreke ili ne. */
-_Bool checkForObstacle( void );
-/* Staje sa lepim usporavanjem ako detekuje prepreku. */
-_Bool stopIfObstacle( void );
+/* Usporava ispred prepreke i staje u unutrasnjoj zoni. */
+_Bool slowDownIfObstacle( void );
 /* Private functions ---------------------------------------------------------*/
 
 extern  bool running;
@@ -370,184 +354,394 @@ void SendDestFlag( void )
   sending_iterator=1;
 }
 
+/* Cetiri nibl-a sa pocetkom na received_array[i] u 16-bitni podatak. */
+static int ReadData16( int i )
+{
+  return received_array[i] | received_array[i+1]<<4 | received_array[i+2]<<8 | received_array[i+3]<<12;
+}
+
+/* Osam nibl-ova sa pocetkom na received_array[i] u 32-bitni podatak. */
+static long ReadData32( int i )
+{
+  return ReadData16( i ) | (long)ReadData16( i + 4 )<<16;
+}
+
 /**
-  *
+  * @brief  Zajednicki deo za kretanje i rotaciju. Nova pozicija se zadaje
+  *         samo ako ID komande nije isti kao kod prethodne, tako da ponovljena
+  *         poruka (izgubljen ACK) ne pomera robota dva puta.
+  * @param  sign: 1 napred/desno, -1 nazad/levo.
+  * @param  dir_Y: 1 kad oba tocka idu u istom smeru, -1 za rotaciju.
+  * @param  front: da li se gledaju prednji senzori.
+  * @param  back: da li se gledaju zadnji senzori.
+  * @retval None
   */
-void Response(void){
-  
+static void MoveRelative( int sign, int dir_Y, bool front, bool back )
+{
   unsigned char temp_ID;
-  
-  /* Dekodovanje poruke. */
-  if (address == ADDR)
-  {
-    switch (received_array[0])
-    {
-      case 0xE0: komanda = 'a'; break;  //Podesavanje uglovne konstante
-      case 0x01: komanda = 'b'; break;  //Setovanje pozicije robota(x, y, ugao)
-      case 0xE2: komanda = 'c'; break;  //Reset pozicije na nulu
-      case 0x0A: komanda = 'd'; break;  //Emergency stop
-      case 0x04: komanda = 'l'; znak = 1; break;  //Kretanje napred
-      case 0x05: komanda = 'l'; znak = -1; break; //Kretanje nazad
-      case 0x06: komanda = 'r'; znak = 1; break;  //Rotacija desno
-      case 0x07: komanda = 'r'; znak = -1; break; //Rotacija levo
-      case 0x11: komanda = 's'; break;  // Paljenje senzora                              PITATI JOVICICA!!!
-      case 0x12: komanda = 'q'; break;  // Gasenje senzora
-      case 0xF7: komanda = 'v'; break;  // Inspektorska, vraca status poruku koja sadrzi poziciju, rotaciju, status robota i ready flag(oznacava da li je robot stigao u zadatu poziciju)
-      case 0xFC: komanda='p'; break;    // Inspektorska, vraca da li je robot stigao u zadatu poziciju.
-      case 0xFB: komanda = 'z'; break;  //Podesavanje preskalera za brzinu
-      case 0xFA: komanda = 'n'; break;  //zaustavi sve....
-      default: komanda = 'v'; break;
-    };
-    
-    /* Izvrsavanje instrukcije. */
-    
-    /* Kretanje napred ili nazad. */
-    if (komanda == 'l') {        
-        x = znak * (received_array[1] | received_array[2]<<4 | received_array[3]<<8 | received_array[4]<<12);        
-        temp_ID=(received_array[5] | received_array[6]<<4);         
-        if (temp_ID != command_ID){
-          Pos1 = zadata_pozicija_X + x;
-          Pos2 = zadata_pozicija_Y + x;
-          zadata_pozicija_X = Pos1;
-          zadata_pozicija_Y = Pos2;
-          zapamcena_pozicija_X = zadata_pozicija_X;
-          zapamcena_pozicija_Y = zadata_pozicija_Y;
-          if ( znak == 1 )
-          {
-            FLAG_sensorFrontEnable = TRUE;
-            FLAG_sensorBackEnable = FALSE;
-          }
-          else if ( znak == -1 )
-          {
-            FLAG_sensorFrontEnable = FALSE;
-            FLAG_sensorBackEnable = TRUE;
-          }
-          command_ID=temp_ID;
-        };        
-        SendAck();
+
+  x = sign * ReadData16( 1 );
+  temp_ID = (received_array[5] | received_array[6]<<4);
+  if (temp_ID != command_ID){
+    Pos1 = zadata_pozicija_X + x;
+    Pos2 = zadata_pozicija_Y + dir_Y * x;
+    zadata_pozicija_X = Pos1;
+    zadata_pozicija_Y = Pos2;
+    zapamcena_pozicija_X = zadata_pozicija_X;
+    zapamcena_pozicija_Y = zadata_pozicija_Y;
+    FLAG_sensorFrontEnable = front;
+    FLAG_sensorBackEnable = back;
+    ObstacleZoneWall( &obstacle_zone, wall_target );
+    wall_target = FALSE;
+    command_ID = temp_ID;
+  }
+  SendAck();
+}
+
+/* Prvi podatak iz data_log koji jos nije poslat i prvi posle trazenog opsega. */
+static unsigned int log_stream_offset = 0;
+static unsigned int log_stream_end = 0;
+
+/**
+  * @brief  Pravi jedan frejm sa najvise LOG_CHUNK_ENTRIES podataka iz
+  *         data_log, pocevsi od log_stream_offset. Podaci su 16-bitni i pakuju
+  *         se kao niz bitova u 7-bitne bajtove (najnizi bit prvi), tako da se
+  *         0xFF nikad ne pojavljuje. Sadrzaj frejma:
+  *         offset(2) broj(1) ukupno(2) podaci(ceil(16*broj/7)), sve 7-bitno.
+  *         Pomocu offset-a host zna koje delove treba ponovo da trazi.
+  * @param  None
+  * @retval None
+  */
+static void BuildLogChunk( void )
+{
+  unsigned long bits = 0;
+  int nbits = 0;
+  unsigned int count, i, n = 3;
+
+  count = log_stream_end - log_stream_offset;
+  if (count > LOG_CHUNK_ENTRIES) count = LOG_CHUNK_ENTRIES;
+
+  sending_array[n++] = log_stream_offset & 0x7F;
+  sending_array[n++] = (log_stream_offset >> 7) & 0x7F;
+  sending_array[n++] = count;
+  sending_array[n++] = DATA_LOG_SIZE & 0x7F;
+  sending_array[n++] = (DATA_LOG_SIZE >> 7) & 0x7F;
+  for (i = 0; i < count; i++) {
+    bits |= (unsigned long)(data_log[log_stream_offset + i] & 0xFFFF) << nbits;
+    nbits += 16;
+    while (nbits >= 7) {
+      sending_array[n++] = bits & 0x7F;
+      bits >>= 7;
+      nbits -= 7;
     }
-    /* Rotacija levo ili desno. */
-    else if (komanda == 'r') {        
-        x = (received_array[1] | received_array[2]<<4 | received_array[3]<<8 | received_array[4]<<12);
-        x = x * znak;        
-        temp_ID=(received_array[5] | received_array[6]<<4);         
-        if (temp_ID!=command_ID){
-          Pos1 = zadata_pozicija_X + x;
-          Pos2 = zadata_pozicija_Y - x;
-          zadata_pozicija_X=Pos1;
-          zadata_pozicija_Y=Pos2;
-          zapamcena_pozicija_X = zadata_pozicija_X;
-          zapamcena_pozicija_Y = zadata_pozicija_Y;
-          command_ID=temp_ID;
-          
-          FLAG_sensorFrontEnable = FALSE;
-          FLAG_sensorBackEnable = FALSE;
-        };       
-        SendAck();
-     }
-    //Podesavanje preskalera za brzinu
-     else if (komanda == 'z') {
-        x = (received_array[1] | received_array[2]<<4 | received_array[3]<<8 | received_array[4]<<12);  
-        TIM2->PSC=x;
-        TIM7->PSC=x;
-        SendAck();        
-     }
-     //Inspektorska, vraca status poruku koja sadrzi poziciju, rotaciju i ready flag(oznacava da li je robot stigao u zadatu poziciju)
-     else if (komanda == 'v') {
-        SendPosition();
-     }
-    //Podesavanje uglovne konstante
-     else if (komanda == 'a') {
-        x = (received_array[1] | received_array[2]<<4 | received_array[3]<<8 | received_array[4]<<12);  
-        angularConstant=180/((float)x);
-        SendAck();        
-     }
-     //Setovanje pozicije robota(x, y, ugao)
-     else if (komanda == 'b') {        
-        abs_X = (received_array[1] | received_array[2]<<4 | received_array[3]<<8 | received_array[4]<<12 | received_array[5]<<16 | received_array[6]<<20 | received_array[7]<<24 | received_array[8]<<28);
-        abs_Y = (received_array[9] | received_array[10]<<4 | received_array[11]<<8 | received_array[12]<<12 | received_array[13]<<16 | received_array[14]<<20 | received_array[15]<<24 | received_array[16]<<28);
-        abs_Theta = (received_array[17] | received_array[18]<<4 | received_array[19]<<8 | received_array[20]<<12 | received_array[21]<<16 | received_array[22]<<20 | received_array[23]<<24 | received_array[24]<<28);
-        SendAck();
-     }
-     //Reset pozicije na nulu
-     else if (komanda == 'c') {        
-        abs_X=0;
-        abs_Y=0;
-        abs_Theta=0;     
-        SendAck();
-     }
-    //Emergency stop
-     else if (komanda == 'd') {
-        zadata_pozicija_X=trenutna_pozicija_X;
-        zadata_pozicija_Y=trenutna_pozicija_Y;
-        SendAck();
-     }
-     /* Paljenje UV senzora. */
-     else if(komanda == 's')
-     {
-       FLAG_sensorEnable = TRUE;
-       SendAck();
-     }
-     /* Gasenje UV senzora. */
-     else if(komanda == 'q')
-     {
-       FLAG_sensorEnable = FALSE;
-       SendAck();
-     }
-     else if(komanda == 'p')
-     {
-       SendDestFlag();
-     }
-     else if (komanda == 'n') {
-        running=TRUE;
-        SendAck();
-     }
   }
-};
+  if (nbits > 0) sending_array[n++] = bits & 0x7F;
+  log_stream_offset += count;
+
+  sending_length = n + 1;
+  sending_array[0] = 0xFF;
+  sending_array[1] = ADDR|0x40;
+  sending_array[2] = sending_length-3;
+  schksum = 0;
+  for(int i=1;i<sending_length-1;i++) schksum+=sending_array[i];
+  sending_array[sending_length-1] = schksum&0x7F;
+}
 
+/**
+  * @brief  Citanje data_log-a u jednom zahtevu. Podaci (offset, broj) su 16-bitni.
+  *         Frejmovi idu jedan za drugim iz TC prekida, bez gasenja RS485
+  *         predaje izmedju njih. Opseg van log-a vraca prazan frejm sa
+  *         ukupnom duzinom log-a.
+  * @param  None
+  * @retval None
+  */
+static void CmdLogRead( void )
+{
+  unsigned int offset = ReadData16( 1 );
+  unsigned int count = ReadData16( 5 );
+
+  if (offset > DATA_LOG_SIZE) offset = DATA_LOG_SIZE;
+  if (count > DATA_LOG_SIZE - offset) count = DATA_LOG_SIZE - offset;
+  log_stream_offset = offset;
+  log_stream_end = offset + count;
+  BuildLogChunk();
+  GPIO_SetBits(GPIOC,GPIO_Pin_12); //enejbluje se RS485 predaja
+  USART_SendData(USART3,  sending_array[0]);//salje prvi podatak
+  sending_iterator=1;
+}
 
-//PITATI JOVICICA
-void SendLog(void)
+/**
+  * @brief  Odgovor sa nizom 16-bitnih podataka, svaki kao cetiri nibl-a.
+  * @param  data: podaci.
+  * @param  num: broj podataka, najvise 63.
+  * @retval None
+  */
+static void SendData16( const uint16_t *data, int num )
 {
-        sending_length=4;//sending_length je . pored inforamcionih N informacionih bajtova salje se jos 4 dodatna bajta. dakle ako je max 256 korisnih podataka duzina poruke je 260
-        sending_array[0]=0xFF;
-        sending_array[1]=ADDR|0x40;
-        sending_array[2]=sending_length-3;        
-        schksum=0;
-        for(int i=1;i<sending_length-1;i++){
-          schksum+=sending_array[i]&0xFF;
-        }
-        sending_array[3]=schksum&0x7F;//0x4B
-      
-        USART_ITConfig(USART3, USART_IT_RXNE, DISABLE);
-        USART_ITConfig(USART3, USART_IT_TXE, ENABLE);
+  int i, n = 3;
 
-};
+  for (i = 0; i < num; i++) {
+    sending_array[n++] = data[i] & 0x0F;
+    sending_array[n++] = (data[i] >> 4) & 0x0F;
+    sending_array[n++] = (data[i] >> 8) & 0x0F;
+    sending_array[n++] = (data[i] >> 12) & 0x0F;
+  }
+  sending_length = n + 1;
+  sending_array[0] = 0xFF;
+  sending_array[1] = ADDR|0x40;
+  sending_array[2] = sending_length-3;
+  schksum = 0;
+  for(int i=1;i<sending_length-1;i++) schksum+=sending_array[i];
+  sending_array[sending_length-1] = schksum&0x7F;
+  GPIO_SetBits(GPIOC,GPIO_Pin_12); //enejbluje se RS485 predaja
+  USART_SendData(USART3,  sending_array[0]);//salje prvi podatak
+  sending_iterator=1;
+}
 
-void SendLogSingle(int index)
+/* Podesavanje snimanja: kanali(2), dogadjaji(2), decimacija(4), zapisa pre dogadjaja(4). */
+static void CmdTraceConfig( void )
 {
-        sending_length=8;//sending_length je . pored inforamcionih N informacionih bajtova salje se jos 4 dodatna bajta. dakle ako je max 256 korisnih podataka duzina poruke je 260
-        sending_array[0]=0xFF;
-        sending_array[1]=ADDR|0x40;
-        sending_array[2]=sending_length-3;  
-     
-        sending_array[3]=(data_log[index] & 0x0000000F);
-        sending_array[4]=(data_log[index] & 0x000000F0)>>4;
-        sending_array[5]=(data_log[index] & 0x00000F00)>>8;
-        sending_array[6]=(data_log[index] & 0x0000F000)>>12;   
-  
-        schksum=0;
-        for(int i=1;i<sending_length-1;i++){
-          schksum+=sending_array[i]&0xFF;
-        }
-        sending_array[7]=schksum&0x7F;//0x4B
-      
-        USART_ITConfig(USART3, USART_IT_RXNE, DISABLE);
-        USART_ITConfig(USART3, USART_IT_TXE, ENABLE);
+  TraceConfigure( received_array[1] | received_array[2]<<4,
+                  received_array[3] | received_array[4]<<4,
+                  ReadData16( 5 ), ReadData16( 9 ) );
+  SendAck();
+}
+
+/* Pocetak snimanja. */
+static void CmdTraceArm( void )
+{
+  TraceArm();
+  SendAck();
+}
+
+/* Rucni dogadjaj. */
+static void CmdTraceTrigger( void )
+{
+  TraceTrigger( TRACE_TRIG_MANUAL );
+  SendAck();
+}
+
+/* Stanje, dogadjaj, kanali, broj zapisa i polozaj dogadjaja. */
+static void CmdTraceStatus( void )
+{
+  uint16_t status[5];
+
+  status[0] = TraceState();
+  status[1] = TraceTriggerEvent();
+  status[2] = TraceChannels();
+  status[3] = TraceRecords();
+  status[4] = TraceTriggerRecord();
+  SendData16( status, 5 );
+}
+
+/**
+  * @brief  Statistika prekidne rutine: broj poziva (2 reci), min, srednje,
+  *         max (u ciklusima, do 65535), broj ugnjezdavanja, najveca dubina,
+  *         opterecenje u promilima, histogram i najvece kasnjenje. Id 0xFF
+  *         zahteva brisanje statistike, koje radi glavna petlja, jer je
+  *         merenje ovog prekida u toku.
+  * @param  None
+  * @retval None
+  */
+static void CmdIsrProfile( void )
+{
+  uint16_t data[9 + ISR_PROFILE_BUCKETS];
+  uint8_t id = received_array[1] | received_array[2]<<4;
+  IsrProfileStats *s;
+  int i;
+
+  if (id >= ISR_ID_NUM) {
+    IsrProfileRequestReset();
+    SendAck();
+    return;
+  }
+  s = &isr_profile[id];
+  data[0] = s->count & 0xFFFF;
+  data[1] = s->count >> 16;
+  data[2] = s->count ? (s->min > 0xFFFF ? 0xFFFF : s->min) : 0;
+  data[3] = IsrProfileAverage(id) > 0xFFFF ? 0xFFFF : IsrProfileAverage(id);
+  data[4] = s->max > 0xFFFF ? 0xFFFF : s->max;
+  data[5] = s->nested > 0xFFFF ? 0xFFFF : s->nested;
+  data[6] = isr_profile_max_depth;
+  data[7] = IsrProfileLoad();
+  for (i = 0; i < ISR_PROFILE_BUCKETS; i++) data[8 + i] = s->hist[i];
+  data[8 + ISR_PROFILE_BUCKETS] = s->latency_max > 0xFFFF ? 0xFFFF : s->latency_max;
+  SendData16( data, 9 + ISR_PROFILE_BUCKETS );
+}
+
+/* Kretanje napred. */
+static void CmdMoveForward( void )  { MoveRelative( 1, 1, TRUE, FALSE ); }
+/* Kretanje nazad. */
+static void CmdMoveBackward( void ) { MoveRelative( -1, 1, FALSE, TRUE ); }
+/* Rotacija desno. */
+static void CmdRotateRight( void )  { MoveRelative( 1, -1, FALSE, FALSE ); }
+/* Rotacija levo. */
+static void CmdRotateLeft( void )   { MoveRelative( -1, -1, FALSE, FALSE ); }
+
+/* Podesavanje preskalera za brzinu. */
+static void CmdPrescaler( void )
+{
+  x = ReadData16( 1 );
+  TIM2->PSC = x;
+  TIM7->PSC = x;
+  SendAck();
+}
+
+/* Podesavanje uglovne konstante. */
+static void CmdAngularConst( void )
+{
+  x = ReadData16( 1 );
+  angularConstant = 180/((float)x);
+  SendAck();
+}
+
+/* Setovanje pozicije robota(x, y, ugao). */
+static void CmdSetPosition( void )
+{
+  abs_X = ReadData32( 1 );
+  abs_Y = ReadData32( 9 );
+  abs_Theta = ReadData32( 17 );
+  /* Mreza je u koordinatama stola, posle nove pozicije ne vazi. */
+  OgInit();
+  SendAck();
+}
+
+/* Reset pozicije na nulu. */
+static void CmdResetPosition( void )
+{
+  abs_X = 0;
+  abs_Y = 0;
+  abs_Theta = 0;
+  OgInit();
+  SendAck();
+}
+
+/* Slobodan put ispred ili iza robota iz mreze zauzetosti: duzina u cm, bit 15
+   za hodnik iza robota. Odgovor je slobodno rastojanje u cm. */
+static void CmdCorridor( void )
+{
+  uint16_t data = ReadData16( 1 );
+  uint32_t length_mm = (uint32_t)( data & 0x7FFF ) * 10;
+  uint16_t free_cm;
+
+  if (length_mm > CORRIDOR_MAX_MM) length_mm = CORRIDOR_MAX_MM;
+  free_cm = OgCorridorFree( (data & 0x8000) ? -1 : 1, (uint16_t)length_mm, CORRIDOR_WIDTH_MM ) / 10;
+  SendData16( &free_cm, 1 );
+}
+
+/* Emergency stop. */
+static void CmdStop( void )
+{
+  zadata_pozicija_X = trenutna_pozicija_X;
+  zadata_pozicija_Y = trenutna_pozicija_Y;
+  SendAck();
+}
+
+/* Paljenje UV senzora. */
+static void CmdUltrasoundOn( void )
+{
+  FLAG_sensorEnable = TRUE;
+  SendAck();
+}
+
+/* Gasenje UV senzora. */
+static void CmdUltrasoundOff( void )
+{
+  FLAG_sensorEnable = FALSE;
+  SendAck();
+}
+
+/* Cilj sledeceg pokreta je zid ili kucica, prepreka na cilju ne zaustavlja
+   robota po TTC-u. */
+static void CmdWallTarget( void )
+{
+  wall_target = TRUE;
+  SendAck();
+}
+
+/* Napon baterije koji meri glavna ploca. */
+static void CmdSupplyVoltage( void )
+{
+  VoltageCompSet( ReadData16( 1 ) );
+  SendAck();
+}
+
+/* Start meca, main() posle ovoga pokrece TIM6. */
+static void CmdStartRunning( void )
+{
+  running = TRUE;
+  SendAck();
+}
+
+/**
+  * Tabela skokova, indeksira se direktno kodom komande. Nova komanda se dodaje
+  * samo novim redom ovde. Nedefinisani kodovi vracaju status (SendPosition),
+  * kao i ranije.
+  */
+static const CommandEntry command_table[256] = {
+  [CMD_SET_POSITION]   = { CmdSetPosition,   PAYLOAD_POSITION },
+  [CMD_MOVE_FORWARD]   = { CmdMoveForward,   PAYLOAD_DATA16_ID },
+  [CMD_MOVE_BACKWARD]  = { CmdMoveBackward,  PAYLOAD_DATA16_ID },
+  [CMD_ROTATE_RIGHT]   = { CmdRotateRight,   PAYLOAD_DATA16_ID },
+  [CMD_ROTATE_LEFT]    = { CmdRotateLeft,    PAYLOAD_DATA16_ID },
+  [CMD_STOP]           = { CmdStop,          0 },
+  [CMD_ULTRASOUND_ON]  = { CmdUltrasoundOn,  0 },
+  [CMD_ULTRASOUND_OFF] = { CmdUltrasoundOff, 0 },
+  [CMD_WALL_TARGET]    = { CmdWallTarget,    0 },
+  [CMD_ANGULAR_CONST]  = { CmdAngularConst,  PAYLOAD_DATA16 },
+  [CMD_LOG_READ]       = { CmdLogRead,       PAYLOAD_DATA16 * 2 },
+  [CMD_TRACE_CONFIG]   = { CmdTraceConfig,   PAYLOAD_TRACE_CONFIG },
+  [CMD_TRACE_ARM]      = { CmdTraceArm,      0 },
+  [CMD_TRACE_TRIGGER]  = { CmdTraceTrigger,  0 },
+  [CMD_TRACE_STATUS]   = { CmdTraceStatus,   0 },
+  [CMD_ISR_PROFILE]    = { CmdIsrProfile,    PAYLOAD_DATA8 },
+  [CMD_SUPPLY_VOLTAGE] = { CmdSupplyVoltage, PAYLOAD_DATA16 },
+  [CMD_RESET_POSITION] = { CmdResetPosition, 0 },
+  [CMD_CORRIDOR]       = { CmdCorridor,      PAYLOAD_DATA16 },
+  [CMD_STATUS]         = { SendPosition,     0 },
+  [CMD_START_RUNNING]  = { CmdStartRunning,  0 },
+  [CMD_PRESCALER]      = { CmdPrescaler,     PAYLOAD_DATA16 },
+  [CMD_CHECK_ARRIVE]   = { SendDestFlag,     0 },
 };
 
+unsigned long dispatch_cycles_last = 0;
+unsigned long dispatch_cycles_max = 0;
+unsigned int command_rejected = 0;
+
+/**
+  * @brief  Dekodovanje i izvrsavanje primljene komande. Poziva se iz
+  *         USART3 prekida kada je checksum-a ispravna. Poruka ciji je sadrzaj
+  *         kraci od onog koji komanda ocekuje se odbacuje bez ACK-a, pa glavna
+  *         ploca ponavlja komandu.
+  * @param  None
+  * @retval None
+  */
+void Response(void){
+  const CommandEntry *entry;
+  unsigned long start;
+
+  if (address != ADDR) return;
+
+  start = CYCLE_COUNTER_READ();
+  entry = &command_table[received_array[0] & 0xFF];
+  if (entry->handler == NULL) {
+    SendPosition();
+  }
+  else if (message_size - 2 < entry->payload_len) {
+    command_rejected++;
+    LOG_WARN("komanda 0x%02X odbacena, %d bajtova", received_array[0] & 0xFF, message_size - 2);
+  }
+  else {
+    entry->handler();
+  }
+  dispatch_cycles_last = CYCLE_COUNTER_READ() - start;
+  if (dispatch_cycles_last > dispatch_cycles_max) dispatch_cycles_max = dispatch_cycles_last;
+}
+
+
 void USART3_IRQHandler( void )
-{  
+{
+  ISR_PROFILE_ENTER();  
   /* Prijem poruke. */
   if((USART_GetITStatus(USART3, USART_IT_RXNE) != RESET))
   {
@@ -591,6 +785,13 @@ void USART3_IRQHandler( void )
         USART_SendData( USART3, sending_array[ sending_iterator ] );
         sending_iterator++;
     }
+    else if ( log_stream_offset < log_stream_end )
+    {
+      /* Sledeci deo log-a ide odmah, linija ostaje zauzeta. */
+      BuildLogChunk();
+      USART_SendData( USART3, sending_array[ 0 ] );
+      sending_iterator = 1;
+    }
     else 
     {
       sending_iterator = 0;
@@ -606,6 +807,7 @@ void USART3_IRQHandler( void )
     USART_ClearITPendingBit(USART3, USART_IT_TXE);
     USART_ITConfig(USART3, USART_IT_TC, ENABLE);
   }
+  ISR_PROFILE_EXIT( ISR_ID_USART3 );
 }
 
 /******************************************************************************/
@@ -617,6 +819,7 @@ void USART3_IRQHandler( void )
 
 void EXTI2_IRQHandler(void)
 {
+  ISR_PROFILE_ENTER();
   if(EXTI_GetITStatus(EXTI_Line2) != RESET)
   {
     /* Clear the  EXTI line pending bit */
@@ -635,10 +838,12 @@ void EXTI2_IRQHandler(void)
     }
   }
   else err++;
+  ISR_PROFILE_EXIT( ISR_ID_EXTI2 );
 }
 
 void EXTI9_5_IRQHandler(void)
 {
+  ISR_PROFILE_ENTER();
   
   if (EXTI_GetITStatus(EXTI_Line5) != RESET)
   {
@@ -659,10 +864,12 @@ void EXTI9_5_IRQHandler(void)
     }    
   }
   else err++;
+  ISR_PROFILE_EXIT( ISR_ID_EXTI9_5 );
 }
 
 void EXTI15_10_IRQHandler(void)
-{  
+{
+  ISR_PROFILE_ENTER();  
   GPIO_SetBits(GPIOA,GPIO_Pin_5);
   EXTI_InitTypeDef EXTI_InitStructure;
   if (EXTI_GetITStatus(EXTI_Line14) != RESET)
@@ -702,6 +909,7 @@ void EXTI15_10_IRQHandler(void)
   }
   else err++;
   GPIO_ResetBits(GPIOA,GPIO_Pin_5);
+  ISR_PROFILE_EXIT( ISR_ID_EXTI15_10 );
 }
 /******************************************************************************/
 /*            Cortex-M3 Processor Exceptions Handlers                         */
@@ -815,7 +1023,23 @@ void PendSV_Handler(void)
 
 
 
+/**
+  * @brief  SysTick prekid na 10 ms, regulacija brzine oba motora, pa zatim
+  *         reakcija na prepreku, da njeno trajanje ne pomera trenutak
+  *         upisa PWM-a. Kasnjenje je vreme od pretovara brojaca SysTick-a.
+  * @param  None
+  * @retval None
+  */
 void SysTick_Handler(void)
+{
+  ISR_PROFILE_LATENCY( ISR_ID_SYSTICK, SysTick->LOAD - SysTick->VAL );
+  ISR_PROFILE_ENTER();
+  ControlLoop();
+  ObstacleTask();
+  ISR_PROFILE_EXIT( ISR_ID_SYSTICK );
+}
+
+static void ControlLoop(void)
 {
   int pwm_command;
   //TIM_ClearFlag(TIM2, TIM_FLAG_Update);
@@ -929,6 +1153,9 @@ void SysTick_Handler(void)
   brzina_prim=brzina;
   err = ENC1-ENC1_old;
   pwm_command = PID1(brzina,err);
+  pwm_motor1 = pwm_command;
+  if (pwm_command>=990 || pwm_command<=-990) TraceTrigger(TRACE_TRIG_PID_SATURATION);
+  pwm_command = VoltageCompApply(pwm_command);//kompenzacija napona baterije
   if (pwm_command>100){
     GPIO_ResetBits(GPIOA,GPIO_Pin_4);
     GPIO_SetBits(GPIOA,GPIO_Pin_10);
@@ -954,6 +1181,9 @@ void SysTick_Handler(void)
   //brzina=Speed2;
   err = ENC2-ENC2_old;  
   pwm_command = PID2(brzina,err);
+  pwm_motor2 = pwm_command;
+  if (pwm_command>=990 || pwm_command<=-990) TraceTrigger(TRACE_TRIG_PID_SATURATION);
+  pwm_command = VoltageCompApply(pwm_command);
   if (pwm_command>100){
     GPIO_SetBits(GPIOC,GPIO_Pin_9);
     GPIO_ResetBits(GPIOC,GPIO_Pin_8);
@@ -1003,8 +1233,7 @@ void SysTick_Handler(void)
     flag_following_active=TRUE;
   }
   
-  //USART_SendData(USART3, err);
-  //USART_SendData(USART3, ((brzina == 0) ? 43 : 91));
+  LOG_DEBUG( "err %d brzina %d", err, brzina );
   
   if ((brzina==0)){
     //GPIO_ResetBits(GPIOB, GPIO_Pin_12);//DISABLE M1
@@ -1041,7 +1270,6 @@ int PWMTC(int pwm){
   return pwm;
 }
 int PID_continous(float gr){
-  static float Kpc=0.03, Kic=0, Kdc=0.7, Kac=0.5;
   static int counter=0;
   static float delta_err,err_previous=0;
   float Propc, Difc, Propac;
@@ -1200,340 +1428,207 @@ _Bool checkIfAtDest( void )
 /*----------------------------------------------------------------------------*/
 
 /**
-  * @brief  Proverava senzore da li je detektovana prepreka i vraca TRUE ako jeste.
+  * @brief  Senzor koji vidi najblizu prepreku u smeru kretanja, od senzora
+  *         koji se gledaju.
   * @param  Nema ulaznih argumenata.
-  * @retval Vraca TRUE ako je prepreka detektovana inace vraca FALSE.
+  * @retval Indeks u ultrasound[], -1 ako se senzori ne gledaju ili je
+  *         kretanje rotaciono.
   * @author Praetorian ( archmarko92@gmail.com )
   */
-_Bool checkForObstacle( void )
+static int8_t obstacleSensor( void )
 {
-  /* Deaktiviranje flag-a koji signalizira detektovanu prepreku ako smo stigli na poziciju, inace ga ne diramo. */
-  if( checkIfAtDest() ) FLAG_obstacleDetected = FALSE;
+  uint8_t left, right;
   
   /* Provera da li se senzori gledaju. */
-  if( FLAG_sensorEnable )
+  if( !FLAG_sensorEnable ) return -1;
+  
+  /* Prednji senzori pri kretanju napred, zadnji pri kretanju unazad. */
+  if( FLAG_sensorFrontEnable && zadata_pozicija_X > trenutna_pozicija_X && zadata_pozicija_Y > trenutna_pozicija_Y )
   {
-    /* Provera da li se gledaju prednji senzori. */
-    if( FLAG_sensorFrontEnable )
-    {
-      if( ( ( distance_fr_ch3 <= MAX_DISTANCE_MM ) || ( distance_fl_ch4 <= MAX_DISTANCE_MM ) ) && !FLAG_obstacleDetected )
-         return TRUE;
-      else
-         return FALSE;
-    }
-    
-    /* Provera da li se gledaju zadnji senzori. */
-    else if( FLAG_sensorBackEnable )
-    {
-      if( ( ( distance_bl_ch1 <= MAX_DISTANCE_MM ) || ( distance_br_ch2 <= MAX_DISTANCE_MM ) ) && !FLAG_obstacleDetected )
-         return TRUE;
-      else
-         return FALSE;
-    }
-    
-    /* Nijedni senzori se ne gledaju. */
-    else return FALSE;
+    left = US_FRONT_LEFT;
+    right = US_FRONT_RIGHT;
+  }
+  else if( FLAG_sensorBackEnable && zadata_pozicija_X < trenutna_pozicija_X && zadata_pozicija_Y < trenutna_pozicija_Y )
+  {
+    left = US_BACK_LEFT;
+    right = US_BACK_RIGHT;
   }
   
-  /* Ne gledaju se senzori. */
-  else return FALSE;
-              
+  /* Rotacija ili se senzori u smeru kretanja ne gledaju. */
+  else return -1;
+  
+  return ultrasound[ left ].distance_mm < ultrasound[ right ].distance_mm ? left : right;
 }
 /*----------------------------------------------------------------------------*/
               
 
 /**
-  * @brief  Staje sa lepim usporavanjem ako detekuje prepreku.
+  * @brief  Usporava ispred prepreke: ogranicava maximum_speed_X/Y prema
+  *         udaljenosti i vremenu do sudara iz brzine priblizavanja senzora,
+  *         a u unutrasnjoj zoni zaustavlja pozicione kontrolere (motion_hold)
+  *         bez menjanja zadate pozicije, pa se kretanje nastavlja cim se
+  *         prepreka skloni. Zid na cilju kome se prilazi polako ne
+  *         zaustavlja robota. Poziva se svakih 10 ms.
   * @param  Nema ulaznih argumenata.
-  * @retval Vraca TRUE ako se staje usled prepreke, inace se vraca FALSE.
+  * @retval Vraca TRUE ako se stoji usled prepreke, inace se vraca FALSE.
   * @author Praetorian ( archmarko92@gmail.com )
   */
-_Bool stopIfObstacle( void )     
+_Bool slowDownIfObstacle( void )     
 {
-   /* Ako je detekovana prepreka zapocni zaustavljanje. */
-   if( checkForObstacle() && !checkIfAtDest() )
-   { 
-     
-     /* Provera da li se robot krece napred. */
-     if( zadata_pozicija_X > trenutna_pozicija_X && zadata_pozicija_Y > trenutna_pozicija_Y )
-     {
-       FLAG_obstacleDetected = TRUE;
-       zapamcena_pozicija_X = zadata_pozicija_X;
-       zapamcena_pozicija_Y = zadata_pozicija_Y;
-       zadata_pozicija_X = trenutna_pozicija_X + STOP_DISTANCE;
-       zadata_pozicija_Y = trenutna_pozicija_Y + STOP_DISTANCE;
-       return TRUE;
-     }
-     
-     /* Provera da li se robot krece unazad. */
-     else if ( zadata_pozicija_X < trenutna_pozicija_X && zadata_pozicija_Y < trenutna_pozicija_Y )
-     {
-       FLAG_obstacleDetected = TRUE;
-       zapamcena_pozicija_X = zadata_pozicija_X;
-       zapamcena_pozicija_Y = zadata_pozicija_Y;
-       zadata_pozicija_X = trenutna_pozicija_X - STOP_DISTANCE;
-       zadata_pozicija_Y = trenutna_pozicija_Y - STOP_DISTANCE;
-       return TRUE;
-     }
-     
-     /* Ne radi nista ako je rotaciono kretanje. */
-     else return FALSE;
-   }
-   
-   /* Ako je detektovana prepreka a u poziciji smo. */
-   else if( !checkForObstacle() && checkIfAtDest() )
-   {
-     zadata_pozicija_X = zapamcena_pozicija_X;
-     zadata_pozicija_Y = zapamcena_pozicija_Y;
-   }
-   
-   /* Ako nije detekovana prepreka ne radi nista. */
-   else return FALSE;
-}
-/*----------------------------------------------------------------------------*/
-
-/**
-  * @brief  Prekidna rutina tajmera 4. Merenje udaljenosti od objekata pomocu
-  *         ultrazvucnih senzora.
-  * @param  Nema ulaznih argumenata.
-  * @retval Nema izlaznih argumenata.
-  * @author Milica Stojiljkovic
-  */
-void TIM4_IRQHandler( void )
-{
-  /* Provera da li je stigao zahtev za prekid od kanala 1. Senzor nazad, levo. */
-  if ( TIM_GetITStatus( TIM4, TIM_IT_CC1 ) == SET )
-  {
-    TIM_ClearITPendingBit( TIM4, TIM_IT_CC1 );
-    
-    /* Masina stanja za racunanje udaljenosti prepreke od senzora. */
-    switch( state_bl_ch1 )
-    {
-      /* Hvatanje uzlazne ivice. */
-      case 0: 
-        
-          measured_time_bl_rising_ch1 = TIM_GetCapture1( TIM4 );
-          TIM_OC1PolarityConfig( TIM4, TIM_ICPolarity_Falling );
-          state_bl_ch1 = 1;
-          break;
-      
-      /* Hvatanje silazne ivice. */
-      case 1:
-        
-          measured_time_bl_falling_ch1 = TIM_GetCapture1( TIM4 );
-          TIM_OC1PolarityConfig( TIM4, TIM_ICPolarity_Rising );  // sada hvatamo uzlaznu ivicu
-          state_bl_ch1 = 0;
-          
-          /* Racunanje udaljenosti objekta od senzora. */
-          if( measured_time_bl_falling_ch1 > measured_time_bl_rising_ch1 )
-               measured_time_bl_ch1 = measured_time_bl_falling_ch1 - measured_time_bl_rising_ch1;
-          else measured_time_bl_ch1 = ECHO_TIMER_PERIOD - measured_time_bl_rising_ch1 + measured_time_bl_falling_ch1;
-          
-          /* Novu izmerenu vrednost dodajemo u niz. */
-          measured_distance_bl_ch1[ ( index_ch1++ ) % MEASUREMENT_NUM ] =  measured_time_bl_ch1; 
-          
-          /* Provera da li smo prosli prvih par losih merenja. */
-          if ( index_ch1 > MEASUREMENT_NUM ) bad_measurement_end_ch1 = TRUE;
-          
-          /* Ako smo prosli prvih par losih merenja, mozemo da racunamo udaljenost od objekta. */
-          if ( bad_measurement_end_ch1 )
-          {
-            int temp_distance = 0;
-            for ( int j = 0; j < MEASUREMENT_NUM; j++ ) temp_distance += measured_distance_bl_ch1[ j ];
-            distance_bl_ch1 = temp_distance / MEASUREMENT_NUM;
-            distance_bl_ch1 /= CONST_MICRO_SEC_TO_MM;
-          }
-          else
-          {
-            distance_bl_ch1 = measured_distance_bl_ch1[ index_ch1 ] / CONST_MICRO_SEC_TO_MM;
-          }
-          
-          break;
-          
-          
-       default:
-        
-          break; 
-    }
-  }
+  static int last_X = 32767, last_Y = 32767;
+  int step, step_Y, remaining, remaining_Y;
+  int8_t sensor = obstacleSensor();
+  uint16_t distance = US_NO_DATA;
+  int16_t closing = OBST_NO_RATE;
+  uint8_t limit;
   
+  /* Sopstvena brzina iz pomeraja zadate trajektorije za 10 ms i preostali
+     put do cilja, veci od dva tocka. Pravo su jednaki, a kada se razlikuju
+     veci daje kraci TTC i visi prag zaustavljanja. */
+  step = trenutna_pozicija_X - last_X;
+  if( step < 0 ) step = -step;
+  step_Y = trenutna_pozicija_Y - last_Y;
+  if( step_Y < 0 ) step_Y = -step_Y;
+  if( step_Y > step ) step = step_Y;
+  last_X = trenutna_pozicija_X;
+  last_Y = trenutna_pozicija_Y;
   
-  /* Provera da li je stigao zahtev za prekid od kanala 2. Senzor nazad, desno. */
-  else if ( TIM_GetITStatus( TIM4, TIM_IT_CC2 ) == SET )
+  remaining = zadata_pozicija_X - trenutna_pozicija_X;
+  if( remaining < 0 ) remaining = -remaining;
+  remaining_Y = zadata_pozicija_Y - trenutna_pozicija_Y;
+  if( remaining_Y < 0 ) remaining_Y = -remaining_Y;
+  if( remaining_Y > remaining ) remaining = remaining_Y;
+  
+  /* Dok procena brzine vazi, manja od filtrirane i procenjene udaljenosti:
+     procena preskace merenja bez odjeka, a filtar prvi vidi nov objekat. */
+  if( sensor >= 0 )
   {
-    TIM_ClearITPendingBit( TIM4, TIM_IT_CC2 );
-    
-    /* Masina stanja za racunanje udaljenosti prepreke od senzora. */
-    switch(state_br_ch2)
-    {
-      /* Hvatanje uzlazne ivice. */
-      case 0: 
-      {
-          measured_time_br_rising_ch2 = TIM_GetCapture2( TIM4 );
-          TIM_OC2PolarityConfig( TIM4, TIM_ICPolarity_Falling );
-          state_br_ch2 = 1;
-          break;
-      }
-      
-      /* Hvatanje silazne ivice. */
-      case 1:
-        
-          measured_time_br_falling_ch2 = TIM_GetCapture2( TIM4 );
-          TIM_OC2PolarityConfig( TIM4, TIM_ICPolarity_Rising );  // sada hvatamo uzlaznu ivicu
-          state_br_ch2 = 0;
-          
-          /* Racunanje udaljenosti objekta od senzora. */
-          if( measured_time_br_falling_ch2 > measured_time_br_rising_ch2 )
-               measured_time_br_ch2 = measured_time_br_falling_ch2 - measured_time_br_rising_ch2;
-          else measured_time_br_ch2 = ECHO_TIMER_PERIOD - measured_time_br_rising_ch2 + measured_time_br_falling_ch2;
-          
-          /* Novu izmerenu vrednost dodajemo u niz. */
-          measured_distance_br_ch2[ ( index_ch2++ ) % MEASUREMENT_NUM ] =  measured_time_br_ch2; 
-          
-          /* Provera da li smo prosli prvih par losih merenja. */
-          if ( index_ch2 > MEASUREMENT_NUM ) bad_measurement_end_ch2 = TRUE;
-          
-          /* Ako smo prosli prvih par losih merenja, mozemo da racunamo udaljenost od objekta. */
-          if ( bad_measurement_end_ch2 )
-          {
-            int temp_distance = 0;
-            for ( int j = 0; j < MEASUREMENT_NUM; j++ ) temp_distance += measured_distance_br_ch2[ j ];
-            distance_br_ch2 = temp_distance / MEASUREMENT_NUM;
-            distance_br_ch2 /= CONST_MICRO_SEC_TO_MM;
-          }
-          else
-          {
-            distance_br_ch2 = measured_distance_br_ch2[ index_ch2 ] / CONST_MICRO_SEC_TO_MM;
-          }
-          
-          break;
-          
-          
-       default:
-        
-          break; 
-    }
+    distance = ultrasound[ sensor ].distance_mm;
+    closing = RangeRateClosing( &ultrasound[ sensor ].rate );
+    if( RangeRateRange( &ultrasound[ sensor ].rate ) < distance ) distance = RangeRateRange( &ultrasound[ sensor ].rate );
   }
+  limit = ObstacleZoneUpdate( &obstacle_zone, distance, (uint16_t)( step * 100 * 100 / COUNTS_PER_100MM ), closing,
+                              (uint16_t)( (long)remaining * 100 / COUNTS_PER_100MM ) );
   
-  
-  /* Provera da li je stigao zahtev za prekid od kanala 3. Senzor napred, desno. */
-  else if ( TIM_GetITStatus(TIM4, TIM_IT_CC3) == SET )
+  /* Unutrasnja zona. */
+  if( limit == 0 )
   {
-    TIM_ClearITPendingBit( TIM4, TIM_IT_CC3 );
-    
-    /* Masina stanja za racunanje udaljenosti prepreke od senzora. */
-    switch( state_fr_ch3 )
+    if( !FLAG_obstacleDetected )
     {
-      /* Hvatanje uzlazne ivice. */
-      case 0: 
-      {
-          measured_time_fr_rising_ch3 = TIM_GetCapture3( TIM4 );
-          TIM_OC3PolarityConfig( TIM4, TIM_ICPolarity_Falling ); // sada hvatamo silaznu ivicu
-          state_fr_ch3 = 1;
-          break;
-      }
-        
-      /* Hvatanje silazne ivice. */
-      case 1:
-          measured_time_fr_falling_ch3 = TIM_GetCapture3( TIM4 );
-          TIM_OC3PolarityConfig( TIM4, TIM_ICPolarity_Rising );  // sada hvatamo uzlaznu ivicu
-          state_fr_ch3 = 0;
-          
-          /* Racunanje udaljenosti objekta od senzora. */
-          if( measured_time_fr_falling_ch3 > measured_time_fr_rising_ch3 )
-               measured_time_fr_ch3 = measured_time_fr_falling_ch3 - measured_time_fr_rising_ch3;
-          else measured_time_fr_ch3 = ECHO_TIMER_PERIOD - measured_time_fr_rising_ch3 + measured_time_fr_falling_ch3;
-          
-          /* Novu izmerenu vrednost dodajemo u niz. */
-          measured_distance_fr_ch3[ ( index_ch3++ ) % MEASUREMENT_NUM ] =  measured_time_fr_ch3; 
-          
-          /* Provera da li smo prosli prvih par losih merenja. */
-          if ( index_ch3 > MEASUREMENT_NUM ) bad_measurement_end_ch3 = TRUE;
-          
-          /* Ako smo prosli prvih par losih merenja, mozemo da racunamo udaljenost od objekta. */
-          if ( bad_measurement_end_ch3 )
-          {
-            int temp_distance = 0;
-            for ( int j = 0; j < MEASUREMENT_NUM; j++ ) temp_distance += measured_distance_fr_ch3[ j ];
-            distance_fr_ch3 = temp_distance / MEASUREMENT_NUM;
-            distance_fr_ch3 /= CONST_MICRO_SEC_TO_MM;
-          }
-          else
-          {
-            distance_fr_ch3 = measured_distance_fr_ch3[ index_ch3 ] / CONST_MICRO_SEC_TO_MM;
-          }
-          
-          break;
-          
-          
-       default:
-        
-          break; 
+      TraceTrigger( TRACE_TRIG_OBSTACLE );
+      LOG_INFO( "prepreka %u mm, TTC %u ms", distance, obstacle_zone.ttc_ms );
     }
+    FLAG_obstacleDetected = TRUE;
+    motion_hold = 1;
+    limit = OBST_MIN_SPEED;
   }
-  
-  
-  /* Provera da li je stigao zahtev za prekid od kanala 4. Senzor napred, levo. */
-  else if ( TIM_GetITStatus( TIM4, TIM_IT_CC4 ) == SET )
+  else
   {
-    TIM_ClearITPendingBit( TIM4, TIM_IT_CC4 );
-    
-    /* Masina stanja za racunanje udaljenosti prepreke od senzora. */
-    switch( state_fl_ch4 )
-    {
-      /* Hvatanje uzlazne ivice. */
-      case 0: 
-      {
-          measured_time_fl_rising_ch4 = TIM_GetCapture4( TIM4 );
-          TIM_OC4PolarityConfig( TIM4, TIM_ICPolarity_Falling ); // sada hvatamo silaznu ivicu
-          state_fl_ch4 = 1;
-          break;
-      }
-      
-      /* Hvatanje silazne ivice. */
-      case 1:
-        
-          measured_time_fl_falling_ch4 = TIM_GetCapture4( TIM4 );
-          TIM_OC4PolarityConfig( TIM4, TIM_ICPolarity_Rising );  // sada hvatamo uzlaznu ivicu
-          state_fl_ch4 = 0;
-          
-          /* Racunanje udaljenosti objekta od senzora. */
-          if( measured_time_fl_falling_ch4 > measured_time_fl_rising_ch4 )
-               measured_time_fl_ch4 = measured_time_fl_falling_ch4 - measured_time_fl_rising_ch4;
-          else measured_time_fl_ch4 = ECHO_TIMER_PERIOD - measured_time_fl_rising_ch4 + measured_time_fl_falling_ch4;
-          
-          /* Novu izmerenu vrednost dodajemo u niz. */
-          measured_distance_fl_ch4[ ( index_ch4++ ) % MEASUREMENT_NUM ] =  measured_time_fl_ch4; 
-          
-          /* Provera da li smo prosli prvih par losih merenja. */
-          if ( index_ch4 > MEASUREMENT_NUM ) bad_measurement_end_ch4 = TRUE;
-          
-          /* Ako smo prosli prvih par losih merenja, mozemo da racunamo udaljenost od objekta. */
-          if ( bad_measurement_end_ch4 )
-          {
-            int temp_distance = 0;
-            for ( int j = 0; j < MEASUREMENT_NUM; j++ ) temp_distance += measured_distance_fl_ch4[ j ];
-            distance_fl_ch4 = temp_distance / MEASUREMENT_NUM;
-            distance_fl_ch4 /= CONST_MICRO_SEC_TO_MM;
-          }
-          else
-          {
-            distance_fl_ch4 = measured_distance_fl_ch4[ index_ch4 ] / CONST_MICRO_SEC_TO_MM;
-          }
-          
-          break;
-          
-          
-       default:
-        
-          break; 
-    }
+    FLAG_obstacleDetected = FALSE;
+    motion_hold = 0;
   }
   
-  
-  /* Provera da li je detektovana prepreka i da li treba stati posle svakog novog merenja. */
-  stopIfObstacle();
-  
+  maximum_speed_X = limit;
+  maximum_speed_Y = limit;
+  return FLAG_obstacleDetected;
+}
+/*----------------------------------------------------------------------------*/
+
+/**
+  * @brief  Zone usporavanja sa nominalnom brzinom jednakom pocetnoj
+  *         vrednosti maximum_speed_X. Poziva se iz main() pre pokretanja
+  *         SysTick-a.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema izlaznih argumenata.
+  */
+void ObstacleTaskInit( void )
+{
+  ObstacleZoneInit( &obstacle_zone, maximum_speed_X );
+}
+/*----------------------------------------------------------------------------*/
+
+/**
+  * @brief  Zadatak reakcije na prepreku, poziva se iz SysTick-a. Bira grupe
+  *         senzora koje se okidaju, obradjuje merenja koja je TIM4 prekid
+  *         stavio u red i ogranicava brzinu prema najblizoj prepreci.
+  *         TIM2/TIM7 koji citaju ogranicenje brzine mogu da prekinu ovaj
+  *         zadatak, ali svaki cita samo svoju osu, a upis bajta je atomski.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema izlaznih argumenata.
+  */
+static void ObstacleTask( void )
+{
+  /* Pri kretanju se okidaju samo senzori koji se gledaju, inace obe grupe naizmenicno. */
+  if ( FLAG_sensorEnable && FLAG_sensorFrontEnable ) UltrasoundService( US_GROUP_MASK( US_GROUP_FRONT ) );
+  else if ( FLAG_sensorEnable && FLAG_sensorBackEnable ) UltrasoundService( US_GROUP_MASK( US_GROUP_BACK ) );
+  else UltrasoundService( US_GROUPS_ALL );
+
+  UltrasoundProcess();
+  slowDownIfObstacle();
+  GridTask();
+}
+/*----------------------------------------------------------------------------*/
+
+/**
+  * @brief  Azurira mrezu zauzetosti: poza iz calculatePosition(), zrak za
+  *         svaki senzor sa novim merenjem i ograniceni broj koraka zraka i
+  *         starenja celija. Poziva se iz ObstacleTask(), svakih 10 ms.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema izlaznih argumenata.
+  */
+static void GridTask( void )
+{
+  static float last_theta = 1.0f;
+  static int16_t sin_q14 = 0, cos_q14 = OG_Q14;
+  uint8_t i;
+
+  /* sin i cos samo kada se ugao promeni. */
+  if ( abs_Theta != last_theta )
+  {
+    last_theta = abs_Theta;
+    sin_q14 = (int16_t)( sin( last_theta * PI / 180 ) * OG_Q14 );
+    cos_q14 = (int16_t)( cos( last_theta * PI / 180 ) * OG_Q14 );
+  }
+  OgSetPose( (int16_t)( abs_X * 100 / COUNTS_PER_100MM ), (int16_t)( abs_Y * 100 / COUNTS_PER_100MM ),
+             sin_q14, cos_q14 );
+
+  for ( i = 0; i < US_NUM; i++ )
+  {
+    if ( !ultrasound[ i ].fresh ) continue;
+    ultrasound[ i ].fresh = 0;
+    OgAddReading( i, &us_mount[ i ], ultrasound[ i ].distance_mm,
+                  ultrasound[ i ].filter.status == US_ECHO_VALID );
+  }
+  OgStep();
+}
+/*----------------------------------------------------------------------------*/
+
+/**
+  * @brief  Prekidna rutina tajmera 4. Hvatanje ivica echo signala
+  *         ultrazvucnih senzora, obrada je u ObstacleTask().
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema izlaznih argumenata.
+  * @author Milica Stojiljkovic
+  */
+void TIM4_IRQHandler( void )
+{
+  ISR_PROFILE_ENTER();
+  UltrasoundCapture( TIM4 );
+  ISR_PROFILE_EXIT( ISR_ID_TIM4 );
+}
+/*----------------------------------------------------------------------------*/
+
+/**
+  * @brief  Prekidna rutina tajmera 3. Pocetak i kraj trigger impulsa
+  *         ultrazvucnih senzora.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema izlaznih argumenata.
+  */
+void TIM3_IRQHandler( void )
+{
+  ISR_PROFILE_ENTER();
+  UltrasoundTrigger( TIM3 );
+  ISR_PROFILE_EXIT( ISR_ID_TIM3 );
 }
 /******************************************************************************/
 /*            STM32F10x Peripherals Interrupt Handlers                        */
@@ -1555,6 +1650,7 @@ void TIM4_IRQHandler( void )
   */
 void TIM6_DAC_IRQHandler( void )
 {
+  ISR_PROFILE_ENTER();
   /* Provera da li je stigao zahtev za prekid od kanala 1. Senzor nazad, levo. */
   if ( TIM_GetITStatus( TIM6, TIM_IT_Update ) == SET )
   {
@@ -1563,6 +1659,7 @@ void TIM6_DAC_IRQHandler( void )
     else cnt_90++;
 
   }
+  ISR_PROFILE_EXIT( ISR_ID_TIM6 );
 }
 /******************************************************************************/
 
@@ -0,0 +1,192 @@
+/**
+*   @file:    trace_recorder.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Snimanje signala regulatora u data_log, videti trace_recorder.h.
+*/
+
+#include "stm32f10x.h"
+#include "variables.h"
+#include "trace_recorder.h"
+#include "EUROBOT_Init.h"
+#include "isr_profiler.h"
+
+uint16_t data_log[DATA_LOG_SIZE];
+int pwm_motor1 = 0, pwm_motor2 = 0;
+
+static uint8_t trace_channels = TRACE_CH_SETPOINT_X | TRACE_CH_ENC1 | TRACE_CH_PWM1 | TRACE_CH_ERROR_X;
+static uint8_t trace_triggers = TRACE_TRIG_MANUAL | TRACE_TRIG_OBSTACLE | TRACE_TRIG_PID_SATURATION;
+static uint16_t trace_decimation = 1;
+static uint16_t trace_pre = 0;
+
+static volatile uint8_t trace_state = TRACE_IDLE;
+static uint8_t trace_width;             // Broj reci u jednom zapisu.
+static uint16_t trace_capacity;         // Broj zapisa koji staje u bafer.
+static uint16_t trace_write;            // Indeks sledeceg zapisa.
+static uint16_t trace_filled;           // Broj upisanih zapisa (najvise trace_capacity).
+static uint16_t trace_post_left;        // Koliko zapisa jos treba posle dogadjaja.
+static uint16_t trace_trigger_record;   // Polozaj dogadjaja u hronoloskom redu.
+static uint8_t trace_trigger_event;
+static uint16_t trace_tick;
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  TIM15 na 1 ms (24 MHz / 24 / 1000). Prioritet je isti kao SysTick
+  *         (najnizi) i nizi od USART3 prekida, snimanje ne sme da kasni
+  *         regulaciju. Pri istom prioritetu SysTick ima prednost jer ima
+  *         manji broj izuzetka.
+  *         LogerInit() je koristio TIM3, koji sada generise trigger za
+  *         ultrazvucne senzore.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void TraceInit( void )
+{
+  RCC_APB2PeriphClockCmd( RCC_APB2Periph_TIM15, ENABLE );
+  InitTIM_TimeBase( TIM15, 24 - 1, 1000 - 1, TIM_CounterMode_Up, TIM_CKD_DIV1, 0x00 );
+  TIM_ITConfig( TIM15, TIM_IT_Update, ENABLE );
+  InitNVICChannel( TIM1_BRK_TIM15_IRQn, 0x0F, 0x0F, ENABLE );
+  /* Bez NVIC_PriorityGroupConfig NVIC_Init upisuje prioritet 0, pa se
+     prioritet upisuje direktno, kao za DMA1_Channel7 u LogInit(). */
+  NVIC_SetPriority( TIM1_BRK_TIM15_IRQn, 0x0F );
+  TIM_Cmd( TIM15, ENABLE );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Menja podesavanja i zaustavlja snimanje u toku.
+  * @param  channels: maska TRACE_CH_*, 0 zadrzava prethodne kanale.
+  * @param  triggers: maska TRACE_TRIG_* koji pokrecu snimanje posle dogadjaja.
+  * @param  decimation: snima se svaki decimation-ti tick od 1 ms.
+  * @param  pre_records: broj zapisa pre dogadjaja, ogranicava se na velicinu bafera.
+  * @retval Nema povratnih vrednosti.
+  */
+void TraceConfigure( uint8_t channels, uint8_t triggers, uint16_t decimation, uint16_t pre_records )
+{
+  trace_state = TRACE_IDLE;
+  if ( channels ) trace_channels = channels;
+  trace_triggers = triggers;
+  trace_decimation = decimation ? decimation : 1;
+  trace_pre = pre_records;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Racuna velicinu zapisa i krece sa snimanjem u krug.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void TraceArm( void )
+{
+  uint8_t mask;
+
+  trace_state = TRACE_IDLE;
+  trace_width = 0;
+  for ( mask = trace_channels; mask; mask >>= 1 ) trace_width += mask & 1;
+  trace_capacity = DATA_LOG_SIZE / trace_width;
+  if ( trace_pre > trace_capacity ) trace_pre = trace_capacity;
+  trace_write = 0;
+  trace_filled = 0;
+  trace_trigger_record = 0;
+  trace_trigger_event = 0;
+  trace_tick = 0;
+  trace_state = TRACE_ARMED;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Prvi dogadjaj iz maske prebacuje snimanje u TRACE_TRIGGERED. Ostaje
+  *         jos onoliko zapisa koliko treba da bafer bude pun, a najvise
+  *         trace_pre zapisa ostaje od pre dogadjaja.
+  * @param  event: jedan od TRACE_TRIG_*.
+  * @retval Nema povratnih vrednosti.
+  */
+void TraceTrigger( uint8_t event )
+{
+  uint16_t pre;
+
+  if ( trace_state != TRACE_ARMED || !( trace_triggers & event ) ) return;
+  __disable_irq();
+  pre = trace_filled < trace_pre ? trace_filled : trace_pre;
+  trace_trigger_record = pre;
+  trace_post_left = trace_capacity - pre;
+  trace_trigger_event = event;
+  trace_state = TRACE_TRIGGERED;
+  __enable_irq();
+}
+/*----------------------------------------------------------------------------*/
+static void WriteRecord( void )
+{
+  uint16_t *rec = &data_log[ trace_write * trace_width ];
+  uint8_t ch = trace_channels;
+
+  if ( ch & TRACE_CH_SETPOINT_X ) *rec++ = trenutna_pozicija_X;
+  if ( ch & TRACE_CH_SETPOINT_Y ) *rec++ = trenutna_pozicija_Y;
+  if ( ch & TRACE_CH_ENC1 )       *rec++ = ENC1;
+  if ( ch & TRACE_CH_ENC2 )       *rec++ = ENC2;
+  if ( ch & TRACE_CH_PWM1 )       *rec++ = pwm_motor1;
+  if ( ch & TRACE_CH_PWM2 )       *rec++ = pwm_motor2;
+  if ( ch & TRACE_CH_ERROR_X )    *rec++ = greska_pracenja_X;
+  if ( ch & TRACE_CH_ERROR_Y )    *rec++ = greska_pracenja_Y;
+
+  if ( ++trace_write == trace_capacity ) trace_write = 0;
+  if ( trace_filled < trace_capacity ) trace_filled++;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Prekidna rutina TIM15, jedan tick od 1 ms.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void TIM1_BRK_TIM15_IRQHandler( void )
+{
+  ISR_PROFILE_ENTER();
+  TIM_ClearITPendingBit( TIM15, TIM_IT_Update );
+  if ( ( trace_state == TRACE_ARMED || trace_state == TRACE_TRIGGERED ) && ++trace_tick >= trace_decimation )
+  {
+    trace_tick = 0;
+    WriteRecord();
+    if ( trace_state == TRACE_TRIGGERED && --trace_post_left == 0 ) trace_state = TRACE_DONE;
+  }
+  ISR_PROFILE_EXIT( ISR_ID_TIM15 );
+}
+/*----------------------------------------------------------------------------*/
+static void Reverse( uint16_t *first, uint16_t *last )
+{
+  while ( first < last )
+  {
+    uint16_t tmp = *first;
+    *first++ = *last;
+    *last-- = tmp;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Kada je snimanje gotovo, bafer se rotira na mestu (tri obrtanja)
+  *         tako da najstariji zapis bude na pocetku data_log-a. Ovo traje
+  *         oko 1 ms pa se radi van prekida.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+void TraceService( void )
+{
+  uint16_t words, split;
+
+  if ( trace_state != TRACE_DONE || trace_write == 0 ) return;
+  words = trace_filled * trace_width;
+  split = trace_write * trace_width;
+  Reverse( data_log, data_log + split - 1 );
+  Reverse( data_log + split, data_log + words - 1 );
+  Reverse( data_log, data_log + words - 1 );
+  trace_write = 0;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t TraceState( void )
+{
+  /* Dok rotacija nije gotova host ne treba da cita bafer. */
+  if ( trace_state == TRACE_DONE && trace_write != 0 ) return TRACE_TRIGGERED;
+  return trace_state;
+}
+
+uint8_t TraceChannels( void ) { return trace_channels; }
+uint16_t TraceRecords( void ) { return trace_filled; }
+uint16_t TraceTriggerRecord( void ) { return trace_trigger_record; }
+uint8_t TraceTriggerEvent( void ) { return trace_trigger_event; }
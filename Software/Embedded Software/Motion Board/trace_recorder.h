@@ -0,0 +1,64 @@
+/**
+*   @file:    trace_recorder.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Snimanje izabranih signala regulatora u data_log na svaku
+*             milisekundu (TIM15), sa decimacijom i snimanjem pre i posle
+*             dogadjaja (zaustavljanje zbog prepreke, zasicenje PID-a,
+*             rucni trigger). Jedan zapis ima po jednu 16-bitnu rec za svaki
+*             izabrani kanal, redom po bitovima maske.
+*/
+
+#ifndef __TRACE_RECORDER_H__
+#define __TRACE_RECORDER_H__
+
+#include "stm32f10x.h"
+
+/* Velicina bafera u 16-bitnim recima (2 KB, isto kao ranije int[512]). */
+#define DATA_LOG_SIZE 1024
+
+/* Kanali, bit u maski. */
+#define TRACE_CH_SETPOINT_X  0x01  // trenutna_pozicija_X, izlaz generatora profila.
+#define TRACE_CH_SETPOINT_Y  0x02  // trenutna_pozicija_Y.
+#define TRACE_CH_ENC1        0x04
+#define TRACE_CH_ENC2        0x08
+#define TRACE_CH_PWM1        0x10  // Izlaz PID1 sa znakom, -990..990.
+#define TRACE_CH_PWM2        0x20  // Izlaz PID2 sa znakom.
+#define TRACE_CH_ERROR_X     0x40  // greska_pracenja_X.
+#define TRACE_CH_ERROR_Y     0x80  // greska_pracenja_Y.
+
+/* Dogadjaji koji mogu da okinu snimanje. */
+#define TRACE_TRIG_MANUAL         0x01
+#define TRACE_TRIG_OBSTACLE       0x02
+#define TRACE_TRIG_PID_SATURATION 0x04
+
+/* Stanja snimanja. */
+#define TRACE_IDLE      0   // Ne snima se.
+#define TRACE_ARMED     1   // Snima se u krug i ceka se dogadjaj.
+#define TRACE_TRIGGERED 2   // Dogadjaj se desio, snima se ostatak bafera.
+#define TRACE_DONE      3   // Bafer je pun, zapisi su poredjani hronoloski.
+
+extern uint16_t data_log[DATA_LOG_SIZE];
+/* Izlazi PID1/PID2 iz SysTick prekida. */
+extern int pwm_motor1, pwm_motor2;
+
+/* Inicijalizacija TIM15 na 1 ms. */
+void TraceInit( void );
+/* Izbor kanala, dogadjaja, decimacije i broja zapisa pre dogadjaja. */
+void TraceConfigure( uint8_t channels, uint8_t triggers, uint16_t decimation, uint16_t pre_records );
+/* Pocetak snimanja. */
+void TraceArm( void );
+/* Prijava dogadjaja, poziva se i iz prekida. */
+void TraceTrigger( uint8_t event );
+/* Posao koji ne mora u prekidu, poziva se iz glavne petlje. */
+void TraceService( void );
+
+/* Stanje za citanje preko RS485. */
+uint8_t TraceState( void );
+uint8_t TraceChannels( void );
+uint16_t TraceRecords( void );
+uint16_t TraceTriggerRecord( void );
+uint8_t TraceTriggerEvent( void );
+
+#endif
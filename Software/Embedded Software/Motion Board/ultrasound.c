@@ -0,0 +1,332 @@
+/**
+*   @file:    ultrasound.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Drajver ultrazvucnih senzora, videti ultrasound.h.
+*/
+
+#include "stm32f10x.h"
+#include "EUROBOT_Init.h"
+#include "ultrasound.h"
+#include "debug_log.h"
+
+/* Redosled mora da prati enum iz ultrasound.h. */
+static const UltrasoundConfigType us_config[ US_NUM ] =
+{
+  US_CHANNEL( TIM4, 1, US_GROUP_BACK ),    // US_BACK_LEFT
+  US_CHANNEL( TIM4, 2, US_GROUP_BACK ),    // US_BACK_RIGHT
+  US_CHANNEL( TIM4, 3, US_GROUP_FRONT ),   // US_FRONT_RIGHT
+  US_CHANNEL( TIM4, 4, US_GROUP_FRONT ),   // US_FRONT_LEFT
+};
+
+/* Redosled mora da prati US_GROUP_* iz ultrasound.h. */
+static const UltrasoundTriggerType us_trigger[ US_GROUPS ] =
+{
+  US_TRIGGER( TIM3, 3 ),           // US_GROUP_BACK
+  US_TRIGGER( TIM3, 4 ),           // US_GROUP_FRONT
+};
+
+/* Stanje pinga. */
+enum
+{
+  US_PING_WAIT,                    // Trigger je zadat za trenutak u CCR.
+  US_PING_PULSE,                   // Trigger impuls traje.
+  US_PING_ECHO                     // Ceka se kraj echo signala grupe.
+};
+
+UltrasoundChannelType ultrasound[ US_NUM ];
+volatile uint16_t us_queue_dropped = 0;
+
+/* Red sa jednim proizvodjacem (prekid tajmera) i jednim potrosacem (SysTick).
+   Glavu menja samo proizvodjac, rep samo potrosac, pa zabrana prekida nije
+   potrebna. */
+static UltrasoundSampleType us_queue[ US_QUEUE_SIZE ];
+static volatile uint8_t us_queue_head = 0;
+static volatile uint8_t us_queue_tail = 0;
+
+volatile uint16_t us_pings[ US_GROUPS ];
+
+/* Stanje trigger-a menjaju TIM3 i TIM4 prekidi (isti prioritet) i
+   UltrasoundService() sa zabranjenim prekidima. */
+static uint8_t us_groups = US_GROUPS_ALL;
+static uint8_t us_group = 0;       // Grupa trenutnog pinga.
+static uint8_t us_ping = US_PING_WAIT;
+static uint8_t us_pending = 0;     // Senzori grupe ciji echo jos nije zavrsen.
+static uint16_t us_fire_tick = 0;  // Pocetak trenutnog pinga, TIM3 koraci.
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Menja OCxM bite kanala bez gasenja izlaza (TIM_SelectOCxM gasi
+  *         CCxE, pa bi skratio impuls koji traje).
+  * @param  trg predstavlja trigger kanal.
+  * @param  mode predstavlja TIM_OCMode_Active, TIM_OCMode_Inactive ili
+  *         TIM_ForcedAction_InActive.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UltrasoundOCMode( const UltrasoundTriggerType *trg, uint16_t mode )
+{
+  __IO uint16_t *ccmr = trg->channel < TIM_Channel_3 ? &trg->timer->CCMR1 : &trg->timer->CCMR2;
+  uint16_t shift = ( trg->channel & TIM_Channel_2 ) ? 8 : 0;
+
+  *ccmr = ( *ccmr & ~( TIM_CCMR1_OC1M << shift ) ) | ( mode << shift );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Bira sledecu grupu iz us_groups i zadaje njen trigger za trenutak
+  *         at. Impuls pocinje i zavrsava se poredjenjem u hardveru, prekid
+  *         samo pomera CCR i menja mod.
+  * @param  at predstavlja trenutak pocetka impulsa u koracima tajmera.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UltrasoundFire( uint16_t at )
+{
+  const UltrasoundTriggerType *trg;
+  uint8_t i, g = us_group;
+
+  for ( i = 0; i < US_GROUPS; i++ )
+  {
+    if ( ++g == US_GROUPS ) g = 0;
+    if ( us_groups & US_GROUP_MASK( g ) ) break;
+  }
+  us_group = g;
+  us_pending = 0;
+  for ( i = 0; i < US_NUM; i++ )
+    if ( us_config[ i ].group == g ) us_pending |= 1 << i;
+
+  trg = &us_trigger[ g ];
+  us_ping = US_PING_WAIT;
+  UltrasoundOCMode( trg, TIM_OCMode_Active );
+  *trg->ccr = at;
+  TIM_ClearITPendingBit( trg->timer, trg->it );
+  TIM_ITConfig( trg->timer, trg->it, ENABLE );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Kraj pinga: sledeci posle US_GUARD_TICKS, ali ne pre
+  *         US_MIN_CYCLE_TICKS od pocetka ovog.
+  * @param  Nema ulaznih argumenata.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UltrasoundPingDone( void )
+{
+  uint16_t at = us_trigger[ us_group ].timer->CNT + US_GUARD_TICKS;
+  uint16_t earliest = us_fire_tick + US_MIN_CYCLE_TICKS;
+
+  if ( (int16_t)( earliest - at ) > 0 ) at = earliest;
+  UltrasoundFire( at );
+}
+/*----------------------------------------------------------------------------*/
+void UltrasoundInit( void )
+{
+  uint8_t i;
+
+  for ( i = 0; i < US_NUM; i++ )
+  {
+    UltrasoundChannelType *ch = &ultrasound[ i ];
+
+    ch->falling = FALSE;
+    UsFilterInit( &ch->filter, US_FILTER_N, US_FILTER_MODE );
+    ch->distance_mm = US_NO_DATA;
+    RangeRateReset( &ch->rate );
+    ch->age = 255;
+
+    InitTIM_IC( us_config[ i ].timer, us_config[ i ].channel, TIM_ICSelection_DirectTI, TIM_ICPSC_DIV1, 0x00, TIM_ICPolarity_Rising );
+    TIM_ITConfig( us_config[ i ].timer, us_config[ i ].it, ENABLE );
+  }
+  us_queue_head = us_queue_tail = 0;
+  us_queue_dropped = 0;
+
+  for ( i = 0; i < US_GROUPS; i++ )
+  {
+    InitTIM_OC( us_trigger[ i ].timer, us_trigger[ i ].channel, TIM_OutputState_Enable, TIM_OCMode_Inactive, 0, TIM_OCPolarity_High );
+    us_pings[ i ] = 0;
+  }
+  us_groups = US_GROUPS_ALL;
+  us_group = US_GROUPS - 1;
+  us_fire_tick = us_trigger[ 0 ].timer->CNT - US_MIN_CYCLE_TICKS;
+  UltrasoundFire( us_trigger[ 0 ].timer->CNT + US_GUARD_TICKS );
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Propusta trajanje echo signala kroz filtar kanala i azurira
+  *         udaljenost. Ispravno merenje azurira i procenu brzine
+  *         priblizavanja, a merenje bez odjeka se za nju preskace. Vreme
+  *         izmedju merenja je razlika pocetaka pingova, a posle pauze duze
+  *         od US_RATE_MAX_AGE procena pocinje iz pocetka.
+  * @param  ch predstavlja kanal.
+  * @param  width predstavlja trajanje echo signala u us.
+  * @param  tick predstavlja pocetak pinga u koracima TIM3.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UltrasoundAddSample( UltrasoundChannelType *ch, uint16_t width, uint16_t tick )
+{
+  ch->distance_mm = ( uint16_t )( (uint32_t)UsFilterAdd( &ch->filter, width ) * 10 / US_TENTH_US_PER_MM );
+  ch->fresh = 1;
+
+  if ( ch->filter.status != US_ECHO_VALID ) return;
+  if ( ch->age > US_RATE_MAX_AGE ) RangeRateReset( &ch->rate );
+  RangeRateUpdate( &ch->rate, ( uint16_t )( (uint32_t)width * 10 / US_TENTH_US_PER_MM ),
+                   (uint16_t)( tick - ch->last_tick ) / US_TICKS_PER_100US );
+  ch->last_tick = tick;
+  ch->age = 0;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Stavlja merenje u red. Ako je red pun, merenje se odbacuje.
+  * @param  sensor predstavlja indeks senzora.
+  * @param  width predstavlja trajanje echo signala u us.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UltrasoundPost( uint8_t sensor, uint16_t width )
+{
+  uint8_t head = us_queue_head;
+  uint8_t next = ( head + 1 ) & ( US_QUEUE_SIZE - 1 );
+
+  if ( next == us_queue_tail )
+  {
+    us_queue_dropped++;
+    return;
+  }
+  us_queue[ head ].sensor = sensor;
+  us_queue[ head ].width = width;
+  us_queue[ head ].tick = us_fire_tick;
+  us_queue_head = next;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Za svaki kanal tajmera sa zahtevom za prekid cita uhvacenu
+  *         vrednost i okrece polaritet za sledecu ivicu. Na silaznoj ivici
+  *         racuna trajanje echo signala, uzimajuci u obzir prelazak brojaca
+  *         preko periode tajmera, i salje ga u red.
+  * @param  timer predstavlja tajmer ciji je prekid stigao.
+  * @retval Nema povratnih vrednosti.
+  */
+void UltrasoundCapture( TIM_TypeDef *timer )
+{
+  uint8_t i;
+
+  for ( i = 0; i < US_NUM; i++ )
+  {
+    const UltrasoundConfigType *cfg = &us_config[ i ];
+    UltrasoundChannelType *ch = &ultrasound[ i ];
+    uint16_t capture, width;
+
+    if ( cfg->timer != timer || TIM_GetITStatus( timer, cfg->it ) != SET ) continue;
+    TIM_ClearITPendingBit( timer, cfg->it );
+
+    capture = *cfg->ccr;
+    timer->CCER ^= cfg->polarity;
+
+    /* Uzlazna ivica, sada hvatamo silaznu. */
+    if ( !ch->falling )
+    {
+      ch->rising = capture;
+      ch->falling = TRUE;
+      continue;
+    }
+
+    /* Silazna ivica, sada hvatamo uzlaznu. */
+    ch->falling = FALSE;
+    if ( capture >= ch->rising ) width = capture - ch->rising;
+    else width = timer->ARR + 1 - ch->rising + capture;
+    UltrasoundPost( i, width );
+
+    /* Kada se zavrse echo signali cele grupe, odmah se zadaje sledeci ping. */
+    if ( us_ping == US_PING_ECHO && ( us_pending & ( 1 << i ) ) )
+    {
+      us_pending &= ~( 1 << i );
+      if ( us_pending == 0 ) UltrasoundPingDone();
+    }
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Poredjenje na trigger kanalu: na pocetku impulsa pamti trenutak
+  *         pinga i zadaje kraj impulsa, na kraju gasi prekid kanala.
+  * @param  timer predstavlja tajmer ciji je prekid stigao.
+  * @retval Nema povratnih vrednosti.
+  */
+void UltrasoundTrigger( TIM_TypeDef *timer )
+{
+  const UltrasoundTriggerType *trg = &us_trigger[ us_group ];
+
+  if ( trg->timer != timer || TIM_GetITStatus( timer, trg->it ) != SET ) return;
+  TIM_ClearITPendingBit( timer, trg->it );
+
+  if ( us_ping == US_PING_WAIT )
+  {
+    us_fire_tick = *trg->ccr;
+    *trg->ccr = us_fire_tick + US_TRIGGER_TICKS;
+    UltrasoundOCMode( trg, TIM_OCMode_Inactive );
+    us_ping = US_PING_PULSE;
+    us_pings[ us_group ]++;
+    /* Prekid je kasnio vise od US_TRIGGER_TICKS (svi kanali NVIC-a imaju
+       isti prioritet), poredjenje za kraj impulsa bi stiglo tek posle
+       okretanja brojaca. Impuls je vec dovoljno dug, gasi se odmah. */
+    if ( (int16_t)( timer->CNT - *trg->ccr ) >= 0 )
+    {
+      UltrasoundOCMode( trg, TIM_ForcedAction_InActive );
+      TIM_ITConfig( timer, trg->it, DISABLE );
+      us_ping = US_PING_ECHO;
+    }
+  }
+  else
+  {
+    TIM_ITConfig( timer, trg->it, DISABLE );
+    us_ping = US_PING_ECHO;
+  }
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Pamti grupe za sledece pingove. Ako echo neke grupe nema silaznu
+  *         ivicu (senzor nije povezan) ili kraj trigger impulsa nije stigao,
+  *         ping se zavrsava posle US_CYCLE_TIMEOUT_TICKS da se ostale grupe
+  *         ne bi zaustavile. Prvi takav ping svake grupe se upisuje u log.
+  * @param  groups predstavlja masku grupa, 0 znaci sve grupe.
+  * @retval Nema povratnih vrednosti.
+  */
+void UltrasoundService( uint8_t groups )
+{
+  static uint8_t logged = 0;
+  uint16_t now;
+  int8_t timeout = -1;
+
+  __disable_irq();
+  us_groups = groups ? groups : US_GROUPS_ALL;
+  now = us_trigger[ us_group ].timer->CNT;
+  if ( us_ping != US_PING_WAIT && (uint16_t)( now - us_fire_tick ) >= US_CYCLE_TIMEOUT_TICKS )
+  {
+    const UltrasoundTriggerType *trg = &us_trigger[ us_group ];
+
+    /* Trigger koji je ostao aktivan se gasi pre sledeceg pinga. */
+    UltrasoundOCMode( trg, TIM_ForcedAction_InActive );
+    TIM_ITConfig( trg->timer, trg->it, DISABLE );
+    timeout = us_group;
+    UltrasoundPingDone();
+  }
+  __enable_irq();
+  if ( timeout >= 0 && !( logged & US_GROUP_MASK( timeout ) ) )
+  {
+    logged |= US_GROUP_MASK( timeout );
+    LOG_WARN( "UZ grupa %d bez kraja pinga", timeout );
+  }
+}
+/*----------------------------------------------------------------------------*/
+uint8_t UltrasoundProcess( void )
+{
+  uint8_t tail = us_queue_tail;
+  uint8_t n = 0, i;
+
+  for ( i = 0; i < US_NUM; i++ )
+    if ( ultrasound[ i ].age < 255 ) ultrasound[ i ].age++;
+  while ( tail != us_queue_head )
+  {
+    UltrasoundAddSample( &ultrasound[ us_queue[ tail ].sensor ], us_queue[ tail ].width, us_queue[ tail ].tick );
+    tail = ( tail + 1 ) & ( US_QUEUE_SIZE - 1 );
+    n++;
+  }
+  us_queue_tail = tail;
+  return n;
+}
+/*----------------------------------------------------------------------------*/
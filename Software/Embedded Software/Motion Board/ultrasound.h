@@ -0,0 +1,141 @@
+/**
+*   @file:    ultrasound.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Drajver ultrazvucnih senzora HC-SR04. Svaki senzor je jedan
+*             kanal za hvatanje (input capture) nekog tajmera, opisan jednim
+*             redom tabele u ultrasound.c, a stanje svih senzora je u nizu
+*             ultrasound[]. Prekidna rutina tajmera samo poziva
+*             UltrasoundCapture( TIMx ), koja obradi sve kanale tog tajmera i
+*             trajanje svakog echo signala stavi u red. Red prazni
+*             UltrasoundProcess() iz zadatka reakcije na prepreku u SysTick-u.
+*             Merenja prolaze kroz filtar iz ultrasound_filter.h (medijana ili
+*             Hampel nad poslednjih US_FILTER_N merenja), a udaljenost se cuva
+*             u celim milimetrima.
+*
+*             Trigger: senzori su u grupama sa zajednickim trigger pinom
+*             (kanal TIM3 u output compare modu, korak 5 us). U vazduhu je
+*             uvek samo jedan ping, pa se senzori razlicitih grupa ne cuju
+*             medjusobno. Sledeci ping se zadaje cim se zavrse echo signali
+*             svih senzora grupe, posle US_GUARD_TICKS, ali ne pre
+*             US_MIN_CYCLE_TICKS od prethodnog (60 ms, najkraci ciklus
+*             merenja iz HC-SR04 datasheet-a), da se zakasneli odjeci
+*             prethodnog pinga ne izmere kao novi. Okidaju se samo grupe koje zada UltrasoundService() (na
+*             primer samo prednja pri kretanju napred), naizmenicno.
+*
+*             Novi senzor: red u enum-u i u tabeli, pin, i za tajmer koji jos
+*             nema senzore NVIC kanal i prekidna rutina sa
+*             UltrasoundCapture(). Na ploci kretanja TIM3 CH3/CH4 generisu
+*             trigger, pa su za jos cetiri senzora (kao u
+*             Misc/ultrazvucni_senzori_za_robota) slobodni TIM3 CH1/CH2 i
+*             kanali nekog drugog tajmera.
+*/
+
+#ifndef __ULTRASOUND_H__
+#define __ULTRASOUND_H__
+
+#include "stm32f10x.h"
+#include "ultrasound_filter.h"
+#include "range_rate.h"
+
+/* Senzori, indeksi u ultrasound[]. */
+enum
+{
+  US_BACK_LEFT,       // TIM4 CH1 - PB6.
+  US_BACK_RIGHT,      // TIM4 CH2 - PB7.
+  US_FRONT_RIGHT,     // TIM4 CH3 - PB8.
+  US_FRONT_LEFT,      // TIM4 CH4 - PB9.
+  US_NUM
+};
+
+/* Grupe senzora sa zajednickim trigger-om, indeksi u us_trigger[]. */
+enum
+{
+  US_GROUP_BACK,      // TIM3 CH3 - PB0.
+  US_GROUP_FRONT,     // TIM3 CH4 - PB1.
+  US_GROUPS
+};
+
+#define US_GROUP_MASK( g )      ( 1 << ( g ) )
+#define US_GROUPS_ALL           ( US_GROUP_MASK( US_GROUP_BACK ) | US_GROUP_MASK( US_GROUP_FRONT ) )
+
+/* Vremena trigger-a u koracima TIM3 od 5 us. */
+#define US_TRIGGER_TICKS        3       // 15 us, HC-SR04 trazi najmanje 10 us.
+#define US_GUARD_TICKS          1000    // 5 ms posle poslednjeg echo signala grupe.
+#define US_MIN_CYCLE_TICKS      12000   // 60 ms izmedju pingova, HC-SR04 datasheet.
+#define US_CYCLE_TIMEOUT_TICKS  10000   // 50 ms, echo bez silazne ivice.
+
+#define US_TENTH_US_PER_MM 58      // Echo traje 5.8 us po mm rastojanja.
+#define US_NO_DATA        0xFFFF   // Udaljenost pre prvog merenja.
+#define US_RATE_MAX_AGE   20       // 200 ms, TIM3 (5 us, 16 bita) se okrene za 327 ms.
+#define US_TICKS_PER_100US 20
+#define US_QUEUE_SIZE     16       // Stepen dvojke. Senzor daje merenje najcesce
+                                   // na 60 ms, a red se prazni svakih 10 ms.
+
+/* Kanal tajmera na koji je vezan echo senzora. */
+typedef struct
+{
+  TIM_TypeDef *timer;
+  __IO uint16_t *ccr;              // Registar sa uhvacenom vrednoscu brojaca.
+  uint16_t channel;                // TIM_Channel_x.
+  uint16_t it;                     // TIM_IT_CCx.
+  uint16_t polarity;               // CCxP bit u CCER, 1 za silaznu ivicu.
+  uint8_t group;                   // US_GROUP_*.
+} UltrasoundConfigType;
+
+#define US_CHANNEL( tim, n, group )  { tim, &tim->CCR##n, TIM_Channel_##n, TIM_IT_CC##n, TIM_CCER_CC##n##P, group }
+
+/* Kanal tajmera koji generise trigger grupe. */
+typedef struct
+{
+  TIM_TypeDef *timer;
+  __IO uint16_t *ccr;
+  uint16_t channel;                // TIM_Channel_x.
+  uint16_t it;                     // TIM_IT_CCx.
+} UltrasoundTriggerType;
+
+#define US_TRIGGER( tim, n )  { tim, &tim->CCR##n, TIM_Channel_##n, TIM_IT_CC##n }
+
+/* Merenje koje prekidna rutina salje zadatku. */
+typedef struct
+{
+  uint8_t sensor;
+  uint16_t width;                  // Trajanje echo signala u us.
+  uint16_t tick;                   // Pocetak pinga, TIM3 koraci.
+} UltrasoundSampleType;
+
+typedef struct
+{
+  uint16_t rising;                 // Trenutak uzlazne ivice.
+  bool falling;                    // TRUE kada se ceka silazna ivica.
+  UsFilterType filter;             // Prozor merenja i statistika klasa.
+  volatile uint16_t distance_mm;
+  volatile uint8_t fresh;          // 1 posle novog merenja, brise ga korisnik.
+  RangeRateType rate;              // Brzina priblizavanja iz ispravnih merenja.
+  uint16_t last_tick;              // Pocetak pinga poslednjeg ispravnog merenja.
+  uint8_t age;                     // Pozivi UltrasoundProcess() od poslednjeg ispravnog merenja.
+} UltrasoundChannelType;
+
+extern UltrasoundChannelType ultrasound[ US_NUM ];
+/* Merenja odbacena jer je red bio pun. */
+extern volatile uint16_t us_queue_dropped;
+/* Broj pingova po grupi. */
+extern volatile uint16_t us_pings[ US_GROUPS ];
+
+/* Podesava kanale iz tabele za hvatanje uzlazne ivice i trigger kanale i
+   ukljucuje njihove prekide, pa zadaje prvi ping. Vremensku bazu tajmera,
+   pinove i NVIC podesava InitUltrasoundHCSR04(). */
+void UltrasoundInit( void );
+/* Obradjuje sve kanale tajmera koji imaju zahtev za prekid, iz prekidne rutine. */
+void UltrasoundCapture( TIM_TypeDef *timer );
+/* Pocetak i kraj trigger impulsa, iz prekidne rutine tajmera trigger-a. */
+void UltrasoundTrigger( TIM_TypeDef *timer );
+/* Iz SysTick-a: grupe koje se okidaju (maska US_GROUP_MASK) i zadavanje
+   sledeceg pinga ako echo nije stigao za US_CYCLE_TIMEOUT_TICKS. */
+void UltrasoundService( uint8_t groups );
+/* Prazni red i azurira udaljenosti i brzine priblizavanja, van prekidne
+   rutine tajmera, svakih 10 ms. Vraca broj obradjenih merenja. */
+uint8_t UltrasoundProcess( void );
+
+#endif
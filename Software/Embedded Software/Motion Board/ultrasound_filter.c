@@ -0,0 +1,128 @@
+/**
+*   @file:    ultrasound_filter.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Filtar echo signala ultrazvucnog senzora, videti
+*             ultrasound_filter.h.
+*/
+
+#include "ultrasound_filter.h"
+
+/* Mreze za sortiranje sa najmanjim brojem poredjenja: 3, 9 i 16. */
+static const uint8_t us_net3[][2] = { {0,1}, {1,2}, {0,1} };
+static const uint8_t us_net5[][2] = { {0,3}, {1,4}, {0,2}, {1,3}, {0,1}, {2,4}, {1,2}, {3,4}, {2,3} };
+static const uint8_t us_net7[][2] = { {0,6}, {2,3}, {4,5}, {0,2}, {1,4}, {3,6}, {0,1}, {2,5},
+                                      {3,4}, {1,2}, {4,6}, {2,3}, {4,5}, {1,2}, {3,4}, {5,6} };
+
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Sortira n = 3, 5 ili 7 vrednosti u rastucem redosledu.
+  * @param  a predstavlja niz.
+  * @param  n predstavlja duzinu niza.
+  * @retval Nema povratnih vrednosti.
+  */
+static void UsSort( uint16_t *a, uint8_t n )
+{
+  const uint8_t ( *net )[2];
+  uint8_t k, len;
+
+  if ( n == 3 )      { net = us_net3; len = sizeof( us_net3 ) / 2; }
+  else if ( n == 5 ) { net = us_net5; len = sizeof( us_net5 ) / 2; }
+  else               { net = us_net7; len = sizeof( us_net7 ) / 2; }
+
+  for ( k = 0; k < len; k++ )
+  {
+    uint16_t x = a[ net[ k ][ 0 ] ], y = a[ net[ k ][ 1 ] ];
+    a[ net[ k ][ 0 ] ] = x < y ? x : y;
+    a[ net[ k ][ 1 ] ] = x < y ? y : x;
+  }
+}
+/*----------------------------------------------------------------------------*/
+void UsFilterInit( UsFilterType *f, uint8_t n, uint8_t mode )
+{
+  uint8_t k;
+
+  if ( n != 3 && n != 5 && n != 7 ) n = US_FILTER_N;
+  f->n = n;
+  f->mode = mode;
+  f->index = 0;
+  f->filled = 0;
+  f->sum = 0;
+  f->status = US_ECHO_TIMEOUT;
+  f->rejected = 0;
+  for ( k = 0; k < US_FILTER_MAX_N; k++ ) f->window[ k ] = 0;
+  for ( k = 0; k < US_ECHO_CLASSES; k++ ) f->class_count[ k ] = 0;
+}
+/*----------------------------------------------------------------------------*/
+uint8_t UsClassify( uint16_t width )
+{
+  if ( width < US_MIN_US ) return US_ECHO_NEAR;
+  if ( width >= US_TIMEOUT_US ) return US_ECHO_TIMEOUT;
+  if ( width > US_MAX_US ) return US_ECHO_FAR;
+  return US_ECHO_VALID;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Klasifikuje merenje, ogranicava ga na opseg senzora i dodaje u
+  *         prozor. Prvo merenje popunjava ceo prozor, pa filtar daje izlaz
+  *         od prvog merenja.
+  * @param  f predstavlja filtar.
+  * @param  width predstavlja trajanje echo signala u us.
+  * @retval Filtrirano trajanje echo signala u us.
+  */
+uint16_t UsFilterAdd( UsFilterType *f, uint16_t width )
+{
+  uint16_t sorted[ US_FILTER_MAX_N ], dev[ US_FILTER_MAX_N ];
+  uint16_t median, threshold;
+  uint32_t sum;
+  uint8_t k, newest;
+
+  f->status = UsClassify( width );
+  if ( f->class_count[ f->status ] < 0xFFFF ) f->class_count[ f->status ]++;
+  if ( width < US_MIN_US ) width = US_MIN_US;
+  if ( width > US_MAX_US ) width = US_MAX_US;
+
+  if ( !f->filled )
+  {
+    for ( k = 0; k < f->n; k++ ) f->window[ k ] = width;
+    f->sum = (uint32_t)width * f->n;
+    f->filled = 1;
+  }
+  else
+  {
+    f->sum -= f->window[ f->index ];
+    f->sum += width;
+    f->window[ f->index ] = width;
+  }
+  newest = f->index;
+  if ( ++f->index == f->n ) f->index = 0;
+
+  if ( f->mode == US_FILTER_MEAN ) return (uint16_t)( f->sum / f->n );
+
+  for ( k = 0; k < f->n; k++ ) sorted[ k ] = f->window[ k ];
+  UsSort( sorted, f->n );
+  median = sorted[ f->n / 2 ];
+  if ( f->mode == US_FILTER_MEDIAN ) return median;
+
+  /* Hampel: MAD je medijana apsolutnih odstupanja od medijane. */
+  for ( k = 0; k < f->n; k++ )
+    dev[ k ] = f->window[ k ] > median ? f->window[ k ] - median : median - f->window[ k ];
+  for ( k = 0; k < f->n; k++ ) sorted[ k ] = dev[ k ];
+  UsSort( sorted, f->n );
+  threshold = (uint16_t)( ( (uint32_t)sorted[ f->n / 2 ] * US_HAMPEL_K_X1000 ) / 1000 );
+  if ( threshold < US_HAMPEL_MIN_US ) threshold = US_HAMPEL_MIN_US;
+
+  sum = 0;
+  for ( k = 0; k < f->n; k++ )
+  {
+    if ( dev[ k ] > threshold )
+    {
+      sum += median;
+      if ( k == newest && f->rejected < 0xFFFF ) f->rejected++;
+    }
+    else sum += f->window[ k ];
+  }
+  return (uint16_t)( sum / f->n );
+}
+/*----------------------------------------------------------------------------*/
@@ -0,0 +1,78 @@
+/**
+*   @file:    ultrasound_filter.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Filtar trajanja echo signala jednog ultrazvucnog senzora. Prozor
+*             od poslednjih N = 3, 5 ili 7 merenja se sortira mrezom za
+*             sortiranje (fiksan niz poredjenja bez grananja po podacima).
+*             Izlaz je medijana, ili Hampel: merenja koja od medijane
+*             odstupaju vise od K * 1.4826 * MAD zamenjuju se medijanom, pa
+*             se uzima srednja vrednost prozora. Srednja vrednost bez
+*             odbacivanja (ranije ponasanje) ostaje kao US_FILTER_MEAN.
+*
+*             Pre filtra se svako merenje klasifikuje: prekratak echo (blize
+*             od 2 cm), predug (dalje od 4 m) i timeout (HC-SR04 drzi echo
+*             oko 38 ms kada nema odjeka). Takva merenja ulaze u prozor
+*             ogranicena na opseg senzora, pa pojedinacno ne pomeraju
+*             medijanu, a niz timeout-a znaci slobodan put.
+*             Ne zavisi od hardvera, prevodi se i u Host/us_filter_bench.c.
+*/
+
+#ifndef __ULTRASOUND_FILTER_H__
+#define __ULTRASOUND_FILTER_H__
+
+#include <stdint.h>
+
+#define US_FILTER_MAX_N   7
+
+/* Nacin filtriranja. */
+#define US_FILTER_MEAN    0
+#define US_FILTER_MEDIAN  1
+#define US_FILTER_HAMPEL  2
+
+/* Podrazumevano podesavanje senzora na ploci kretanja. */
+#define US_FILTER_N       5
+#define US_FILTER_MODE    US_FILTER_HAMPEL
+
+/* Granice u us trajanja echo signala (5.8 us po mm). */
+#define US_MIN_US         116      // 20 mm.
+#define US_MAX_US         23200    // 4 m.
+#define US_TIMEOUT_US     30000    // Nema odjeka.
+
+/* Hampel: prag je K * 1.4826 * MAD, a najmanje US_HAMPEL_MIN_US da prozor
+   sa istim merenjima (MAD = 0) ne odbacuje sitne promene. */
+#define US_HAMPEL_K_X1000 4448     // K = 3, puta 1.4826.
+#define US_HAMPEL_MIN_US  174      // 30 mm.
+
+/* Klase merenja. */
+enum
+{
+  US_ECHO_VALID,
+  US_ECHO_NEAR,
+  US_ECHO_FAR,
+  US_ECHO_TIMEOUT,
+  US_ECHO_CLASSES
+};
+
+typedef struct
+{
+  uint8_t n;                              // Duzina prozora, 3, 5 ili 7.
+  uint8_t mode;                           // US_FILTER_*.
+  uint8_t index;                          // Mesto za sledece merenje.
+  uint8_t filled;                         // 0 dok nije stiglo prvo merenje.
+  uint16_t window[ US_FILTER_MAX_N ];
+  uint32_t sum;                           // Zbir prozora, za US_FILTER_MEAN.
+  uint8_t status;                         // Klasa poslednjeg merenja.
+  uint16_t class_count[ US_ECHO_CLASSES ];
+  uint16_t rejected;                      // Merenja koja je Hampel odbacio.
+} UsFilterType;
+
+/* Prazan filtar. Duzina koja nije 3, 5 ili 7 postaje US_FILTER_N. */
+void UsFilterInit( UsFilterType *f, uint8_t n, uint8_t mode );
+/* Klasa trajanja echo signala. */
+uint8_t UsClassify( uint16_t width );
+/* Dodaje merenje i vraca filtrirano trajanje echo signala u us. */
+uint16_t UsFilterAdd( UsFilterType *f, uint16_t width );
+
+#endif
@@ -15,13 +15,13 @@ unsigned char speed_current_Y;
 unsigned char speed_req_Y;
 unsigned char maximum_speed_Y=60;
 unsigned int position_inc_Y;
+unsigned char motion_hold=0;//1 - prepreka u zoni zaustavljanja, pozicioni kontroleri ne napreduju
 int zadata_pozicija_X=32767, zadata_pozicija_Y=32767;
 int trenutna_pozicija_X=32767, trenutna_pozicija_Y=32767; 
 int greska_pracenja_X, greska_pracenja_Y;
 unsigned char command_ID=255;     
 unsigned char ENC1A_edge=0, ENC1B_edge=0; 
 unsigned char ENC2A_edge=0, ENC2B_edge=0;
-int data_log[512];
 int speed_correction_Y=0;
 float angularConstant=0.0375;
 long abs_X=0,abs_Y=0;
@@ -1,8 +1,16 @@
 #define INP_TOLERANCE 30
 
-extern const unsigned char speed_table_acc[];
-extern const unsigned char speed_table_decc[];
-extern const unsigned int acc_table[];
+/* Tabele profila brzine su u flash-u. Host build (MOTION_HOST) ih drzi u
+   RAM-u, da bi ih motion_host -g acc/dec/vmax menjao. */
+#ifdef MOTION_HOST
+#define PROFILE_TABLE
+#else
+#define PROFILE_TABLE const
+#endif
+
+extern PROFILE_TABLE unsigned char speed_table_acc[];
+extern PROFILE_TABLE unsigned char speed_table_decc[];
+extern PROFILE_TABLE unsigned int acc_table[];
 
 extern struct {
 	   unsigned char status;
@@ -22,16 +30,19 @@ extern unsigned char speed_current_Y;
 extern unsigned char speed_req_Y;
 extern unsigned char maximum_speed_Y;
 extern unsigned int position_inc_Y;
+extern unsigned char motion_hold;
 extern int zadata_pozicija_X, zadata_pozicija_Y;
 extern int trenutna_pozicija_X, trenutna_pozicija_Y;
 extern int greska_pracenja_X, greska_pracenja_Y;
 extern unsigned char command_ID;
 extern unsigned char ENC1A_edge, ENC1B_edge; 
 extern unsigned char ENC2A_edge, ENC2B_edge;
-extern int data_log[512];
 extern int speed_correction_Y;
 extern float angularConstant;
 extern long abs_X,abs_Y;
 extern float abs_Theta;
+/* Pojacanja PID1/PID2 (main_template.c) i PID_continous (stm32f10x_it_stu.c). */
+extern float Kp, Ki, Kd;
+extern float Kpc, Kic, Kdc, Kac;
            
 extern int test;
\ No newline at end of file
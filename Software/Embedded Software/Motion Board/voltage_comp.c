@@ -0,0 +1,35 @@
+/**
+*   @file:    voltage_comp.c
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kompenzacija napona baterije, videti voltage_comp.h.
+*/
+
+#include "voltage_comp.h"
+
+volatile unsigned int supply_mv = 0;
+volatile unsigned int vcomp_gain = VCOMP_UNITY;
+
+/*----------------------------------------------------------------------------*/
+void VoltageCompSet( unsigned int mv )
+{
+  supply_mv = mv;
+  if ( mv < VCOMP_MIN_MV || mv > VCOMP_MAX_MV ) return;
+  vcomp_gain = ( ( VCOMP_NOMINAL_MV << VCOMP_SHIFT ) + mv / 2 ) / mv;
+}
+/*----------------------------------------------------------------------------*/
+/**
+  * @brief  Skalira izlaz PID-a. Poziva se iz SysTick-a za oba motora, pre
+  *         odluke o smeru i mrtvoj zoni.
+  * @param  pwm: izlaz PID1/PID2.
+  * @retval Kompenzovan PWM, -VCOMP_PWM_MAX..VCOMP_PWM_MAX.
+  */
+int VoltageCompApply( int pwm )
+{
+  unsigned int magnitude = (unsigned int)( pwm < 0 ? -pwm : pwm );
+
+  magnitude = ( magnitude * vcomp_gain + VCOMP_UNITY / 2 ) >> VCOMP_SHIFT;
+  if ( magnitude > VCOMP_PWM_MAX ) magnitude = VCOMP_PWM_MAX;
+  return pwm < 0 ? -(int)magnitude : (int)magnitude;
+}
@@ -0,0 +1,35 @@
+/**
+*   @file:    voltage_comp.h
+*   @author:  Cuvari plaze(Praetorian)
+*   @version: v1.00.181026 (Praetorian)
+*   @date:    18/10/2026
+*   @brief:   Kompenzacija napona baterije na izlazu PID1/PID2. Brzina
+*             motora je srazmerna naponu na motoru, tj. PWM-u puta napon
+*             baterije, pa se PWM mnozi sa VCOMP_NOMINAL_MV / supply_mv i
+*             petlja vidi isto pojacanje na punoj i na praznoj bateriji.
+*             Napon salje glavna ploca (CMD_SUPPLY_VOLTAGE) svakih 500 ms.
+*             Pojacanje se racuna pri prijemu, u SysTick-u je samo mnozenje.
+*             Ne zavisi od hardvera, prevodi se i u Host/vcomp_sim.c.
+*/
+
+#ifndef __VOLTAGE_COMP_H__
+#define __VOLTAGE_COMP_H__
+
+#define VCOMP_NOMINAL_MV  11100   // Napon na kome su podesene konstante PID-a.
+#define VCOMP_MIN_MV      9000    // Ispod ovoga napon se smatra pogresnim.
+#define VCOMP_MAX_MV      13000
+#define VCOMP_PWM_MAX     990     // Isto ogranicenje kao u PID1/PID2.
+#define VCOMP_SHIFT       12
+#define VCOMP_UNITY       ( 1 << VCOMP_SHIFT )
+
+/* Poslednji napon baterije sa glavne ploce u mV, 0 dok ne stigne. */
+extern volatile unsigned int supply_mv;
+/* VCOMP_NOMINAL_MV / supply_mv u Q12. */
+extern volatile unsigned int vcomp_gain;
+
+/* Novi napon baterije. Napon van opsega ne menja pojacanje. */
+void VoltageCompSet( unsigned int mv );
+/* PWM sa znakom, -990..990, skaliran pojacanjem i ogranicen. */
+int VoltageCompApply( int pwm );
+
+#endif